@@ -1,8 +1,21 @@
 #pragma once
 
 #include "../src/Asset.hpp"
+#include "../src/MappedFile.hpp"
+#include "../src/Archive.hpp"
 #include "../src/Compression.hpp"
+#include "../src/Dictionary.hpp"
 #include "../src/MeshAsset.hpp"
+#include "../src/MeshFilter.hpp"
 #include "../src/TextureAsset.hpp"
+#include "../src/MipChain.hpp"
+#include "../src/BlockCompression.hpp"
 #include "../src/MaterialAsset.hpp"
-#include "../src/PrefabAsset.hpp"
\ No newline at end of file
+#include "../src/PrefabAsset.hpp"
+#include "../src/TaskPool.hpp"
+#include "../src/VertexRemap.hpp"
+#include "../src/VertexCache.hpp"
+#include "../src/Overdraw.hpp"
+#include "../src/Meshlet.hpp"
+#include "../src/Simplify.hpp"
+#include "../src/VertexQuantization.hpp"
\ No newline at end of file
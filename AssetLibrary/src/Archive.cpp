@@ -0,0 +1,193 @@
+#include "Archive.hpp"
+
+#include <xxhash.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+namespace Assets
+{
+
+	struct MountedArchive
+	{
+		MappedFile Mapping = {};
+		const ArchiveEntry* Entries = nullptr;
+		uint32_t EntryCount = 0;
+	};
+
+	static std::vector<MountedArchive> s_Archives = {};
+
+	static const uint32_t ArchiveVersion = 1;
+	static const uint64_t ArchiveAlignment = 16;
+
+	uint64_t HashAssetPath(const char* path)
+	{
+		const std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+		return XXH64(normalized.data(), normalized.size(), 0);
+	}
+
+	bool MountArchive(const char* path)
+	{
+		MountedArchive archive = {};
+
+		if (!MapFile(path, archive.Mapping)) return false;
+
+		const uint8_t* data = (const uint8_t*)archive.Mapping.Data;
+		const ArchiveHeader* header = (const ArchiveHeader*)data;
+
+		bool valid = archive.Mapping.Size >= sizeof(ArchiveHeader);
+		if (valid) valid = memcmp(header->Magic, "VPAK", 4) == 0 && header->Version == ArchiveVersion;
+		if (valid) valid = header->TocOffset <= archive.Mapping.Size && (archive.Mapping.Size - header->TocOffset) / sizeof(ArchiveEntry) >= header->EntryCount;
+
+		if (!valid)
+		{
+			UnmapFile(archive.Mapping);
+			return false;
+		}
+
+		archive.Entries = (const ArchiveEntry*)(data + header->TocOffset);
+		archive.EntryCount = header->EntryCount;
+
+		s_Archives.push_back(archive);
+
+		return true;
+	}
+
+	void UnmountArchives()
+	{
+		for (auto& a : s_Archives)
+			UnmapFile(a.Mapping);
+
+		s_Archives.clear();
+	}
+
+	bool FindArchivedAsset(const char* path, ByteSpan& data)
+	{
+		if (s_Archives.empty()) return false;
+
+		const uint64_t hash = HashAssetPath(path);
+
+		for (auto it = s_Archives.rbegin(); it != s_Archives.rend(); it++)
+		{
+			const ArchiveEntry* begin = it->Entries;
+			const ArchiveEntry* end = it->Entries + it->EntryCount;
+
+			const ArchiveEntry* entry = std::lower_bound(begin, end, hash, [](const ArchiveEntry& e, uint64_t h) { return e.PathHash < h; });
+
+			if (entry == end || entry->PathHash != hash) continue;
+			if (entry->Offset + entry->Size > it->Mapping.Size) return false;
+
+			data.Data = (const uint8_t*)it->Mapping.Data + entry->Offset;
+			data.Size = entry->Size;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	// Writes the archive to temp, returning false on the first failure, which leaves temp incomplete
+	static bool WriteArchive(const std::string& temp, const std::vector<std::string>& files)
+	{
+		std::ofstream f(temp, std::ios::out | std::ios::binary);
+
+		if (!f.is_open()) return false;
+
+		ArchiveHeader header;
+		memset(&header, 0, sizeof(ArchiveHeader));
+		memcpy(header.Magic, "VPAK", 4);
+
+		header.Version = ArchiveVersion;
+		header.EntryCount = files.size();
+
+		f.write((const char*)&header, sizeof(ArchiveHeader));
+
+		std::vector<ArchiveEntry> entries;
+		entries.reserve(files.size());
+
+		uint64_t offset = sizeof(ArchiveHeader);
+		const char padding[ArchiveAlignment] = {};
+
+		// Files with identical bytes are stored once and share the same blob
+		std::unordered_map<uint64_t, ArchiveEntry> blobs;
+
+		for (const auto& file : files)
+		{
+			std::ifstream in(file, std::ios::in | std::ios::binary);
+
+			if (!in.is_open()) return false;
+
+			const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+			const uint64_t contentHash = HashContent(data.data(), data.size());
+
+			auto blob = blobs.find(contentHash);
+
+			if (blob != blobs.end() && blob->second.Size == data.size())
+			{
+				entries.push_back({ HashAssetPath(file.c_str()), blob->second.Offset, blob->second.Size });
+				continue;
+			}
+
+			const uint64_t aligned = (offset + ArchiveAlignment - 1) & ~(ArchiveAlignment - 1);
+			f.write(padding, aligned - offset);
+			f.write(data.data(), data.size());
+
+			entries.push_back({ HashAssetPath(file.c_str()), aligned, data.size() });
+			blobs[contentHash] = entries.back();
+
+			offset = aligned + data.size();
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const ArchiveEntry& a, const ArchiveEntry& b) { return a.PathHash < b.PathHash; });
+
+		header.TocOffset = (offset + ArchiveAlignment - 1) & ~(ArchiveAlignment - 1);
+		f.write(padding, header.TocOffset - offset);
+		f.write((const char*)entries.data(), entries.size() * sizeof(ArchiveEntry));
+
+		f.seekp(0);
+		f.write((const char*)&header, sizeof(ArchiveHeader));
+		f.close();
+
+		return f.good();
+	}
+
+	bool PackArchive(const char* path, const std::vector<std::string>& files)
+	{
+		// Two paths with the same hash could not both be found, so nothing is written at all
+		std::vector<uint64_t> hashes;
+		hashes.reserve(files.size());
+
+		for (const auto& file : files)
+			hashes.push_back(HashAssetPath(file.c_str()));
+
+		std::sort(hashes.begin(), hashes.end());
+
+		if (std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end())
+			return false;
+
+		// A failed pack must not leave a truncated archive where the previous one was mounted from
+		const std::string temp = std::string(path) + ".tmp";
+		std::error_code error;
+
+		if (!WriteArchive(temp, files))
+		{
+			std::filesystem::remove(temp, error);
+			return false;
+		}
+
+		std::filesystem::rename(temp, path, error);
+
+		if (error)
+		{
+			std::filesystem::remove(temp, error);
+			return false;
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Asset.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Assets
+{
+
+	// .vkpak layout: ArchiveHeader, the packed asset files (each 16-byte aligned), then
+	// the table of contents as an array of ArchiveEntry sorted by PathHash
+	struct ArchiveHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Reserved;
+		uint64_t TocOffset;
+	};
+
+	struct ArchiveEntry
+	{
+		uint64_t PathHash;
+		uint64_t Offset;
+		uint64_t Size;
+	};
+
+	uint64_t HashAssetPath(const char* path);
+
+	// Mounted archives are searched (most recent first) by LoadBinary and MapBinary
+	// before falling back to loose files on disk
+	bool MountArchive(const char* path);
+	void UnmountArchives();
+
+	bool FindArchivedAsset(const char* path, ByteSpan& data);
+
+	bool PackArchive(const char* path, const std::vector<std::string>& files);
+
+}
\ No newline at end of file
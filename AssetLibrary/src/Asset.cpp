@@ -1,13 +1,55 @@
 #include "Asset.hpp"
 
+#include "Archive.hpp"
+
+#include <xxhash.h>
+
+#include <cstring>
 #include <fstream>
 
 namespace Assets
 {
 
+	static bool PopulateView(const uint8_t* data, size_t size, AssetView& view)
+	{
+		if (size < sizeof(AssetHeader)) return false;
+
+		const AssetHeader* header = (const AssetHeader*)data;
+		const size_t payloadSize = (size_t)header->JsonLength + (size_t)header->BinaryLength;
+
+		if (payloadSize > size - sizeof(AssetHeader)) return false;
+
+		const uint8_t* json = data + sizeof(AssetHeader);
+
+		view.Header = header;
+		view.Json = std::string_view((const char*)json, header->JsonLength);
+		view.Binary.Data = json + header->JsonLength;
+		view.Binary.Size = header->BinaryLength;
+
+		return true;
+	}
+
+	uint64_t HashContent(const void* data, size_t size, uint64_t seed)
+	{
+		return XXH64(data, size, seed);
+	}
+
 	bool LoadBinary(const char* path, Asset& file)
 	{
-		std::ifstream f(path, std::ios::in | std::ios::binary | std::ios::beg);
+		ByteSpan archived = {};
+		AssetView view = {};
+
+		if (FindArchivedAsset(path, archived) && PopulateView(archived.Data, archived.Size, view))
+		{
+			memcpy(file.Type, view.Header->Type, 4);
+			file.Version = view.Header->Version;
+			file.Json.assign(view.Json);
+			file.Binary.assign(view.Binary.Data, view.Binary.Data + view.Binary.Size);
+
+			return true;
+		}
+
+		std::ifstream f(path, std::ios::in | std::ios::binary);
 
 		if (!f.is_open()) return false;
 
@@ -58,4 +100,28 @@ namespace Assets
 		return true;
 	}
 
+	bool MapBinary(const char* path, AssetView& view)
+	{
+		ByteSpan archived = {};
+
+		if (FindArchivedAsset(path, archived))
+			return PopulateView(archived.Data, archived.Size, view);
+
+		if (!MapFile(path, view.Mapping)) return false;
+
+		if (!PopulateView((const uint8_t*)view.Mapping.Data, view.Mapping.Size, view))
+		{
+			UnmapBinary(view);
+			return false;
+		}
+
+		return true;
+	}
+
+	void UnmapBinary(AssetView& view)
+	{
+		UnmapFile(view.Mapping);
+		view = {};
+	}
+
 }
\ No newline at end of file
@@ -1,21 +1,67 @@
 #pragma once
 
+#include "MappedFile.hpp"
+
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
 
 namespace Assets
 {
 
+	// Asset::Version selects how the metadata block of a file is encoded: version 1
+	// stores JSON text, version 2 a fixed-layout binary header (see Metadata.hpp)
+	enum AssetVersion : uint32_t
+	{
+		AssetVersionJson = 1,
+		AssetVersionBinary = 2,
+		AssetVersionLatest = AssetVersionBinary,
+	};
+
 	struct Asset
 	{
 		char Type[4] = {};
-		uint32_t Version = 1;
+		uint32_t Version = AssetVersionJson;
 		std::string Json = "";
 		std::vector<uint8_t> Binary = {};
 	};
 
+	// On-disk layout of the fixed part of every asset file
+	struct AssetHeader
+	{
+		char Type[4];
+		uint32_t Version;
+		uint32_t JsonLength;
+		uint32_t BinaryLength;
+	};
+
+	struct ByteSpan
+	{
+		const uint8_t* Data = nullptr;
+		size_t Size = 0;
+	};
+
+	// Read-only view over a memory-mapped asset file, or over an entry of a mounted
+	// archive. Header, Json and Binary point straight into the mapping and are only
+	// valid until UnmapBinary() is called.
+	struct AssetView
+	{
+		const AssetHeader* Header = nullptr;
+		std::string_view Json = {};
+		ByteSpan Binary = {};
+
+		MappedFile Mapping = {};
+	};
+
+	// XXH64 of an arbitrary byte range. Chain the previous result as seed to hash
+	// several ranges as one.
+	uint64_t HashContent(const void* data, size_t size, uint64_t seed = 0);
+
 	bool LoadBinary(const char* path, Asset& file);
 	bool SaveBinary(const char* path, const Asset& file);
 
+	bool MapBinary(const char* path, AssetView& view);
+	void UnmapBinary(AssetView& view);
+
 }
\ No newline at end of file
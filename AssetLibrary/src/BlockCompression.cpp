@@ -0,0 +1,806 @@
+#include "BlockCompression.hpp"
+#include "TaskPool.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ASSETS_BLOCKS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ASSETS_BLOCKS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Assets
+{
+
+	// One 4x4 block as a plane of 16 values from 0 to 255 per channel
+	struct BlockTexels
+	{
+		alignas(16) float Channels[4][16];
+	};
+
+	// Refinement passes after the principal axis fit; later ones rarely improve anything
+	static constexpr uint32_t RefineIterations = 2;
+
+	// BC7 interpolation weights for 4 bit indices, out of 64
+	static const uint32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Assigns every texel the closest of paletteSize colors over planeCount channels and returns
+	// the summed squared error. Four texels are compared against each entry at a time.
+	static float FitPalette(const float* const* planes, uint32_t planeCount, const float (*palette)[4], uint32_t paletteSize, uint8_t* indices)
+	{
+#if defined(ASSETS_BLOCKS_SSE2)
+
+		__m128 total = _mm_setzero_ps();
+
+		for (uint32_t t = 0; t < 16; t += 4)
+		{
+			__m128 best = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndex = _mm_setzero_si128();
+
+			for (uint32_t p = 0; p < paletteSize; p++)
+			{
+				__m128 error = _mm_setzero_ps();
+
+				for (uint32_t c = 0; c < planeCount; c++)
+				{
+					const __m128 d = _mm_sub_ps(_mm_load_ps(planes[c] + t), _mm_set1_ps(palette[p][c]));
+					error = _mm_add_ps(error, _mm_mul_ps(d, d));
+				}
+
+				const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, best));
+
+				best = _mm_min_ps(error, best);
+				bestIndex = _mm_or_si128(_mm_andnot_si128(closer, bestIndex), _mm_and_si128(closer, _mm_set1_epi32((int)p)));
+			}
+
+			alignas(16) int32_t lanes[4];
+			_mm_store_si128((__m128i*)lanes, bestIndex);
+
+			for (uint32_t i = 0; i < 4; i++)
+				indices[t + i] = (uint8_t)lanes[i];
+
+			total = _mm_add_ps(total, best);
+		}
+
+		alignas(16) float sums[4];
+		_mm_store_ps(sums, total);
+
+		return sums[0] + sums[1] + sums[2] + sums[3];
+
+#elif defined(ASSETS_BLOCKS_NEON)
+
+		float32x4_t total = vdupq_n_f32(0.0f);
+
+		for (uint32_t t = 0; t < 16; t += 4)
+		{
+			float32x4_t best = vdupq_n_f32(FLT_MAX);
+			uint32x4_t bestIndex = vdupq_n_u32(0);
+
+			for (uint32_t p = 0; p < paletteSize; p++)
+			{
+				float32x4_t error = vdupq_n_f32(0.0f);
+
+				for (uint32_t c = 0; c < planeCount; c++)
+				{
+					const float32x4_t d = vsubq_f32(vld1q_f32(planes[c] + t), vdupq_n_f32(palette[p][c]));
+					error = vmlaq_f32(error, d, d);
+				}
+
+				const uint32x4_t closer = vcltq_f32(error, best);
+
+				best = vminq_f32(error, best);
+				bestIndex = vbslq_u32(closer, vdupq_n_u32(p), bestIndex);
+			}
+
+			uint32_t lanes[4];
+			vst1q_u32(lanes, bestIndex);
+
+			for (uint32_t i = 0; i < 4; i++)
+				indices[t + i] = (uint8_t)lanes[i];
+
+			total = vaddq_f32(total, best);
+		}
+
+		return vgetq_lane_f32(total, 0) + vgetq_lane_f32(total, 1) + vgetq_lane_f32(total, 2) + vgetq_lane_f32(total, 3);
+
+#else
+
+		float total = 0.0f;
+
+		for (uint32_t t = 0; t < 16; t++)
+		{
+			float best = FLT_MAX;
+
+			for (uint32_t p = 0; p < paletteSize; p++)
+			{
+				float error = 0.0f;
+
+				for (uint32_t c = 0; c < planeCount; c++)
+				{
+					const float d = planes[c][t] - palette[p][c];
+					error += d * d;
+				}
+
+				if (error < best)
+				{
+					best = error;
+					indices[t] = (uint8_t)p;
+				}
+			}
+
+			total += best;
+		}
+
+		return total;
+
+#endif
+	}
+
+	// Ends of the block's extent along its principal axis, found by power iteration on the covariance
+	static void FindEndpoints(const float* const* planes, uint32_t planeCount, float* low, float* high)
+	{
+		float mean[4] = {}, covariance[4][4] = {}, axis[4] = {};
+
+		for (uint32_t c = 0; c < planeCount; c++)
+		{
+			for (uint32_t t = 0; t < 16; t++)
+				mean[c] += planes[c][t];
+
+			mean[c] /= 16.0f;
+		}
+
+		for (uint32_t t = 0; t < 16; t++)
+		{
+			for (uint32_t a = 0; a < planeCount; a++)
+			{
+				for (uint32_t b = 0; b < planeCount; b++)
+					covariance[a][b] += (planes[a][t] - mean[a]) * (planes[b][t] - mean[b]);
+			}
+		}
+
+		// A flat block has no axis, both ends are its color
+		float variance = 0.0f;
+		uint32_t widest = 0;
+
+		for (uint32_t c = 0; c < planeCount; c++)
+		{
+			variance += covariance[c][c];
+			if (covariance[c][c] > covariance[widest][widest]) widest = c;
+		}
+
+		if (variance < FLT_EPSILON)
+		{
+			memcpy(low, mean, sizeof(float) * planeCount);
+			memcpy(high, mean, sizeof(float) * planeCount);
+			return;
+		}
+
+		// The row of the widest channel always has a part along the principal axis, unlike a seed
+		// of per-channel extents, which has no sign and misses axes where channels move apart
+		float length = 0.0f;
+
+		for (uint32_t c = 0; c < planeCount; c++)
+			length += covariance[widest][c] * covariance[widest][c];
+
+		length = 1.0f / std::sqrt(length);
+
+		for (uint32_t c = 0; c < planeCount; c++)
+			axis[c] = covariance[widest][c] * length;
+
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			float next[4] = {};
+
+			for (uint32_t a = 0; a < planeCount; a++)
+			{
+				for (uint32_t b = 0; b < planeCount; b++)
+					next[a] += covariance[a][b] * axis[b];
+			}
+
+			length = 0.0f;
+
+			for (uint32_t c = 0; c < planeCount; c++)
+				length += next[c] * next[c];
+
+			if (length < FLT_EPSILON) break;
+
+			length = 1.0f / std::sqrt(length);
+
+			for (uint32_t c = 0; c < planeCount; c++)
+				axis[c] = next[c] * length;
+		}
+
+		float minimum = FLT_MAX, maximum = -FLT_MAX;
+
+		for (uint32_t t = 0; t < 16; t++)
+		{
+			float projection = 0.0f;
+
+			for (uint32_t c = 0; c < planeCount; c++)
+				projection += (planes[c][t] - mean[c]) * axis[c];
+
+			minimum = std::min(minimum, projection);
+			maximum = std::max(maximum, projection);
+		}
+
+		for (uint32_t c = 0; c < planeCount; c++)
+		{
+			low[c] = std::clamp(mean[c] + minimum * axis[c], 0.0f, 255.0f);
+			high[c] = std::clamp(mean[c] + maximum * axis[c], 0.0f, 255.0f);
+		}
+	}
+
+	// Endpoints with the least squared error for a fixed weight of high in every texel
+	static bool SolveEndpoints(const float* const* planes, uint32_t planeCount, const float* weights, float* low, float* high)
+	{
+		float ll = 0.0f, hh = 0.0f, lh = 0.0f, lx[4] = {}, hx[4] = {};
+
+		for (uint32_t t = 0; t < 16; t++)
+		{
+			const float h = weights[t], l = 1.0f - h;
+
+			ll += l * l;
+			hh += h * h;
+			lh += l * h;
+
+			for (uint32_t c = 0; c < planeCount; c++)
+			{
+				lx[c] += l * planes[c][t];
+				hx[c] += h * planes[c][t];
+			}
+		}
+
+		const float det = ll * hh - lh * lh;
+
+		if (std::fabs(det) < FLT_EPSILON) return false;
+
+		for (uint32_t c = 0; c < planeCount; c++)
+		{
+			low[c] = std::clamp((lx[c] * hh - hx[c] * lh) / det, 0.0f, 255.0f);
+			high[c] = std::clamp((hx[c] * ll - lx[c] * lh) / det, 0.0f, 255.0f);
+		}
+
+		return true;
+	}
+
+	static void LoadBlock(BlockTexels& block, const uint8_t* src, uint32_t width, uint32_t height, uint32_t bx, uint32_t by)
+	{
+		for (uint32_t y = 0; y < 4; y++)
+		{
+			const uint32_t sy = std::min(by * 4 + y, height - 1);
+
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				const uint32_t sx = std::min(bx * 4 + x, width - 1);
+				const uint8_t* texel = src + ((size_t)sy * width + sx) * 4;
+
+				for (uint32_t c = 0; c < 4; c++)
+					block.Channels[c][y * 4 + x] = texel[c];
+			}
+		}
+	}
+
+	static void StoreBlock(uint8_t* dst, const uint8_t* texels, uint32_t width, uint32_t height, uint32_t bx, uint32_t by)
+	{
+		for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++)
+		{
+			const uint32_t count = std::min(4u, width - bx * 4);
+			memcpy(dst + ((size_t)(by * 4 + y) * width + bx * 4) * 4, texels + y * 16, count * 4);
+		}
+	}
+
+	static uint16_t PackColor565(const float* color)
+	{
+		const uint32_t r = (uint32_t)(color[0] * 31.0f / 255.0f + 0.5f);
+		const uint32_t g = (uint32_t)(color[1] * 63.0f / 255.0f + 0.5f);
+		const uint32_t b = (uint32_t)(color[2] * 31.0f / 255.0f + 0.5f);
+
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	static void UnpackColor565(uint16_t value, float* color)
+	{
+		const uint32_t r = value >> 11, g = (value >> 5) & 63, b = value & 31;
+
+		color[0] = (float)((r << 3) | (r >> 2));
+		color[1] = (float)((g << 2) | (g >> 4));
+		color[2] = (float)((b << 3) | (b >> 2));
+		color[3] = 255.0f;
+	}
+
+	// The two interpolated BC1 colors sit at a third and two thirds between the endpoints
+	static void GetColorPalette(uint16_t c0, uint16_t c1, float (*palette)[4])
+	{
+		UnpackColor565(c0, palette[0]);
+		UnpackColor565(c1, palette[1]);
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+			palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+		}
+	}
+
+	// Writes the 8 byte BC1 color block, always in four color mode so it also serves BC3
+	static void EncodeColorBlock(uint8_t* dst, const BlockTexels& block)
+	{
+		static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+		const float* planes[3] = { block.Channels[0], block.Channels[1], block.Channels[2] };
+
+		float low[4], high[4];
+		FindEndpoints(planes, 3, low, high);
+
+		uint16_t best[2] = {};
+		uint8_t bestIndices[16] = {};
+		float bestError = FLT_MAX;
+
+		for (uint32_t i = 0; i <= RefineIterations; i++)
+		{
+			uint16_t c0 = PackColor565(high), c1 = PackColor565(low);
+			uint8_t indices[16];
+			float palette[4][4];
+
+			if (c0 < c1) std::swap(c0, c1);
+
+			GetColorPalette(c0, c1, palette);
+
+			// Equal endpoints would select three color mode, where the first entry is all there is
+			const float error = FitPalette(planes, 3, palette, c0 == c1 ? 1 : 4, indices);
+
+			if (error >= bestError) break;
+
+			bestError = error;
+			best[0] = c0;
+			best[1] = c1;
+			memcpy(bestIndices, indices, sizeof(indices));
+
+			if (c0 == c1 || error == 0.0f) break;
+
+			float texelWeights[16];
+
+			for (uint32_t t = 0; t < 16; t++)
+				texelWeights[t] = weights[indices[t]];
+
+			if (!SolveEndpoints(planes, 3, texelWeights, low, high)) break;
+		}
+
+		uint32_t bits = 0;
+
+		for (uint32_t t = 0; t < 16; t++)
+			bits |= (uint32_t)bestIndices[t] << (t * 2);
+
+		memcpy(dst, &best[0], 2);
+		memcpy(dst + 2, &best[1], 2);
+		memcpy(dst + 4, &bits, 4);
+	}
+
+	// Eight value mode: both ends, then six steps from the first towards the second
+	static void GetAlphaPalette(uint8_t a0, uint8_t a1, float (*palette)[4])
+	{
+		palette[0][0] = a0;
+		palette[1][0] = a1;
+
+		for (uint32_t i = 2; i < 8; i++)
+			palette[i][0] = ((8 - i) * a0 + (i - 1) * a1) / 7.0f;
+	}
+
+	// Writes an 8 byte BC4 block of one channel, as used for BC3 alpha and both BC5 channels
+	static void EncodeAlphaBlock(uint8_t* dst, const float* plane)
+	{
+		const float* planes[1] = { plane };
+
+		float low = *std::min_element(plane, plane + 16);
+		float high = *std::max_element(plane, plane + 16);
+
+		uint8_t best[2] = {};
+		uint8_t bestIndices[16] = {};
+		float bestError = FLT_MAX;
+
+		for (uint32_t i = 0; i <= RefineIterations; i++)
+		{
+			uint8_t a0 = (uint8_t)(high + 0.5f), a1 = (uint8_t)(low + 0.5f);
+			uint8_t indices[16];
+			float palette[8][4];
+
+			if (a0 < a1) std::swap(a0, a1);
+
+			GetAlphaPalette(a0, a1, palette);
+
+			// Equal ends would select six value mode, which still starts with the first end
+			const float error = FitPalette(planes, 1, palette, a0 == a1 ? 1 : 8, indices);
+
+			if (error >= bestError) break;
+
+			bestError = error;
+			best[0] = a0;
+			best[1] = a1;
+			memcpy(bestIndices, indices, sizeof(indices));
+
+			if (a0 == a1 || error == 0.0f) break;
+
+			float texelWeights[16];
+
+			for (uint32_t t = 0; t < 16; t++)
+				texelWeights[t] = indices[t] < 2 ? 1.0f - indices[t] : (8 - indices[t]) / 7.0f;
+
+			if (!SolveEndpoints(planes, 1, texelWeights, &low, &high)) break;
+		}
+
+		uint64_t bits = 0;
+
+		for (uint32_t t = 0; t < 16; t++)
+			bits |= (uint64_t)bestIndices[t] << (t * 3);
+
+		dst[0] = best[0];
+		dst[1] = best[1];
+		memcpy(dst + 2, &bits, 6);
+	}
+
+	// Little endian bit stream over a 16 byte block, as BC7 lays out its fields
+	struct BlockBits
+	{
+		uint64_t Words[2] = {};
+		uint32_t Offset = 0;
+
+		void Write(uint64_t value, uint32_t count)
+		{
+			const uint32_t word = Offset / 64, shift = Offset % 64;
+
+			Words[word] |= value << shift;
+
+			if (shift + count > 64)
+				Words[word + 1] |= value >> (64 - shift);
+
+			Offset += count;
+		}
+
+		uint32_t Read(uint32_t count)
+		{
+			const uint32_t word = Offset / 64, shift = Offset % 64;
+			uint64_t value = Words[word] >> shift;
+
+			if (shift + count > 64)
+				value |= Words[word + 1] << (64 - shift);
+
+			Offset += count;
+
+			return (uint32_t)(value & ((1ull << count) - 1));
+		}
+	};
+
+	// Rounds an endpoint to 7 bits per channel plus whichever shared low bit lands closer. Opaque
+	// endpoints always set it, otherwise alpha could come out as 254.
+	static void QuantizeEndpointBC7(const float* color, uint8_t* quantized, uint8_t& pbit)
+	{
+		float bestError = FLT_MAX;
+
+		for (uint32_t p = color[3] >= 254.5f ? 1 : 0; p < 2; p++)
+		{
+			uint8_t q[4];
+			float error = 0.0f;
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				q[c] = (uint8_t)std::clamp((int)std::lround((color[c] - p) / 2.0f), 0, 127);
+
+				const float d = (float)(q[c] * 2 + p) - color[c];
+				error += d * d;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				pbit = (uint8_t)p;
+				memcpy(quantized, q, sizeof(q));
+			}
+		}
+	}
+
+	static void GetPaletteBC7(const uint8_t* e0, const uint8_t* e1, uint8_t p0, uint8_t p1, float (*palette)[4])
+	{
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				const uint32_t a = e0[c] * 2 + p0, b = e1[c] * 2 + p1;
+				palette[i][c] = (float)(((64 - BC7Weights[i]) * a + BC7Weights[i] * b + 32) >> 6);
+			}
+		}
+	}
+
+	static void EncodeBlockBC7(uint8_t* dst, const BlockTexels& block)
+	{
+		const float* planes[4] = { block.Channels[0], block.Channels[1], block.Channels[2], block.Channels[3] };
+
+		float low[4], high[4];
+		FindEndpoints(planes, 4, low, high);
+
+		uint8_t best[2][4] = {}, bestP[2] = {};
+		uint8_t bestIndices[16] = {};
+		float bestError = FLT_MAX;
+
+		for (uint32_t i = 0; i <= RefineIterations; i++)
+		{
+			uint8_t e[2][4], p[2], indices[16];
+			float palette[16][4];
+
+			QuantizeEndpointBC7(high, e[0], p[0]);
+			QuantizeEndpointBC7(low, e[1], p[1]);
+			GetPaletteBC7(e[0], e[1], p[0], p[1], palette);
+
+			const float error = FitPalette(planes, 4, palette, 16, indices);
+
+			if (error >= bestError) break;
+
+			bestError = error;
+			memcpy(best, e, sizeof(e));
+			memcpy(bestP, p, sizeof(p));
+			memcpy(bestIndices, indices, sizeof(indices));
+
+			if (error == 0.0f) break;
+
+			float texelWeights[16];
+
+			for (uint32_t t = 0; t < 16; t++)
+				texelWeights[t] = 1.0f - BC7Weights[indices[t]] / 64.0f;
+
+			if (!SolveEndpoints(planes, 4, texelWeights, low, high)) break;
+		}
+
+		// The first index is stored without its top bit, so it has to be in the lower half
+		if (bestIndices[0] >= 8)
+		{
+			std::swap(best[0], best[1]);
+			std::swap(bestP[0], bestP[1]);
+
+			for (uint32_t t = 0; t < 16; t++)
+				bestIndices[t] = 15 - bestIndices[t];
+		}
+
+		BlockBits bits;
+		bits.Write(1 << 6, 7);
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			bits.Write(best[0][c], 7);
+			bits.Write(best[1][c], 7);
+		}
+
+		bits.Write(bestP[0], 1);
+		bits.Write(bestP[1], 1);
+
+		for (uint32_t t = 0; t < 16; t++)
+			bits.Write(bestIndices[t], t == 0 ? 3 : 4);
+
+		memcpy(dst, bits.Words, 16);
+	}
+
+	static void DecodeColorBlock(uint8_t* texels, const uint8_t* src, bool fourColors)
+	{
+		uint16_t c0, c1;
+		uint32_t bits;
+		float palette[4][4];
+
+		memcpy(&c0, src, 2);
+		memcpy(&c1, src + 2, 2);
+		memcpy(&bits, src + 4, 4);
+
+		GetColorPalette(c0, c1, palette);
+
+		if (!fourColors && c0 <= c1)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2.0f;
+				palette[3][c] = 0.0f;
+			}
+		}
+
+		for (uint32_t t = 0; t < 16; t++)
+		{
+			const uint32_t index = (bits >> (t * 2)) & 3;
+
+			for (uint32_t c = 0; c < 4; c++)
+				texels[t * 4 + c] = (uint8_t)(palette[index][c] + 0.5f);
+		}
+	}
+
+	static void DecodeAlphaBlock(uint8_t* texels, const uint8_t* src, uint32_t channel)
+	{
+		uint64_t bits = 0;
+		float palette[8][4];
+
+		memcpy(&bits, src + 2, 6);
+
+		GetAlphaPalette(src[0], src[1], palette);
+
+		if (src[0] <= src[1])
+		{
+			for (uint32_t i = 2; i < 6; i++)
+				palette[i][0] = ((6 - i) * src[0] + (i - 1) * src[1]) / 5.0f;
+
+			palette[6][0] = 0.0f;
+			palette[7][0] = 255.0f;
+		}
+
+		for (uint32_t t = 0; t < 16; t++)
+			texels[t * 4 + channel] = (uint8_t)(palette[(bits >> (t * 3)) & 7][0] + 0.5f);
+	}
+
+	static bool DecodeBlockBC7(uint8_t* texels, const uint8_t* src)
+	{
+		BlockBits bits;
+		memcpy(bits.Words, src, 16);
+
+		if (bits.Read(7) != 1 << 6) return false;
+
+		uint8_t e[2][4], p[2];
+		float palette[16][4];
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			e[0][c] = (uint8_t)bits.Read(7);
+			e[1][c] = (uint8_t)bits.Read(7);
+		}
+
+		p[0] = (uint8_t)bits.Read(1);
+		p[1] = (uint8_t)bits.Read(1);
+
+		GetPaletteBC7(e[0], e[1], p[0], p[1], palette);
+
+		for (uint32_t t = 0; t < 16; t++)
+		{
+			const uint32_t index = bits.Read(t == 0 ? 3 : 4);
+
+			for (uint32_t c = 0; c < 4; c++)
+				texels[t * 4 + c] = (uint8_t)palette[index][c];
+		}
+
+		return true;
+	}
+
+	uint32_t GetBlockBytes(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::BC1:
+				return 8;
+
+			case TextureFormat::BC3:
+			case TextureFormat::BC5:
+			case TextureFormat::BC7:
+				return 16;
+
+			default:
+				return 0;
+		}
+	}
+
+	uint32_t GetTexelBytes(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::R8:
+				return 1;
+
+			case TextureFormat::RG8:
+			case TextureFormat::R16:
+				return 2;
+
+			case TextureFormat::RGBA8:
+				return 4;
+
+			case TextureFormat::RGBA16F:
+				return 8;
+
+			default:
+				return 0;
+		}
+	}
+
+	size_t GetTextureLevelSize(TextureFormat format, uint32_t width, uint32_t height)
+	{
+		const uint32_t blockBytes = GetBlockBytes(format);
+
+		if (blockBytes != 0)
+			return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+
+		return (size_t)width * height * GetTexelBytes(format);
+	}
+
+	void CompressBlocks(TextureFormat format, uint8_t* dst, const uint8_t* src, uint32_t width, uint32_t height)
+	{
+		const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+		const uint32_t blockBytes = GetBlockBytes(format);
+
+		TaskPool::Get().ParallelFor(blocksY, [&](uint32_t by)
+		{
+			BlockTexels block;
+
+			for (uint32_t bx = 0; bx < blocksX; bx++)
+			{
+				uint8_t* out = dst + ((size_t)by * blocksX + bx) * blockBytes;
+
+				LoadBlock(block, src, width, height, bx, by);
+
+				switch (format)
+				{
+					case TextureFormat::BC1:
+						EncodeColorBlock(out, block);
+						break;
+
+					case TextureFormat::BC3:
+						EncodeAlphaBlock(out, block.Channels[3]);
+						EncodeColorBlock(out + 8, block);
+						break;
+
+					case TextureFormat::BC5:
+						EncodeAlphaBlock(out, block.Channels[0]);
+						EncodeAlphaBlock(out + 8, block.Channels[1]);
+						break;
+
+					case TextureFormat::BC7:
+						EncodeBlockBC7(out, block);
+						break;
+
+					default:
+						break;
+				}
+			}
+		});
+	}
+
+	bool DecompressBlocks(TextureFormat format, uint8_t* dst, const uint8_t* src, uint32_t width, uint32_t height)
+	{
+		const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+		const uint32_t blockBytes = GetBlockBytes(format);
+
+		for (uint32_t by = 0; by < blocksY; by++)
+		{
+			for (uint32_t bx = 0; bx < blocksX; bx++)
+			{
+				const uint8_t* in = src + ((size_t)by * blocksX + bx) * blockBytes;
+				uint8_t texels[64];
+
+				switch (format)
+				{
+					case TextureFormat::BC1:
+						DecodeColorBlock(texels, in, false);
+						break;
+
+					case TextureFormat::BC3:
+						DecodeColorBlock(texels, in + 8, true);
+						DecodeAlphaBlock(texels, in, 3);
+						break;
+
+					case TextureFormat::BC5:
+						memset(texels, 0, sizeof(texels));
+						DecodeAlphaBlock(texels, in, 0);
+						DecodeAlphaBlock(texels, in + 8, 1);
+
+						for (uint32_t t = 0; t < 16; t++)
+							texels[t * 4 + 3] = 255;
+
+						break;
+
+					case TextureFormat::BC7:
+						if (!DecodeBlockBC7(texels, in)) return false;
+						break;
+
+					default:
+						return false;
+				}
+
+				StoreBlock(dst, texels, width, height, bx, by);
+			}
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
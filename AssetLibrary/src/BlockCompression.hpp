@@ -0,0 +1,30 @@
+#pragma once
+
+#include "TextureAsset.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Assets
+{
+
+	// Bytes per 4x4 block, or zero for formats stored per texel
+	uint32_t GetBlockBytes(TextureFormat format);
+
+	// Bytes per texel, or zero for block formats
+	uint32_t GetTexelBytes(TextureFormat format);
+
+	// Bytes a width x height level takes in format, block formats rounded up to whole blocks
+	size_t GetTextureLevelSize(TextureFormat format, uint32_t width, uint32_t height);
+
+	// Compresses a width x height RGBA8 level into blocks of format, one row of blocks per TaskPool
+	// task; blocks over the edge repeat the last row and column. BC1 stores opaque color, BC3 adds
+	// an interpolated alpha block, BC5 keeps red and green as two such blocks and BC7 encodes every
+	// block in mode 6 (one RGBA endpoint pair with 16 steps between them).
+	void CompressBlocks(TextureFormat format, uint8_t* dst, const uint8_t* src, uint32_t width, uint32_t height);
+
+	// Expands blocks written by CompressBlocks back to RGBA8, BC5 with blue zero and alpha opaque.
+	// Returns false when a BC7 block uses any mode but 6.
+	bool DecompressBlocks(TextureFormat format, uint8_t* dst, const uint8_t* src, uint32_t width, uint32_t height);
+
+}
\ No newline at end of file
@@ -1,16 +1,282 @@
 #include "Compression.hpp"
+#include "Dictionary.hpp"
+#include "TaskPool.hpp"
 
+#include <lz4.h>
+#include <lz4hc.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 
 namespace Assets
 {
 
+	static void CompressBlock(CompressionMode mode, int level, const ByteSpan& dict, const uint8_t* src, size_t srcSize, std::vector<uint8_t>& dst)
+	{
+		if (mode == CompressionMode::None)
+		{
+			dst.assign(src, src + srcSize);
+			return;
+		}
+
+		const int stagingSize = LZ4_compressBound((int)srcSize);
+		dst.resize(stagingSize);
+
+		int compressedSize = 0;
+
+		if (mode == CompressionMode::LZ4HC)
+		{
+			LZ4_streamHC_t* stream = LZ4_createStreamHC();
+			LZ4_resetStreamHC_fast(stream, level > 0 ? level : LZ4HC_CLEVEL_DEFAULT);
+
+			if (dict.Size > 0)
+				LZ4_loadDictHC(stream, (const char*)dict.Data, (int)dict.Size);
+
+			compressedSize = LZ4_compress_HC_continue(stream, (const char*)src, (char*)dst.data(), (int)srcSize, stagingSize);
+			LZ4_freeStreamHC(stream);
+		}
+
+		else if (dict.Size > 0)
+		{
+			LZ4_stream_t* stream = LZ4_createStream();
+			LZ4_loadDict(stream, (const char*)dict.Data, (int)dict.Size);
+
+			compressedSize = LZ4_compress_fast_continue(stream, (const char*)src, (char*)dst.data(), (int)srcSize, stagingSize, 1);
+			LZ4_freeStream(stream);
+		}
+
+		else
+			compressedSize = LZ4_compress_default((const char*)src, (char*)dst.data(), (int)srcSize, stagingSize);
+
+		dst.resize(compressedSize);
+	}
+
+	static bool DecompressBlock(CompressionMode mode, const ByteSpan& dict, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+	{
+		if (mode == CompressionMode::None)
+		{
+			if (srcSize != dstSize) return false;
+
+			memcpy(dst, src, dstSize);
+			return true;
+		}
+
+		if (dict.Size > 0)
+			return LZ4_decompress_safe_usingDict((const char*)src, (char*)dst, (int)srcSize, (int)dstSize, (const char*)dict.Data, (int)dict.Size) == (int)dstSize;
+
+		return LZ4_decompress_safe((const char*)src, (char*)dst, (int)srcSize, (int)dstSize) == (int)dstSize;
+	}
+
 	CompressionMode ParseCompressionMode(const char* mode)
 	{
 		if (strcmp(mode, "LZ4") == 0)
 			return CompressionMode::LZ4;
 
+		if (strcmp(mode, "LZ4HC") == 0)
+			return CompressionMode::LZ4HC;
+
 		return CompressionMode::None;
 	}
 
+	const char* GetCompressionModeName(CompressionMode mode)
+	{
+		switch (mode)
+		{
+			case CompressionMode::LZ4:
+				return "LZ4";
+
+			case CompressionMode::LZ4HC:
+				return "LZ4HC";
+
+			default:
+				return "None";
+		}
+	}
+
+	void CompressPayload(CompressionMode mode, int level, uint32_t dictionaryId, uint32_t blockSize, const uint8_t* src, size_t srcSize, std::vector<uint8_t>& dst)
+	{
+		ByteSpan dict = {};
+
+		if (dictionaryId != 0 && mode != CompressionMode::None)
+			FindDictionary(dictionaryId, dict);
+
+		if (blockSize == 0)
+		{
+			CompressBlock(mode, level, dict, src, srcSize, dst);
+			return;
+		}
+
+		const uint32_t blockCount = (uint32_t)((srcSize + blockSize - 1) / blockSize);
+		std::vector<std::vector<uint8_t>> blocks(blockCount);
+
+		TaskPool::Get().ParallelFor(blockCount, [&](uint32_t i)
+		{
+			const size_t offset = (size_t)i * blockSize;
+			const size_t size = std::min<size_t>(blockSize, srcSize - offset);
+
+			CompressBlock(mode, level, dict, src + offset, size, blocks[i]);
+		});
+
+		const size_t tableSize = (blockCount + 2) * sizeof(uint32_t);
+		size_t totalSize = tableSize;
+
+		for (const auto& b : blocks)
+			totalSize += b.size();
+
+		dst.resize(totalSize);
+
+		uint32_t* table = (uint32_t*)dst.data();
+		uint8_t* data = dst.data() + tableSize;
+		uint32_t offset = 0;
+
+		table[0] = blockCount;
+
+		for (uint32_t i = 0; i < blockCount; i++)
+		{
+			table[i + 1] = offset;
+			memcpy(data + offset, blocks[i].data(), blocks[i].size());
+
+			offset += (uint32_t)blocks[i].size();
+		}
+
+		table[blockCount + 1] = offset;
+	}
+
+	// Reads the block table of a split payload: offsets gets count + 1 entries relative to data
+	static bool ReadBlockTable(const uint8_t* src, size_t srcSize, std::vector<uint32_t>& offsets, const uint8_t*& data)
+	{
+		uint32_t blockCount = 0;
+
+		if (srcSize < sizeof(uint32_t)) return false;
+		memcpy(&blockCount, src, sizeof(uint32_t));
+
+		const size_t tableSize = ((size_t)blockCount + 2) * sizeof(uint32_t);
+
+		if (srcSize < tableSize) return false;
+
+		offsets.resize(blockCount + 1);
+		memcpy(offsets.data(), src + sizeof(uint32_t), offsets.size() * sizeof(uint32_t));
+
+		if (offsets[blockCount] > srcSize - tableSize) return false;
+
+		data = src + tableSize;
+
+		return true;
+	}
+
+	bool DecompressPayload(CompressionMode mode, uint32_t dictionaryId, uint32_t blockSize, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+	{
+		ByteSpan dict = {};
+
+		if (dictionaryId != 0 && mode != CompressionMode::None && !FindDictionary(dictionaryId, dict))
+			return false;
+
+		if (blockSize == 0)
+			return DecompressBlock(mode, dict, src, srcSize, dst, dstSize);
+
+		std::vector<uint32_t> offsets;
+		const uint8_t* data = nullptr;
+
+		if (!ReadBlockTable(src, srcSize, offsets, data)) return false;
+
+		const uint32_t blockCount = (uint32_t)offsets.size() - 1;
+
+		if ((size_t)blockCount * blockSize < dstSize) return false;
+
+		std::atomic<bool> success = true;
+
+		TaskPool::Get().ParallelFor(blockCount, [&](uint32_t i)
+		{
+			const size_t offset = (size_t)i * blockSize;
+
+			if (offset >= dstSize || offsets[i] > offsets[i + 1])
+			{
+				success = false;
+				return;
+			}
+
+			const size_t size = std::min<size_t>(blockSize, dstSize - offset);
+
+			if (!DecompressBlock(mode, dict, data + offsets[i], offsets[i + 1] - offsets[i], dst + offset, size))
+				success = false;
+		});
+
+		return success;
+	}
+
+	bool DecompressPayloadRange(CompressionMode mode, uint32_t dictionaryId, uint32_t blockSize, const uint8_t* src, size_t srcSize, size_t rawSize, size_t offset, uint8_t* dst, size_t size)
+	{
+		ByteSpan dict = {};
+
+		if (offset > rawSize || size > rawSize - offset) return false;
+
+		if (dictionaryId != 0 && mode != CompressionMode::None && !FindDictionary(dictionaryId, dict))
+			return false;
+
+		if (blockSize == 0)
+		{
+			std::vector<uint8_t> scratch(rawSize);
+
+			if (!DecompressBlock(mode, dict, src, srcSize, scratch.data(), rawSize)) return false;
+
+			memcpy(dst, scratch.data() + offset, size);
+			return true;
+		}
+
+		if (size == 0) return true;
+
+		std::vector<uint32_t> offsets;
+		const uint8_t* data = nullptr;
+
+		if (!ReadBlockTable(src, srcSize, offsets, data)) return false;
+
+		const uint32_t first = (uint32_t)(offset / blockSize);
+		const uint32_t last = (uint32_t)((offset + size - 1) / blockSize);
+
+		if (last + 1 >= offsets.size()) return false;
+
+		std::atomic<bool> success = true;
+
+		TaskPool::Get().ParallelFor(last - first + 1, [&](uint32_t i)
+		{
+			const uint32_t block = first + i;
+			const size_t blockOffset = (size_t)block * blockSize;
+			const size_t blockRaw = std::min<size_t>(blockSize, rawSize - blockOffset);
+
+			if (offsets[block] > offsets[block + 1])
+			{
+				success = false;
+				return;
+			}
+
+			const uint8_t* compressed = data + offsets[block];
+			const size_t compressedSize = offsets[block + 1] - offsets[block];
+
+			const size_t begin = std::max(offset, blockOffset);
+			const size_t end = std::min(offset + size, blockOffset + blockRaw);
+
+			// Blocks the range only partly covers are unpacked aside and trimmed
+			if (begin == blockOffset && end == blockOffset + blockRaw)
+			{
+				if (!DecompressBlock(mode, dict, compressed, compressedSize, dst + (begin - offset), blockRaw))
+					success = false;
+
+				return;
+			}
+
+			std::vector<uint8_t> scratch(blockRaw);
+
+			if (!DecompressBlock(mode, dict, compressed, compressedSize, scratch.data(), blockRaw))
+			{
+				success = false;
+				return;
+			}
+
+			memcpy(dst + (begin - offset), scratch.data() + (begin - blockOffset), end - begin);
+		});
+
+		return success;
+	}
+
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
 namespace Assets
 {
 
@@ -7,8 +11,25 @@ namespace Assets
 	{
 		None = 0,
 		LZ4,
+		LZ4HC,
 	};
 
 	CompressionMode ParseCompressionMode(const char* mode);
+	const char* GetCompressionModeName(CompressionMode mode);
+
+	// LZ4HC shares the LZ4 decoder and only trades packing time for ratio. Its level
+	// ranges from 1 to 12, 0 selects the LZ4HC default; plain LZ4 ignores the level.
+	// A non-zero dictionaryId primes every block with a dictionary registered through
+	// Dictionary.hpp, which must also be resident when the payload is decompressed.
+	// With blockSize == 0 the payload is a single compressed block. Otherwise it is split
+	// into independent blocks of blockSize raw bytes, preceded by a table holding the
+	// block count and count + 1 offsets relative to the end of the table, so both packing
+	// and unpacking fan out across the TaskPool workers.
+	void CompressPayload(CompressionMode mode, int level, uint32_t dictionaryId, uint32_t blockSize, const uint8_t* src, size_t srcSize, std::vector<uint8_t>& dst);
+	bool DecompressPayload(CompressionMode mode, uint32_t dictionaryId, uint32_t blockSize, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+	// Unpacks only raw bytes [offset, offset + size) of a payload of rawSize bytes into dst. Split
+	// payloads decompress just the blocks overlapping the range, a single block is unpacked whole.
+	bool DecompressPayloadRange(CompressionMode mode, uint32_t dictionaryId, uint32_t blockSize, const uint8_t* src, size_t srcSize, size_t rawSize, size_t offset, uint8_t* dst, size_t size);
 
 }
\ No newline at end of file
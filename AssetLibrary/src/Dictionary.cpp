@@ -0,0 +1,137 @@
+#include "Dictionary.hpp"
+#include "Metadata.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <xxhash.h>
+
+#include <unordered_map>
+
+namespace Assets
+{
+
+	struct DictionaryMetadata
+	{
+		uint32_t HeaderSize;
+		uint32_t Id;
+		uint32_t Size;
+	};
+
+	static std::unordered_map<uint32_t, std::vector<uint8_t>> s_Dictionaries = {};
+
+	uint32_t ComputeDictionaryId(const uint8_t* data, size_t size)
+	{
+		const uint32_t id = (uint32_t)XXH64(data, size, 0);
+		return id != 0 ? id : 1;
+	}
+
+	bool LoadDictionary(const char* path)
+	{
+		Asset file = {};
+
+		if (!LoadBinary(path, file) || memcmp(file.Type, "DICT", 4) != 0)
+			return false;
+
+		return RegisterDictionary(ParseDictionaryAssetInfo(&file));
+	}
+
+	bool RegisterDictionary(const DictionaryAssetInfo& info)
+	{
+		if (info.Id == 0 || info.Data.empty() || info.Data.size() > MaxDictionarySize)
+			return false;
+
+		s_Dictionaries[info.Id] = info.Data;
+
+		return true;
+	}
+
+	void UnloadDictionaries()
+	{
+		s_Dictionaries.clear();
+	}
+
+	bool FindDictionary(uint32_t id, ByteSpan& data)
+	{
+		auto it = s_Dictionaries.find(id);
+
+		if (it == s_Dictionaries.end()) return false;
+
+		data.Data = it->second.data();
+		data.Size = it->second.size();
+
+		return true;
+	}
+
+	DictionaryAssetInfo ParseDictionaryAssetInfo(Asset* file)
+	{
+		DictionaryAssetInfo info = {};
+		uint32_t size = 0;
+
+		if (file->Version >= AssetVersionBinary)
+		{
+			DictionaryMetadata metadata;
+			MetadataReader reader(file->Json);
+
+			if (!reader.ReadHeader(&metadata, sizeof(DictionaryMetadata)))
+				return info;
+
+			info.Id = metadata.Id;
+			size = metadata.Size;
+		}
+
+		else
+		{
+			nlohmann::json metadata = nlohmann::json::parse(file->Json);
+
+			info.Id = metadata["id"];
+			size = metadata["size"];
+		}
+
+		if (size > file->Binary.size())
+			return {};
+
+		info.Data.assign(file->Binary.begin(), file->Binary.begin() + size);
+
+		return info;
+	}
+
+	Asset PackDictionary(DictionaryAssetInfo* info, uint32_t version)
+	{
+		Asset file = {};
+
+		file.Type[0] = 'D'; file.Type[1] = 'I';
+		file.Type[2] = 'C'; file.Type[3] = 'T';
+
+		file.Version = version;
+
+		if (version >= AssetVersionBinary)
+		{
+			DictionaryMetadata metadata;
+			memset(&metadata, 0, sizeof(DictionaryMetadata));
+
+			metadata.HeaderSize = sizeof(DictionaryMetadata);
+			metadata.Id = info->Id;
+			metadata.Size = info->Data.size();
+
+			MetadataWriter writer;
+			writer.Write(metadata);
+
+			file.Json = std::move(writer.Data());
+		}
+
+		else
+		{
+			nlohmann::json metadata;
+
+			metadata["id"] = info->Id;
+			metadata["size"] = info->Data.size();
+
+			file.Json = metadata.dump();
+		}
+
+		file.Binary = info->Data;
+
+		return file;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Asset.hpp"
+
+#include <vector>
+
+namespace Assets
+{
+
+	// LZ4 only looks back 64 KiB, anything beyond that would never be referenced
+	static const uint32_t MaxDictionarySize = 64 * 1024;
+
+	struct DictionaryAssetInfo
+	{
+		uint32_t Id = 0;
+		std::vector<uint8_t> Data = {};
+	};
+
+	// Non-zero id derived from the dictionary contents, 0 means "no dictionary"
+	uint32_t ComputeDictionaryId(const uint8_t* data, size_t size);
+
+	// Loaded dictionaries stay resident until UnloadDictionaries(), since any asset
+	// packed against them needs the same bytes to decode
+	bool LoadDictionary(const char* path);
+	bool RegisterDictionary(const DictionaryAssetInfo& info);
+	void UnloadDictionaries();
+
+	bool FindDictionary(uint32_t id, ByteSpan& data);
+
+	DictionaryAssetInfo ParseDictionaryAssetInfo(Asset* file);
+	Asset PackDictionary(DictionaryAssetInfo* info, uint32_t version = AssetVersionLatest);
+
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Assets
+{
+
+#ifdef _WIN32
+
+	bool MapFile(const char* path, MappedFile& file)
+	{
+		HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (f == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size = {};
+
+		if (!GetFileSizeEx(f, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(f);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(f);
+
+		if (mapping == nullptr) return false;
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+		if (data == nullptr)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		file.Data = data;
+		file.Size = (size_t)size.QuadPart;
+		file.Handle = mapping;
+
+		return true;
+	}
+
+	void UnmapFile(MappedFile& file)
+	{
+		if (file.Data != nullptr)
+			UnmapViewOfFile(file.Data);
+
+		if (file.Handle != nullptr)
+			CloseHandle((HANDLE)file.Handle);
+
+		file = {};
+	}
+
+#else
+
+	bool MapFile(const char* path, MappedFile& file)
+	{
+		int fd = open(path, O_RDONLY);
+
+		if (fd < 0) return false;
+
+		struct stat st = {};
+
+		if (fstat(fd, &st) != 0 || st.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (data == MAP_FAILED) return false;
+
+		// Assets are consumed front to back exactly once, let the kernel read ahead
+		madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+		file.Data = data;
+		file.Size = (size_t)st.st_size;
+
+		return true;
+	}
+
+	void UnmapFile(MappedFile& file)
+	{
+		if (file.Data != nullptr)
+			munmap(file.Data, file.Size);
+
+		file = {};
+	}
+
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Assets
+{
+
+	// Read-only memory mapping of a whole file
+	struct MappedFile
+	{
+		void* Data = nullptr;
+		size_t Size = 0;
+		void* Handle = nullptr;
+	};
+
+	bool MapFile(const char* path, MappedFile& file);
+	void UnmapFile(MappedFile& file);
+
+}
\ No newline at end of file
@@ -1,11 +1,26 @@
 #include "Asset.hpp"
 #include "MaterialAsset.hpp"
+#include "Metadata.hpp"
+#include "Compression.hpp"
 
 #include <nlohmann/json.hpp>
 
+#include <map>
+
 namespace Assets
 {
 
+	struct MaterialMetadata
+	{
+		uint32_t HeaderSize;
+		uint32_t Transparency;
+		uint32_t TextureCount;
+		uint64_t ContentHash;
+		uint32_t RegionCount;
+		uint32_t DictionaryId;
+		uint32_t TablesSize;
+	};
+
 	static TransparencyMode ParseTransparencyMode(const char* mode)
 	{
 		if (strcmp("opaque", mode) == 0)
@@ -20,26 +35,205 @@ namespace Assets
 		return TransparencyMode::Opaque;
 	}
 
-	MaterialAssetInfo ParseMaterialAssetInfo(Asset* file)
+	static uint64_t HashMaterialContent(const MaterialAssetInfo* info)
+	{
+		const uint32_t transparency = (uint32_t)info->Transparency;
+		uint64_t hash = HashContent(&transparency, sizeof(transparency));
+
+		for (const auto& [key, value] : std::map<std::string, std::string>(info->Textures.begin(), info->Textures.end()))
+		{
+			hash = HashContent(key.data(), key.size(), hash);
+			hash = HashContent(value.data(), value.size(), hash);
+		}
+
+		for (const auto& [key, region] : std::map<std::string, TextureRegion>(info->Regions.begin(), info->Regions.end()))
+		{
+			hash = HashContent(key.data(), key.size(), hash);
+			hash = HashContent(&region, sizeof(region), hash);
+		}
+
+		return hash;
+	}
+
+	static MaterialAssetInfo ParseMaterialMetadataJson(std::string_view json)
 	{
 		MaterialAssetInfo info = {};
-		nlohmann::json metadata = nlohmann::json::parse(file->Json);
+		nlohmann::json metadata = nlohmann::json::parse(json);
 
 		for (auto& [key, value] : metadata["textures"].items())
 			info.Textures[key] = value;
 
+		if (metadata.contains("regions"))
+		{
+			for (auto& [key, value] : metadata["regions"].items())
+			{
+				TextureRegion& region = info.Regions[key];
+				region.Scale[0] = value[0]; region.Scale[1] = value[1];
+				region.Offset[0] = value[2]; region.Offset[1] = value[3];
+			}
+		}
+
 		const std::string transparency = metadata["transparency"];
 		info.Transparency = ParseTransparencyMode(transparency.c_str());
+		info.ContentHash = metadata.value("hash", 0ull);
+
+		return info;
+	}
+
+	static void ReadMaterialTables(MetadataReader& reader, const MaterialMetadata& metadata, MaterialAssetInfo& info)
+	{
+		for (uint32_t i = 0; i < metadata.TextureCount; i++)
+		{
+			std::string key, value;
+
+			if (!reader.ReadString(key) || !reader.ReadString(value))
+				return;
+
+			info.Textures[std::move(key)] = std::move(value);
+		}
+
+		for (uint32_t i = 0; i < metadata.RegionCount; i++)
+		{
+			std::string key;
+			TextureRegion region;
+
+			if (!reader.ReadString(key) || !reader.Read(region))
+				return;
+
+			info.Regions[std::move(key)] = region;
+		}
+	}
+
+	static MaterialAssetInfo ParseMaterialMetadataBinary(std::string_view data, const uint8_t* binary, size_t binarySize)
+	{
+		MaterialAssetInfo info = {};
+		MaterialMetadata metadata;
+
+		MetadataReader reader(data);
+
+		if (!reader.ReadHeader(&metadata, sizeof(MaterialMetadata)))
+			return info;
+
+		info.Transparency = (TransparencyMode)metadata.Transparency;
+		info.DictionaryId = metadata.DictionaryId;
+		info.ContentHash = metadata.ContentHash;
+
+		if (metadata.DictionaryId == 0)
+		{
+			ReadMaterialTables(reader, metadata, info);
+			return info;
+		}
+
+		// A payload that does not decompress leaves the material without textures rather than with garbage
+		std::string tables(metadata.TablesSize, '\0');
+
+		if (!DecompressPayload(CompressionMode::LZ4, metadata.DictionaryId, 0, binary, binarySize, (uint8_t*)tables.data(), tables.size()))
+			return info;
+
+		MetadataReader tableReader(tables);
+		ReadMaterialTables(tableReader, metadata, info);
 
 		return info;
 	}
 
-	Asset PackMaterial(MaterialAssetInfo* info)
+	static MaterialAssetInfo ParseMaterialMetadata(uint32_t version, std::string_view data, const uint8_t* binary, size_t binarySize)
+	{
+		if (version >= AssetVersionBinary)
+			return ParseMaterialMetadataBinary(data, binary, binarySize);
+
+		return ParseMaterialMetadataJson(data);
+	}
+
+	// Tables go out in key order, so equal materials write equal bytes for a dictionary to match
+	static void WriteMaterialTables(MetadataWriter& writer, const MaterialAssetInfo* info)
 	{
+		for (const auto& [key, value] : std::map<std::string, std::string>(info->Textures.begin(), info->Textures.end()))
+		{
+			writer.WriteString(key);
+			writer.WriteString(value);
+		}
+
+		for (const auto& [key, region] : std::map<std::string, TextureRegion>(info->Regions.begin(), info->Regions.end()))
+		{
+			writer.WriteString(key);
+			writer.Write(region);
+		}
+	}
+
+	static std::string WriteMaterialMetadataBinary(const MaterialAssetInfo* info, uint32_t tablesSize)
+	{
+		MaterialMetadata metadata;
+		memset(&metadata, 0, sizeof(MaterialMetadata));
+
+		metadata.HeaderSize = sizeof(MaterialMetadata);
+		metadata.Transparency = (uint32_t)info->Transparency;
+		metadata.TextureCount = info->Textures.size();
+		metadata.ContentHash = info->ContentHash;
+		metadata.RegionCount = info->Regions.size();
+		metadata.DictionaryId = info->DictionaryId;
+		metadata.TablesSize = tablesSize;
+
+		MetadataWriter writer;
+		writer.Write(metadata);
+
+		if (info->DictionaryId == 0)
+			WriteMaterialTables(writer, info);
+
+		return std::move(writer.Data());
+	}
+
+	std::string WriteMaterialTables(const MaterialAssetInfo* info)
+	{
+		MetadataWriter writer;
+		WriteMaterialTables(writer, info);
+
+		return std::move(writer.Data());
+	}
+
+	MaterialAssetInfo ParseMaterialAssetInfo(Asset* file)
+	{
+		return ParseMaterialMetadata(file->Version, file->Json, file->Binary.data(), file->Binary.size());
+	}
+
+	MaterialAssetInfo ParseMaterialAssetInfo(const AssetView* view)
+	{
+		return ParseMaterialMetadata(view->Header->Version, view->Json, view->Binary.Data, view->Binary.Size);
+	}
+
+	Asset PackMaterial(MaterialAssetInfo* info, uint32_t version)
+	{
+		Asset file = {};
+
+		file.Type[0] = 'M'; file.Type[1] = 'A';
+		file.Type[2] = 'T'; file.Type[3] = 'X';
+
+		file.Version = version;
+		info->ContentHash = HashMaterialContent(info);
+
+		if (version >= AssetVersionBinary && info->DictionaryId != 0)
+		{
+			const std::string tables = WriteMaterialTables(info);
+
+			file.Json = WriteMaterialMetadataBinary(info, tables.size());
+			CompressPayload(CompressionMode::LZ4, 0, info->DictionaryId, 0, (const uint8_t*)tables.data(), tables.size(), file.Binary);
+
+			return file;
+		}
+
+		if (version >= AssetVersionBinary)
+		{
+			file.Json = WriteMaterialMetadataBinary(info, 0);
+			return file;
+		}
+
 		nlohmann::json metadata;
 
 		metadata["textures"] = info->Textures;
 
+		for (const auto& [key, region] : info->Regions)
+			metadata["regions"][key] = { region.Scale[0], region.Scale[1], region.Offset[0], region.Offset[1] };
+		metadata["hash"] = info->ContentHash;
+
 		switch (info->Transparency)
 		{
 			case TransparencyMode::Opaque:
@@ -55,14 +249,7 @@ namespace Assets
 				break;
 		}
 
-		const std::string jsonString = metadata.dump();
-
-		Asset file = {};
-
-		file.Type[0] = 'M'; file.Type[1] = 'A';
-		file.Type[2] = 'T'; file.Type[3] = 'X';
-
-		file.Json = std::move(jsonString);
+		file.Json = metadata.dump();
 
 		return file;
 	}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Asset.hpp"
+
 #include <unordered_map>
 
 namespace Assets
@@ -12,16 +14,33 @@ namespace Assets
 		Masked,
 	};
 
+	// Part of a texture a slot samples, e.g. its place in an atlas: uv * Scale + Offset
+	struct TextureRegion
+	{
+		float Scale[2] = { 1.0f, 1.0f };
+		float Offset[2] = { 0.0f, 0.0f };
+	};
+
 	struct MaterialAssetInfo
 	{
 		std::unordered_map<std::string, std::string> Textures;
+
+		// Only slots sampling part of their texture have an entry, the rest use all of it
+		std::unordered_map<std::string, TextureRegion> Regions;
 		TransparencyMode Transparency = TransparencyMode::Transparent;
-	};
 
-	struct Asset;
+		// A non-zero id moves the texture and region tables of binary versions into the payload,
+		// LZ4 compressed against that dictionary
+		uint32_t DictionaryId = 0;
+		uint64_t ContentHash = 0;
+	};
 
 	MaterialAssetInfo ParseMaterialAssetInfo(Asset* file);
+	MaterialAssetInfo ParseMaterialAssetInfo(const AssetView* view);
+
+	Asset PackMaterial(MaterialAssetInfo* info, uint32_t version = AssetVersionLatest);
 
-	Asset PackMaterial(MaterialAssetInfo* info);
+	// The texture and region tables as PackMaterial compresses them, e.g. to train a dictionary on
+	std::string WriteMaterialTables(const MaterialAssetInfo* info);
 
 }
\ No newline at end of file
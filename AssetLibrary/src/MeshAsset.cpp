@@ -1,14 +1,36 @@
 #include "Asset.hpp"
 #include "MeshAsset.hpp"
+#include "MeshFilter.hpp"
 #include "Compression.hpp"
+#include "Metadata.hpp"
 
 #include <nlohmann/json.hpp>
 
-#include <lz4.h>
+#include <algorithm>
 
 namespace Assets
 {
 
+	struct MeshMetadata
+	{
+		uint32_t HeaderSize;
+		uint32_t Compression;
+		uint32_t Format;
+		uint32_t VertexBufferSize;
+		uint32_t IndexBufferSize;
+		uint32_t BlockSize;
+		int32_t CompressionLevel;
+		uint32_t DictionaryId;
+		uint64_t ContentHash;
+		uint32_t MeshletCount;
+		uint32_t LodCount;
+		float PositionOffset[3];
+		float PositionScale[3];
+		uint32_t IndexFormat;
+		uint32_t Attributes;
+		uint32_t Filter;
+	};
+
 	static VertexFormat ParseVertexFormat(const char* format)
 	{
 		if (strcmp("PosColNorUV", format) == 0)
@@ -17,9 +39,178 @@ namespace Assets
 		if (strcmp("PosNorUV", format) == 0)
 			return VertexFormat::PosNorUv;
 
+		if (strcmp("PackedPosColNorUV", format) == 0)
+			return VertexFormat::PackedPosColNorUV;
+
 		return VertexFormat::None;
 	}
 
+	static const char* GetVertexFormatName(VertexFormat format)
+	{
+		switch (format)
+		{
+			case VertexFormat::PosColNorUV:
+				return "PosColNorUV";
+
+			case VertexFormat::PosNorUv:
+				return "PosNorUV";
+
+			case VertexFormat::PackedPosColNorUV:
+				return "PackedPosColNorUV";
+
+			default:
+				return "None";
+		}
+	}
+
+	uint32_t GetIndexSize(IndexFormat format)
+	{
+		return format == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+	}
+
+	uint32_t GetVertexSize(VertexFormat format)
+	{
+		switch (format)
+		{
+			case VertexFormat::PosColNorUV:
+				return sizeof(VertexPosColNorUV);
+
+			case VertexFormat::PosNorUv:
+				return sizeof(VertexPosNorUV);
+
+			case VertexFormat::PackedPosColNorUV:
+				return sizeof(VertexPackedPosColNorUV);
+
+			default:
+				return 0;
+		}
+	}
+
+	static constexpr uint32_t VertexAttributeCount = 4;
+
+	// Size of each attribute in the order of the flags, and where it sits in an interleaved vertex
+	static bool GetAttributeLayout(VertexFormat format, uint32_t sizes[VertexAttributeCount], uint32_t offsets[VertexAttributeCount])
+	{
+		switch (format)
+		{
+			case VertexFormat::PosColNorUV:
+			{
+				const uint32_t s[] = { 12, 12, 12, 8 };
+				const uint32_t o[] = { offsetof(VertexPosColNorUV, Position), offsetof(VertexPosColNorUV, Color), offsetof(VertexPosColNorUV, Normal), offsetof(VertexPosColNorUV, UV) };
+
+				memcpy(sizes, s, sizeof(s));
+				memcpy(offsets, o, sizeof(o));
+				return true;
+			}
+
+			case VertexFormat::PackedPosColNorUV:
+			{
+				const uint32_t s[] = { 8, 4, 4, 4 };
+				const uint32_t o[] = { offsetof(VertexPackedPosColNorUV, Position), offsetof(VertexPackedPosColNorUV, Color), offsetof(VertexPackedPosColNorUV, Normal), offsetof(VertexPackedPosColNorUV, UV) };
+
+				memcpy(sizes, s, sizeof(s));
+				memcpy(offsets, o, sizeof(o));
+				return true;
+			}
+
+			default:
+				return false;
+		}
+	}
+
+	uint32_t GetVertexStride(VertexFormat format, uint32_t attributes)
+	{
+		uint32_t sizes[VertexAttributeCount], offsets[VertexAttributeCount];
+
+		if (attributes == 0 || !GetAttributeLayout(format, sizes, offsets))
+			return GetVertexSize(format);
+
+		uint32_t stride = 0;
+
+		for (uint32_t a = 0; a < VertexAttributeCount; a++)
+		{
+			if (attributes & (1u << a))
+				stride += sizes[a];
+		}
+
+		return stride;
+	}
+
+	uint32_t GetVertexStreamOffset(VertexFormat format, uint32_t attributes, size_t vertexCount)
+	{
+		if (attributes == 0) return 0;
+
+		return GetVertexStride(format, attributes & VertexAttributePosition) * vertexCount;
+	}
+
+	// Byte offset of the first vertex's attribute and the distance to the next one
+	static bool LocateAttribute(VertexFormat format, uint32_t attributes, uint32_t attribute, size_t vertexCount, size_t& offset, size_t& stride)
+	{
+		uint32_t sizes[VertexAttributeCount], offsets[VertexAttributeCount];
+
+		if (!GetAttributeLayout(format, sizes, offsets))
+			return false;
+
+		if (attributes == 0)
+		{
+			offset = offsets[attribute];
+			stride = GetVertexSize(format);
+			return true;
+		}
+
+		if ((attributes & (1u << attribute)) == 0)
+			return false;
+
+		if (attribute == 0)
+		{
+			offset = 0;
+			stride = sizes[0];
+			return true;
+		}
+
+		offset = GetVertexStreamOffset(format, attributes, vertexCount);
+		stride = GetVertexStride(format, attributes & ~VertexAttributePosition);
+
+		for (uint32_t a = 1; a < attribute; a++)
+		{
+			if (attributes & (1u << a))
+				offset += sizes[a];
+		}
+
+		return true;
+	}
+
+	void ConvertVertexStreams(VertexFormat format, uint8_t* dst, uint32_t dstAttributes, const uint8_t* src, uint32_t srcAttributes, size_t vertexCount)
+	{
+		uint32_t sizes[VertexAttributeCount], offsets[VertexAttributeCount];
+
+		if (!GetAttributeLayout(format, sizes, offsets))
+			return;
+
+		for (uint32_t a = 0; a < VertexAttributeCount; a++)
+		{
+			size_t dstOffset, dstStride, srcOffset, srcStride;
+
+			if (!LocateAttribute(format, dstAttributes, a, vertexCount, dstOffset, dstStride))
+				continue;
+
+			uint8_t* out = dst + dstOffset;
+
+			if (!LocateAttribute(format, srcAttributes, a, vertexCount, srcOffset, srcStride))
+			{
+				for (size_t v = 0; v < vertexCount; v++, out += dstStride)
+					memset(out, 0, sizes[a]);
+
+				continue;
+			}
+
+			const uint8_t* in = src + srcOffset;
+
+			for (size_t v = 0; v < vertexCount; v++, out += dstStride, in += srcStride)
+				memcpy(out, in, sizes[a]);
+		}
+	}
+
 	bool VertexPosColNorUV::operator==(const VertexPosColNorUV& v) const
 	{
 		return Position[0] == v.Position[0] && Position[1] == v.Position[1] && Position[2] == v.Position[2] &&
@@ -35,14 +226,23 @@ namespace Assets
 			UV[0] == v.UV[0] && UV[1] == v.UV[1];
 	}
 
-	MeshAssetInfo ParseMeshAssetInfo(Asset* file)
+	static MeshAssetInfo ParseMeshMetadataJson(std::string_view json)
 	{
 		MeshAssetInfo info = {};
-		nlohmann::json metadata = nlohmann::json::parse(file->Json);
+		nlohmann::json metadata = nlohmann::json::parse(json);
 
 		info.Name = metadata["name"];
 		info.VertexBufferSize = metadata["vbosize"];
 		info.IndexBufferSize = metadata["ibosize"];
+		info.BlockSize = metadata.value("blocksize", 0u);
+		info.CompressionLevel = metadata.value("compressionlevel", 0);
+		info.DictionaryId = metadata.value("dictionary", 0u);
+		info.ContentHash = metadata.value("hash", 0ull);
+		info.MeshletCount = metadata.value("meshlets", 0u);
+		info.LodCount = metadata.value("lods", 0u);
+		info.IndexType = metadata.value("indexformat", "UInt32") == "UInt16" ? IndexFormat::UInt16 : IndexFormat::UInt32;
+		info.Attributes = metadata.value("attributes", 0u);
+		info.Filter = metadata.value("filter", "None") == "DeltaShuffle" ? MeshFilter::DeltaShuffle : MeshFilter::None;
 
 		const std::string compression = metadata["compression"];
 		info.Compression = ParseCompressionMode(compression.c_str());
@@ -50,56 +250,235 @@ namespace Assets
 		const std::string format = metadata["format"];
 		info.Format = ParseVertexFormat(format.c_str());
 
+		if (info.Format == VertexFormat::PackedPosColNorUV)
+		{
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				info.PositionOffset[i] = metadata["positionoffset"][i];
+				info.PositionScale[i] = metadata["positionscale"][i];
+			}
+		}
+
 		return info;
 	}
 
-	void UnpackMesh(MeshAssetInfo* info, const uint8_t* src, size_t srcSize, uint8_t* dstVbo, uint8_t* dstIbo)
+	static MeshAssetInfo ParseMeshMetadataBinary(std::string_view data)
 	{
-		if (info->Compression == CompressionMode::LZ4)
-		{
-			std::vector<uint8_t> data(info->VertexBufferSize + info->IndexBufferSize);
+		MeshAssetInfo info = {};
+		MeshMetadata metadata;
 
-			LZ4_decompress_safe((const char*)src, (char*)data.data(), (int)srcSize, (int)data.size());
+		MetadataReader reader(data);
 
-			memcpy(dstVbo, data.data(), info->VertexBufferSize);
-			memcpy(dstIbo, data.data() + info->VertexBufferSize, info->IndexBufferSize);
+		if (!reader.ReadHeader(&metadata, sizeof(MeshMetadata)))
+			return info;
 
-			return;
+		info.Compression = (CompressionMode)metadata.Compression;
+		info.Format = (VertexFormat)metadata.Format;
+		info.VertexBufferSize = metadata.VertexBufferSize;
+		info.IndexBufferSize = metadata.IndexBufferSize;
+		info.BlockSize = metadata.BlockSize;
+		info.CompressionLevel = metadata.CompressionLevel;
+		info.DictionaryId = metadata.DictionaryId;
+		info.ContentHash = metadata.ContentHash;
+		info.MeshletCount = metadata.MeshletCount;
+		info.LodCount = metadata.LodCount;
+		info.IndexType = (IndexFormat)metadata.IndexFormat;
+		info.Attributes = metadata.Attributes;
+		info.Filter = (MeshFilter)metadata.Filter;
+
+		// Older headers zero-fill the quantization range, which only packed formats read
+		if (info.Format == VertexFormat::PackedPosColNorUV)
+		{
+			memcpy(info.PositionOffset, metadata.PositionOffset, sizeof(info.PositionOffset));
+			memcpy(info.PositionScale, metadata.PositionScale, sizeof(info.PositionScale));
 		}
 
-		memcpy(dstVbo, src, info->VertexBufferSize);
-		memcpy(dstIbo, src + info->VertexBufferSize, info->IndexBufferSize);
+		reader.ReadString(info.Name);
+
+		return info;
 	}
 
-	Asset PackMesh(MeshAssetInfo* info, void* vbo, void* ibo)
+	static MeshAssetInfo ParseMeshMetadata(uint32_t version, std::string_view data)
 	{
+		if (version >= AssetVersionBinary)
+			return ParseMeshMetadataBinary(data);
+
+		return ParseMeshMetadataJson(data);
+	}
+
+	static std::string WriteMeshMetadata(const MeshAssetInfo* info, uint32_t version)
+	{
+		if (version >= AssetVersionBinary)
+		{
+			MeshMetadata metadata;
+			memset(&metadata, 0, sizeof(MeshMetadata));
+
+			metadata.HeaderSize = sizeof(MeshMetadata);
+			metadata.Compression = (uint32_t)info->Compression;
+			metadata.Format = (uint32_t)info->Format;
+			metadata.VertexBufferSize = info->VertexBufferSize;
+			metadata.IndexBufferSize = info->IndexBufferSize;
+			metadata.BlockSize = info->BlockSize;
+			metadata.CompressionLevel = info->CompressionLevel;
+			metadata.DictionaryId = info->DictionaryId;
+			metadata.ContentHash = info->ContentHash;
+			metadata.MeshletCount = info->MeshletCount;
+			metadata.LodCount = info->LodCount;
+			metadata.IndexFormat = (uint32_t)info->IndexType;
+			metadata.Attributes = info->Attributes;
+			metadata.Filter = (uint32_t)info->Filter;
+			memcpy(metadata.PositionOffset, info->PositionOffset, sizeof(metadata.PositionOffset));
+			memcpy(metadata.PositionScale, info->PositionScale, sizeof(metadata.PositionScale));
+
+			MetadataWriter writer;
+			writer.Write(metadata);
+			writer.WriteString(info->Name);
+
+			return std::move(writer.Data());
+		}
+
 		nlohmann::json metadata;
 
-		metadata["compression"] = "LZ4";
-		metadata["format"] = "PosColNorUV";
+		metadata["compression"] = GetCompressionModeName(info->Compression);
+		metadata["format"] = GetVertexFormatName(info->Format);
 		metadata["name"] = info->Name;
 		metadata["vbosize"] = info->VertexBufferSize;
 		metadata["ibosize"] = info->IndexBufferSize;
+		metadata["blocksize"] = info->BlockSize;
+		metadata["compressionlevel"] = info->CompressionLevel;
+		metadata["dictionary"] = info->DictionaryId;
+		metadata["hash"] = info->ContentHash;
+		metadata["meshlets"] = info->MeshletCount;
+		metadata["lods"] = info->LodCount;
+		metadata["indexformat"] = info->IndexType == IndexFormat::UInt16 ? "UInt16" : "UInt32";
+		metadata["attributes"] = info->Attributes;
+		metadata["filter"] = info->Filter == MeshFilter::DeltaShuffle ? "DeltaShuffle" : "None";
+
+		if (info->Format == VertexFormat::PackedPosColNorUV)
+		{
+			metadata["positionoffset"] = info->PositionOffset;
+			metadata["positionscale"] = info->PositionScale;
+		}
+
+		return metadata.dump();
+	}
+
+	MeshAssetInfo ParseMeshAssetInfo(Asset* file)
+	{
+		return ParseMeshMetadata(file->Version, file->Json);
+	}
+
+	MeshAssetInfo ParseMeshAssetInfo(const AssetView* view)
+	{
+		return ParseMeshMetadata(view->Header->Version, view->Json);
+	}
+
+	uint32_t GetVertexCount(const MeshAssetInfo* info)
+	{
+		const uint32_t stride = GetVertexStride(info->Format, info->Attributes);
+		return stride > 0 ? info->VertexBufferSize / stride : 0;
+	}
 
-		const std::string jsonString = metadata.dump();
+	static size_t GetMeshletTableSize(const MeshAssetInfo* info)
+	{
+		return (size_t)info->MeshletCount * sizeof(Meshlet);
+	}
+
+	static size_t GetLodTableSize(const MeshAssetInfo* info)
+	{
+		return (size_t)info->LodCount * sizeof(MeshLod);
+	}
+
+	bool UnpackMesh(MeshAssetInfo* info, const uint8_t* src, size_t srcSize, uint8_t* dst)
+	{
+		const size_t tableSize = std::min(GetMeshletTableSize(info) + GetLodTableSize(info), srcSize);
+		const size_t size = info->VertexBufferSize + info->IndexBufferSize;
+
+		if (info->Filter == MeshFilter::None)
+			return DecompressPayload(info->Compression, info->DictionaryId, info->BlockSize, src, srcSize - tableSize, dst, size);
+
+		// Filters do not decode in place, so the payload goes through a scratch buffer
+		std::vector<uint8_t> filtered(size);
+
+		if (!DecompressPayload(info->Compression, info->DictionaryId, info->BlockSize, src, srcSize - tableSize, filtered.data(), size))
+			return false;
+
+		DecodeMeshFilter(info, filtered.data(), dst);
+		return true;
+	}
+
+	bool UnpackMesh(MeshAssetInfo* info, const uint8_t* src, size_t srcSize, uint8_t* dstVbo, uint8_t* dstIbo)
+	{
+		if (dstIbo == dstVbo + info->VertexBufferSize)
+			return UnpackMesh(info, src, srcSize, dstVbo);
+
+		std::vector<uint8_t> data(info->VertexBufferSize + info->IndexBufferSize);
+
+		if (!UnpackMesh(info, src, srcSize, data.data()))
+			return false;
+
+		memcpy(dstVbo, data.data(), info->VertexBufferSize);
+		memcpy(dstIbo, data.data() + info->VertexBufferSize, info->IndexBufferSize);
+
+		return true;
+	}
 
+	bool UnpackMeshlets(const MeshAssetInfo* info, const uint8_t* src, size_t srcSize, Meshlet* dst)
+	{
+		const size_t tableSize = GetMeshletTableSize(info);
+		const size_t lodTableSize = GetLodTableSize(info);
+
+		if (tableSize + lodTableSize > srcSize) return false;
+
+		memcpy(dst, src + srcSize - lodTableSize - tableSize, tableSize);
+
+		return true;
+	}
+
+	bool UnpackMeshLods(const MeshAssetInfo* info, const uint8_t* src, size_t srcSize, MeshLod* dst)
+	{
+		const size_t tableSize = GetLodTableSize(info);
+
+		if (tableSize > srcSize) return false;
+
+		memcpy(dst, src + srcSize - tableSize, tableSize);
+
+		return true;
+	}
+
+	Asset PackMesh(MeshAssetInfo* info, void* vbo, void* ibo, uint32_t version, const Meshlet* meshlets, const MeshLod* lods)
+	{
 		Asset file = {};
 
 		file.Type[0] = 'M'; file.Type[1] = 'E';
 		file.Type[2] = 'S'; file.Type[3] = 'H';
 
-		file.Json = std::move(jsonString);
+		file.Version = version;
+
+		info->ContentHash = HashContent(vbo, info->VertexBufferSize, (uint64_t)info->Format | ((uint64_t)info->IndexType << 32) | ((uint64_t)info->Attributes << 40));
+		info->ContentHash = HashContent(ibo, info->IndexBufferSize, info->ContentHash);
+
+		// Quantized positions are relative to the bounds, so meshes differing only in size or
+		// placement have identical buffers
+		info->ContentHash = HashContent(info->PositionOffset, sizeof(info->PositionOffset), info->ContentHash);
+		info->ContentHash = HashContent(info->PositionScale, sizeof(info->PositionScale), info->ContentHash);
+
+		if (meshlets == nullptr) info->MeshletCount = 0;
+		if (lods == nullptr) info->LodCount = 0;
+
+		file.Json = WriteMeshMetadata(info, version);
 
 		std::vector<uint8_t> mergedBuffer(info->VertexBufferSize + info->IndexBufferSize);
 
-		memcpy(mergedBuffer.data(), vbo, info->VertexBufferSize);
-		memcpy(mergedBuffer.data() + info->VertexBufferSize, ibo, info->IndexBufferSize);
+		EncodeMeshFilter(info, (const uint8_t*)vbo, (const uint8_t*)ibo, mergedBuffer.data());
+
+		CompressPayload(info->Compression, info->CompressionLevel, info->DictionaryId, info->BlockSize, mergedBuffer.data(), mergedBuffer.size(), file.Binary);
 
-		int stagingSize = LZ4_compressBound(mergedBuffer.size());
-		file.Binary.resize(stagingSize);
+		const uint8_t* table = (const uint8_t*)meshlets;
+		file.Binary.insert(file.Binary.end(), table, table + GetMeshletTableSize(info));
 
-		int compressedSize = LZ4_compress_default((const char*)mergedBuffer.data(), (char*)file.Binary.data(), mergedBuffer.size(), stagingSize);
-		file.Binary.resize(compressedSize);
+		const uint8_t* lodTable = (const uint8_t*)lods;
+		file.Binary.insert(file.Binary.end(), lodTable, lodTable + GetLodTableSize(info));
 
 		return file;
 	}
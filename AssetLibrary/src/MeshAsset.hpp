@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Asset.hpp"
+#include "Meshlet.hpp"
+
 #include <string>
 
 namespace Assets
@@ -10,6 +13,7 @@ namespace Assets
 		None = 0,
 		PosColNorUV,
 		PosNorUv,
+		PackedPosColNorUV,
 	};
 
 	struct VertexPosColNorUV
@@ -31,45 +35,100 @@ namespace Assets
 		bool operator==(const VertexPosNorUV& v) const;
 	};
 
+	// Position as unorm16 within the mesh bounds (PositionOffset + value * PositionScale),
+	// color as RGBA8, the normal octahedron-encoded as snorm16 and UVs as half floats
+	struct VertexPackedPosColNorUV
+	{
+		uint16_t Position[4];
+		uint8_t Color[4];
+		int16_t Normal[2];
+		uint16_t UV[2];
+	};
+
+	uint32_t GetVertexSize(VertexFormat format);
+
+	// Which attributes a mesh stores, each encoded as in its VertexFormat
+	enum VertexAttributeFlags : uint32_t
+	{
+		VertexAttributePosition = 1 << 0,
+		VertexAttributeColor = 1 << 1,
+		VertexAttributeNormal = 1 << 2,
+		VertexAttributeUV = 1 << 3,
+	};
+
+	// Vertices with attribute flags are split into a stream of positions followed by a stream
+	// interleaving the other attributes present, so position-only passes fetch just the first.
+	// No flags is the interleaved layout of the format with every attribute.
+	uint32_t GetVertexStride(VertexFormat format, uint32_t attributes);
+	uint32_t GetVertexStreamOffset(VertexFormat format, uint32_t attributes, size_t vertexCount);
+
+	// Rearranges vertices between two sets of attributes, either of which may be zero for the
+	// interleaved layout; attributes missing from src are zero-filled
+	void ConvertVertexStreams(VertexFormat format, uint8_t* dst, uint32_t dstAttributes, const uint8_t* src, uint32_t srcAttributes, size_t vertexCount);
+
+	enum class IndexFormat
+	{
+		UInt32 = 0,
+		UInt16,
+	};
+
+	uint32_t GetIndexSize(IndexFormat format);
+
+	// Reversible transform of the vertex and index payload applied before compression, see MeshFilter.hpp
+	enum class MeshFilter
+	{
+		None = 0,
+		DeltaShuffle,
+	};
+
 	enum class CompressionMode;
 
+	// A level of detail is a range of the shared index buffer; Error is how far, in model
+	// units, its surface may be from the full resolution mesh
+	struct MeshLod
+	{
+		uint32_t IndexOffset;
+		uint32_t IndexCount;
+		float Error;
+	};
+
 	struct MeshAssetInfo
 	{
 		std::string Name = "";
 		CompressionMode Compression;
 		VertexFormat Format;
+		IndexFormat IndexType = IndexFormat::UInt32;
+		uint32_t Attributes = 0;
+		MeshFilter Filter = MeshFilter::None;
 		uint32_t VertexBufferSize = 0;
 		uint32_t IndexBufferSize = 0;
+		int CompressionLevel = 0;
+		uint32_t BlockSize = 0;
+		uint32_t DictionaryId = 0;
+		uint64_t ContentHash = 0;
+		uint32_t MeshletCount = 0;
+		uint32_t LodCount = 0;
+		float PositionOffset[3] = { 0.0f, 0.0f, 0.0f };
+		float PositionScale[3] = { 1.0f, 1.0f, 1.0f };
 	};
 
-	struct Asset;
-
 	MeshAssetInfo ParseMeshAssetInfo(Asset* file);
+	MeshAssetInfo ParseMeshAssetInfo(const AssetView* view);
 
-	void UnpackMesh(MeshAssetInfo* info, const uint8_t* src, size_t srcSize, uint8_t* dstVbo, uint8_t* dstIbo);
-	Asset PackMesh(MeshAssetInfo* info, void* vbo, void* ibo);
+	uint32_t GetVertexCount(const MeshAssetInfo* info);
 
-}
+	// Decompresses vertex and index data back to back into dst, which must hold
+	// VertexBufferSize + IndexBufferSize bytes (e.g. a mapped staging buffer). Returns false when
+	// the payload is corrupt or its dictionary is not loaded.
+	bool UnpackMesh(MeshAssetInfo* info, const uint8_t* src, size_t srcSize, uint8_t* dst);
+	bool UnpackMesh(MeshAssetInfo* info, const uint8_t* src, size_t srcSize, uint8_t* dstVbo, uint8_t* dstIbo);
 
-namespace std
-{
+	// The meshlet and LOD tables are stored uncompressed after the vertex and index payload.
+	// Meshlets cover the first LOD only.
+	bool UnpackMeshlets(const MeshAssetInfo* info, const uint8_t* src, size_t srcSize, Meshlet* dst);
+	bool UnpackMeshLods(const MeshAssetInfo* info, const uint8_t* src, size_t srcSize, MeshLod* dst);
 
-	template<>
-	struct hash<Assets::VertexPosNorUV>
-	{
-		size_t operator()(const Assets::VertexPosNorUV& v) const
-		{
-			return ((hash<float>()(v.Position[0] + v.Position[1] + v.Position[2]) ^ (hash<float>()(v.Normal[0] + v.Normal[1] + v.Normal[2]) << 1)) >> 1) ^ (hash<float>()(v.UV[0] + v.UV[1]) << 1);
-		}
-	};
-
-	template<>
-	struct hash<Assets::VertexPosColNorUV>
-	{
-		size_t operator()(const Assets::VertexPosColNorUV& v) const
-		{
-			return ((hash<float>()(v.Position[0] + v.Position[1] + v.Position[2]) ^ (hash<float>()(v.Normal[0] + v.Normal[1] + v.Normal[2]) << 1) ^ (hash<float>()(v.Color[0] + v.Color[1] + v.Color[2]) << 2)) >> 1) ^ (hash<float>()(v.UV[0] + v.UV[1]) << 1);
-		}
-	};
+	// meshlets and lods must hold info->MeshletCount and info->LodCount entries, or be null to store none
+	Asset PackMesh(MeshAssetInfo* info, void* vbo, void* ibo, uint32_t version = AssetVersionLatest, const Meshlet* meshlets = nullptr, const MeshLod* lods = nullptr);
 
 }
\ No newline at end of file
@@ -0,0 +1,443 @@
+#include "MeshFilter.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ASSETS_FILTER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ASSETS_FILTER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Assets
+{
+
+	// Vertices decoded per SIMD iteration, four planes at a time; other strides use the scalar loop
+	static constexpr size_t FilterTile = 16;
+	static constexpr size_t MaxSimdStride = 64;
+
+	void EncodeVertexStream(uint8_t* dst, const uint8_t* src, size_t vertexCount, size_t stride)
+	{
+		for (size_t k = 0; k < stride; k++)
+		{
+			uint8_t* plane = dst + k * vertexCount;
+			uint8_t previous = 0;
+
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				const uint8_t value = src[v * stride + k];
+
+				plane[v] = value - previous;
+				previous = value;
+			}
+		}
+	}
+
+	static void DecodeVertexStreamScalar(uint8_t* dst, const uint8_t* src, size_t first, size_t vertexCount, size_t stride, const uint8_t* previous)
+	{
+		for (size_t k = 0; k < stride; k++)
+		{
+			const uint8_t* plane = src + k * vertexCount;
+			uint8_t value = previous != nullptr ? previous[k] : 0;
+
+			for (size_t v = first; v < vertexCount; v++)
+			{
+				value += plane[v];
+				dst[v * stride + k] = value;
+			}
+		}
+	}
+
+#if defined(ASSETS_FILTER_SSE2)
+
+	static inline __m128i PrefixSum8(__m128i x)
+	{
+		x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+		x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+		x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+
+		return _mm_add_epi8(x, _mm_slli_si128(x, 8));
+	}
+
+	static inline __m128i BroadcastLast8(__m128i x)
+	{
+		x = _mm_unpackhi_epi8(x, x);
+		x = _mm_shufflehi_epi16(x, 0xff);
+
+		return _mm_shuffle_epi32(x, 0xff);
+	}
+
+	// Returns how many vertices were decoded, previous receives the last byte of every plane
+	static size_t DecodeVertexStreamSimd(uint8_t* dst, const uint8_t* src, size_t vertexCount, size_t stride, uint8_t* previous)
+	{
+		if (stride % 4 != 0 || stride > MaxSimdStride) return 0;
+
+		__m128i carry[MaxSimdStride];
+
+		for (size_t k = 0; k < stride; k++)
+			carry[k] = _mm_setzero_si128();
+
+		const size_t tiles = vertexCount / FilterTile * FilterTile;
+		alignas(16) uint8_t lanes[FilterTile * 4];
+
+		for (size_t v = 0; v < tiles; v += FilterTile)
+		{
+			uint8_t* out = dst + v * stride;
+
+			for (size_t k = 0; k < stride; k += 4)
+			{
+				__m128i p[4];
+
+				for (size_t j = 0; j < 4; j++)
+				{
+					const __m128i x = _mm_loadu_si128((const __m128i*)(src + (k + j) * vertexCount + v));
+
+					p[j] = _mm_add_epi8(PrefixSum8(x), carry[k + j]);
+					carry[k + j] = BroadcastLast8(p[j]);
+				}
+
+				// Four planes of 16 bytes become 16 vertices of four bytes
+				const __m128i a = _mm_unpacklo_epi8(p[0], p[1]), b = _mm_unpackhi_epi8(p[0], p[1]);
+				const __m128i c = _mm_unpacklo_epi8(p[2], p[3]), d = _mm_unpackhi_epi8(p[2], p[3]);
+
+				const __m128i w[4] = { _mm_unpacklo_epi16(a, c), _mm_unpackhi_epi16(a, c), _mm_unpacklo_epi16(b, d), _mm_unpackhi_epi16(b, d) };
+
+				if (stride == 4)
+				{
+					for (size_t i = 0; i < 4; i++)
+						_mm_storeu_si128((__m128i*)(out + i * 16), w[i]);
+
+					continue;
+				}
+
+				for (size_t i = 0; i < 4; i++)
+					_mm_store_si128((__m128i*)(lanes + i * 16), w[i]);
+
+				for (size_t i = 0; i < FilterTile; i++)
+					memcpy(out + i * stride + k, lanes + i * 4, 4);
+			}
+		}
+
+		for (size_t k = 0; k < stride; k++)
+			previous[k] = (uint8_t)_mm_cvtsi128_si32(carry[k]);
+
+		return tiles;
+	}
+
+#elif defined(ASSETS_FILTER_NEON)
+
+	static inline uint8x16_t PrefixSum8(uint8x16_t x)
+	{
+		const uint8x16_t zero = vdupq_n_u8(0);
+
+		x = vaddq_u8(x, vextq_u8(zero, x, 15));
+		x = vaddq_u8(x, vextq_u8(zero, x, 14));
+		x = vaddq_u8(x, vextq_u8(zero, x, 12));
+
+		return vaddq_u8(x, vextq_u8(zero, x, 8));
+	}
+
+	static size_t DecodeVertexStreamSimd(uint8_t* dst, const uint8_t* src, size_t vertexCount, size_t stride, uint8_t* previous)
+	{
+		if (stride % 4 != 0 || stride > MaxSimdStride) return 0;
+
+		uint8x16_t carry[MaxSimdStride];
+
+		for (size_t k = 0; k < stride; k++)
+			carry[k] = vdupq_n_u8(0);
+
+		const size_t tiles = vertexCount / FilterTile * FilterTile;
+		alignas(16) uint8_t lanes[FilterTile * 4];
+
+		for (size_t v = 0; v < tiles; v += FilterTile)
+		{
+			uint8_t* out = dst + v * stride;
+
+			for (size_t k = 0; k < stride; k += 4)
+			{
+				uint8x16x4_t p;
+
+				for (size_t j = 0; j < 4; j++)
+				{
+					p.val[j] = vaddq_u8(PrefixSum8(vld1q_u8(src + (k + j) * vertexCount + v)), carry[k + j]);
+					carry[k + j] = vdupq_n_u8(vgetq_lane_u8(p.val[j], 15));
+				}
+
+				// The interleaving store writes 16 vertices of four bytes
+				if (stride == 4)
+				{
+					vst4q_u8(out, p);
+					continue;
+				}
+
+				vst4q_u8(lanes, p);
+
+				for (size_t i = 0; i < FilterTile; i++)
+					memcpy(out + i * stride + k, lanes + i * 4, 4);
+			}
+		}
+
+		for (size_t k = 0; k < stride; k++)
+			previous[k] = vgetq_lane_u8(carry[k], 0);
+
+		return tiles;
+	}
+
+#endif
+
+	void DecodeVertexStream(uint8_t* dst, const uint8_t* src, size_t vertexCount, size_t stride)
+	{
+#if defined(ASSETS_FILTER_SSE2) || defined(ASSETS_FILTER_NEON)
+		uint8_t previous[MaxSimdStride];
+		const size_t decoded = DecodeVertexStreamSimd(dst, src, vertexCount, stride, previous);
+
+		if (decoded > 0)
+		{
+			DecodeVertexStreamScalar(dst, src, decoded, vertexCount, stride, previous);
+			return;
+		}
+#endif
+
+		DecodeVertexStreamScalar(dst, src, 0, vertexCount, stride, nullptr);
+	}
+
+	template<typename T>
+	static void EncodeDeltas(T* dst, const T* src, size_t count)
+	{
+		T previous = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const T delta = (T)(src[i] - previous);
+			const T sign = (T)(delta >> (sizeof(T) * 8 - 1));
+
+			dst[i] = (T)((T)(delta << 1) ^ (T)(0 - sign));
+			previous = src[i];
+		}
+	}
+
+	template<typename T>
+	static void DecodeDeltas(T* dst, const T* src, size_t first, size_t count, T previous)
+	{
+		for (size_t i = first; i < count; i++)
+		{
+			const T delta = (T)((src[i] >> 1) ^ (T)(0 - (src[i] & 1)));
+
+			previous = (T)(previous + delta);
+			dst[i] = previous;
+		}
+	}
+
+#if defined(ASSETS_FILTER_SSE2)
+
+	static size_t DecodeDeltasSimd(uint16_t* dst, const uint16_t* src, size_t count, uint16_t& previous)
+	{
+		const __m128i one = _mm_set1_epi16(1);
+		__m128i carry = _mm_setzero_si128();
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+			x = _mm_xor_si128(_mm_srli_epi16(x, 1), _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(x, one)));
+
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi16(x, carry);
+
+			_mm_storeu_si128((__m128i*)(dst + i), x);
+			carry = _mm_shuffle_epi32(_mm_shufflehi_epi16(x, 0xff), 0xff);
+		}
+
+		previous = (uint16_t)_mm_cvtsi128_si32(carry);
+		return i;
+	}
+
+	static size_t DecodeDeltasSimd(uint32_t* dst, const uint32_t* src, size_t count, uint32_t& previous)
+	{
+		const __m128i one = _mm_set1_epi32(1);
+		__m128i carry = _mm_setzero_si128();
+		size_t i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+			x = _mm_xor_si128(_mm_srli_epi32(x, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(x, one)));
+
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi32(x, carry);
+
+			_mm_storeu_si128((__m128i*)(dst + i), x);
+			carry = _mm_shuffle_epi32(x, 0xff);
+		}
+
+		previous = (uint32_t)_mm_cvtsi128_si32(carry);
+		return i;
+	}
+
+#elif defined(ASSETS_FILTER_NEON)
+
+	static size_t DecodeDeltasSimd(uint16_t* dst, const uint16_t* src, size_t count, uint16_t& previous)
+	{
+		const uint16x8_t zero = vdupq_n_u16(0);
+		uint16x8_t carry = zero;
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			uint16x8_t x = vld1q_u16(src + i);
+			x = veorq_u16(vshrq_n_u16(x, 1), vsubq_u16(zero, vandq_u16(x, vdupq_n_u16(1))));
+
+			x = vaddq_u16(x, vextq_u16(zero, x, 7));
+			x = vaddq_u16(x, vextq_u16(zero, x, 6));
+			x = vaddq_u16(x, vextq_u16(zero, x, 4));
+			x = vaddq_u16(x, carry);
+
+			vst1q_u16(dst + i, x);
+			carry = vdupq_n_u16(vgetq_lane_u16(x, 7));
+		}
+
+		previous = vgetq_lane_u16(carry, 0);
+		return i;
+	}
+
+	static size_t DecodeDeltasSimd(uint32_t* dst, const uint32_t* src, size_t count, uint32_t& previous)
+	{
+		const uint32x4_t zero = vdupq_n_u32(0);
+		uint32x4_t carry = zero;
+		size_t i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			uint32x4_t x = vld1q_u32(src + i);
+			x = veorq_u32(vshrq_n_u32(x, 1), vsubq_u32(zero, vandq_u32(x, vdupq_n_u32(1))));
+
+			x = vaddq_u32(x, vextq_u32(zero, x, 3));
+			x = vaddq_u32(x, vextq_u32(zero, x, 2));
+			x = vaddq_u32(x, carry);
+
+			vst1q_u32(dst + i, x);
+			carry = vdupq_n_u32(vgetq_lane_u32(x, 3));
+		}
+
+		previous = vgetq_lane_u32(carry, 0);
+		return i;
+	}
+
+#endif
+
+	void EncodeIndexDeltas(uint8_t* dst, const uint8_t* src, size_t indexCount, IndexFormat format)
+	{
+		if (format == IndexFormat::UInt16)
+			EncodeDeltas((uint16_t*)dst, (const uint16_t*)src, indexCount);
+
+		else
+			EncodeDeltas((uint32_t*)dst, (const uint32_t*)src, indexCount);
+	}
+
+	template<typename T>
+	static void DecodeIndexDeltas(T* dst, const T* src, size_t indexCount)
+	{
+		T previous = 0;
+		size_t first = 0;
+
+#if defined(ASSETS_FILTER_SSE2) || defined(ASSETS_FILTER_NEON)
+		first = DecodeDeltasSimd(dst, src, indexCount, previous);
+#endif
+
+		DecodeDeltas(dst, src, first, indexCount, previous);
+	}
+
+	void DecodeIndexDeltas(uint8_t* dst, const uint8_t* src, size_t indexCount, IndexFormat format)
+	{
+		if (format == IndexFormat::UInt16)
+			DecodeIndexDeltas((uint16_t*)dst, (const uint16_t*)src, indexCount);
+
+		else
+			DecodeIndexDeltas((uint32_t*)dst, (const uint32_t*)src, indexCount);
+	}
+
+	// The vertex buffer is one interleaved stream, or the positions followed by the other attributes
+	static uint32_t GetVertexStreams(const MeshAssetInfo* info, size_t& vertexCount, size_t strides[2])
+	{
+		vertexCount = GetVertexCount(info);
+
+		if (info->Attributes == 0)
+		{
+			strides[0] = GetVertexSize(info->Format);
+			return 1;
+		}
+
+		strides[0] = GetVertexStride(info->Format, info->Attributes & VertexAttributePosition);
+		strides[1] = GetVertexStride(info->Format, info->Attributes & ~VertexAttributePosition);
+
+		return strides[1] > 0 ? 2 : 1;
+	}
+
+	void EncodeMeshFilter(const MeshAssetInfo* info, const uint8_t* vbo, const uint8_t* ibo, uint8_t* dst)
+	{
+		if (info->Filter == MeshFilter::None)
+		{
+			memcpy(dst, vbo, info->VertexBufferSize);
+			memcpy(dst + info->VertexBufferSize, ibo, info->IndexBufferSize);
+			return;
+		}
+
+		size_t vertexCount, strides[2];
+		const uint32_t streams = GetVertexStreams(info, vertexCount, strides);
+
+		size_t offset = 0;
+
+		for (uint32_t s = 0; s < streams; s++)
+		{
+			EncodeVertexStream(dst + offset, vbo + offset, vertexCount, strides[s]);
+			offset += vertexCount * strides[s];
+		}
+
+		// Whatever no stream covers, such as an unknown vertex format, is stored as is
+		memcpy(dst + offset, vbo + offset, info->VertexBufferSize - offset);
+
+		const size_t indexSize = GetIndexSize(info->IndexType);
+		const size_t indexCount = info->IndexBufferSize / indexSize;
+
+		dst += info->VertexBufferSize;
+
+		EncodeIndexDeltas(dst, ibo, indexCount, info->IndexType);
+		memcpy(dst + indexCount * indexSize, ibo + indexCount * indexSize, info->IndexBufferSize - indexCount * indexSize);
+	}
+
+	void DecodeMeshFilter(const MeshAssetInfo* info, const uint8_t* src, uint8_t* dst)
+	{
+		if (info->Filter == MeshFilter::None)
+		{
+			memcpy(dst, src, info->VertexBufferSize + info->IndexBufferSize);
+			return;
+		}
+
+		size_t vertexCount, strides[2];
+		const uint32_t streams = GetVertexStreams(info, vertexCount, strides);
+
+		size_t offset = 0;
+
+		for (uint32_t s = 0; s < streams; s++)
+		{
+			DecodeVertexStream(dst + offset, src + offset, vertexCount, strides[s]);
+			offset += vertexCount * strides[s];
+		}
+
+		memcpy(dst + offset, src + offset, info->VertexBufferSize - offset);
+
+		const size_t indexSize = GetIndexSize(info->IndexType);
+		const size_t indexCount = info->IndexBufferSize / indexSize;
+
+		src += info->VertexBufferSize;
+		dst += info->VertexBufferSize;
+
+		DecodeIndexDeltas(dst, src, indexCount, info->IndexType);
+		memcpy(dst + indexCount * indexSize, src + indexCount * indexSize, info->IndexBufferSize - indexCount * indexSize);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "MeshAsset.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Assets
+{
+
+	// Transposes a stream of vertexCount elements of stride bytes into stride planes of one byte
+	// per vertex and replaces every byte with its difference to the previous one in the plane.
+	// Bytes of the same attribute component then sit together and slowly varying ones turn into
+	// runs of small values, which LZ4 matches far better than interleaved floats.
+	void EncodeVertexStream(uint8_t* dst, const uint8_t* src, size_t vertexCount, size_t stride);
+	void DecodeVertexStream(uint8_t* dst, const uint8_t* src, size_t vertexCount, size_t stride);
+
+	// Replaces every index with the zigzag encoded difference to the previous one, in the same width
+	void EncodeIndexDeltas(uint8_t* dst, const uint8_t* src, size_t indexCount, IndexFormat format);
+	void DecodeIndexDeltas(uint8_t* dst, const uint8_t* src, size_t indexCount, IndexFormat format);
+
+	// Applies info->Filter to every vertex stream and the index buffer. The output keeps the
+	// layout and size of the raw payload (VertexBufferSize + IndexBufferSize bytes), and
+	// MeshFilter::None just copies it.
+	void EncodeMeshFilter(const MeshAssetInfo* info, const uint8_t* vbo, const uint8_t* ibo, uint8_t* dst);
+	void DecodeMeshFilter(const MeshAssetInfo* info, const uint8_t* src, uint8_t* dst);
+
+}
\ No newline at end of file
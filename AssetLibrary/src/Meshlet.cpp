@@ -0,0 +1,187 @@
+#include "Meshlet.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace Assets
+{
+
+	static const float* GetPosition(const float* positions, size_t vertexStride, uint32_t index)
+	{
+		return (const float*)((const uint8_t*)positions + index * vertexStride);
+	}
+
+	static float Dot(const float* a, const float* b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	static bool Normalize(float* v)
+	{
+		const float length = std::sqrt(Dot(v, v));
+
+		if (length == 0.0f) return false;
+
+		v[0] /= length; v[1] /= length; v[2] /= length;
+
+		return true;
+	}
+
+	static void ComputeMeshletBounds(Meshlet& meshlet, const uint32_t* indices, const float* positions, size_t vertexStride)
+	{
+		// Bounding box centre, then the farthest corner from it
+		float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (uint32_t i = 0; i < meshlet.IndexCount; i++)
+		{
+			const float* p = GetPosition(positions, vertexStride, indices[meshlet.IndexOffset + i]);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				minimum[k] = std::min(minimum[k], p[k]);
+				maximum[k] = std::max(maximum[k], p[k]);
+			}
+		}
+
+		float radius = 0.0f;
+
+		for (uint32_t k = 0; k < 3; k++)
+			meshlet.Center[k] = (minimum[k] + maximum[k]) * 0.5f;
+
+		for (uint32_t i = 0; i < meshlet.IndexCount; i++)
+		{
+			const float* p = GetPosition(positions, vertexStride, indices[meshlet.IndexOffset + i]);
+			const float d[3] = { p[0] - meshlet.Center[0], p[1] - meshlet.Center[1], p[2] - meshlet.Center[2] };
+
+			radius = std::max(radius, Dot(d, d));
+		}
+
+		meshlet.Radius = std::sqrt(radius);
+
+		// Normal cone: the cutoff stays at 1 (never culled) unless every triangle faces
+		// within 90 degrees of the average normal
+		const uint32_t triangleCount = meshlet.IndexCount / 3;
+
+		std::vector<float> normals(triangleCount * 3);
+		float axis[3] = {};
+
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const uint32_t* tri = indices + meshlet.IndexOffset + t * 3;
+
+			const float* p0 = GetPosition(positions, vertexStride, tri[0]);
+			const float* p1 = GetPosition(positions, vertexStride, tri[1]);
+			const float* p2 = GetPosition(positions, vertexStride, tri[2]);
+
+			const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+			float* n = &normals[t * 3];
+			n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+			n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+			n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+
+			if (!Normalize(n)) continue;
+
+			axis[0] += n[0]; axis[1] += n[1]; axis[2] += n[2];
+		}
+
+		memset(meshlet.ConeApex, 0, sizeof(meshlet.ConeApex));
+		memset(meshlet.ConeAxis, 0, sizeof(meshlet.ConeAxis));
+		meshlet.ConeCutoff = 1.0f;
+
+		if (!Normalize(axis)) return;
+
+		float minDot = 1.0f;
+
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const float* n = &normals[t * 3];
+			if (Dot(n, n) > 0.0f) minDot = std::min(minDot, Dot(n, axis));
+		}
+
+		if (minDot <= 0.0f) return;
+
+		// Move the apex back along the axis until every triangle plane lies in front of it
+		float maxDistance = 0.0f;
+
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const float* n = &normals[t * 3];
+			const float* p0 = GetPosition(positions, vertexStride, indices[meshlet.IndexOffset + t * 3]);
+			const float d[3] = { meshlet.Center[0] - p0[0], meshlet.Center[1] - p0[1], meshlet.Center[2] - p0[2] };
+
+			if (Dot(n, n) > 0.0f) maxDistance = std::max(maxDistance, Dot(d, n) / Dot(axis, n));
+		}
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			meshlet.ConeApex[k] = meshlet.Center[k] - axis[k] * maxDistance;
+			meshlet.ConeAxis[k] = axis[k];
+		}
+
+		meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+
+	void BuildMeshlets(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride, std::vector<Meshlet>& meshlets)
+	{
+		meshlets.clear();
+
+		// Which meshlet last used each vertex, to count unique vertices without clearing
+		std::vector<uint32_t> usedBy(vertexCount, ~0u);
+		Meshlet current = {};
+
+		const auto flush = [&]()
+		{
+			if (current.IndexCount == 0) return;
+
+			ComputeMeshletBounds(current, indices, positions, vertexStride);
+			meshlets.push_back(current);
+
+			current = {};
+			current.IndexOffset = meshlets.back().IndexOffset + meshlets.back().IndexCount;
+		};
+
+		for (size_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			const uint32_t id = (uint32_t)meshlets.size();
+			uint32_t added = 0;
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				if (usedBy[indices[i + k]] != id && (k < 1 || indices[i + k] != indices[i]) && (k < 2 || indices[i + k] != indices[i + 1]))
+					added++;
+			}
+
+			if (current.VertexCount + added > MeshletMaxVertices || current.IndexCount / 3 + 1 > MeshletMaxTriangles)
+				flush();
+
+			const uint32_t target = (uint32_t)meshlets.size();
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				if (usedBy[indices[i + k]] != target)
+				{
+					usedBy[indices[i + k]] = target;
+					current.VertexCount++;
+				}
+			}
+
+			current.IndexCount += 3;
+		}
+
+		flush();
+	}
+
+	bool IsMeshletBackfacing(const Meshlet& meshlet, const float cameraPosition[3])
+	{
+		float view[3] = { meshlet.ConeApex[0] - cameraPosition[0], meshlet.ConeApex[1] - cameraPosition[1], meshlet.ConeApex[2] - cameraPosition[2] };
+
+		if (!Normalize(view)) return false;
+
+		return Dot(view, meshlet.ConeAxis) >= meshlet.ConeCutoff;
+	}
+
+}
\ No newline at end of file
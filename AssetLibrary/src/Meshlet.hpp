@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Assets
+{
+
+	static const uint32_t MeshletMaxVertices = 64;
+	static const uint32_t MeshletMaxTriangles = 124;
+
+	// A cluster of at most MeshletMaxTriangles triangles referencing at most
+	// MeshletMaxVertices vertices, drawn as IndexCount indices from IndexOffset in the
+	// mesh index buffer. Center and Radius bound it; it faces away from a camera at
+	// position p when dot(normalize(ConeApex - p), ConeAxis) >= ConeCutoff.
+	struct Meshlet
+	{
+		uint32_t IndexOffset;
+		uint32_t IndexCount;
+		uint32_t VertexCount;
+		float Center[3];
+		float Radius;
+		float ConeApex[3];
+		float ConeAxis[3];
+		float ConeCutoff;
+	};
+
+	// Splits the index buffer, in its current order, into meshlets of contiguous triangles,
+	// so run it after any triangle reordering. positions points at the first vertex
+	// position (three floats), vertexStride is in bytes.
+	void BuildMeshlets(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride, std::vector<Meshlet>& meshlets);
+
+	bool IsMeshletBackfacing(const Meshlet& meshlet, const float cameraPosition[3]);
+
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "Metadata.hpp"
+
+#include <algorithm>
+
+namespace Assets
+{
+
+	void MetadataWriter::WriteString(const std::string& str)
+	{
+		const uint32_t length = str.size();
+
+		Write(length);
+		m_Data.append(str);
+	}
+
+	bool MetadataReader::ReadHeader(void* header, uint32_t size)
+	{
+		uint32_t storedSize = 0;
+
+		if (m_Offset + sizeof(uint32_t) > m_Data.size()) return false;
+		memcpy(&storedSize, m_Data.data() + m_Offset, sizeof(uint32_t));
+
+		if (storedSize < sizeof(uint32_t) || m_Offset + storedSize > m_Data.size()) return false;
+
+		memset(header, 0, size);
+		memcpy(header, m_Data.data() + m_Offset, std::min(storedSize, size));
+
+		m_Offset += storedSize;
+
+		return true;
+	}
+
+	bool MetadataReader::ReadString(std::string& str)
+	{
+		uint32_t length = 0;
+
+		if (!Read(length)) return false;
+		if (m_Offset + length > m_Data.size()) return false;
+
+		str.assign(m_Data.data() + m_Offset, length);
+		m_Offset += length;
+
+		return true;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+
+namespace Assets
+{
+
+	// Serializes the fixed-layout binary metadata block used by asset versions >= 2.
+	// Every block starts with a POD header whose first member is its own size, so newer
+	// readers can zero-fill fields that older files do not carry.
+	class MetadataWriter
+	{
+	public:
+		template<typename T>
+		void Write(const T& value)
+		{
+			m_Data.append((const char*)&value, sizeof(T));
+		}
+
+		void WriteString(const std::string& str);
+
+		inline std::string& Data() { return m_Data; }
+
+	private:
+		std::string m_Data = "";
+	};
+
+	class MetadataReader
+	{
+	public:
+		MetadataReader(std::string_view data) : m_Data(data) {}
+
+		template<typename T>
+		bool Read(T& value)
+		{
+			if (m_Offset + sizeof(T) > m_Data.size()) return false;
+
+			memcpy(&value, m_Data.data() + m_Offset, sizeof(T));
+			m_Offset += sizeof(T);
+
+			return true;
+		}
+
+		bool ReadHeader(void* header, uint32_t size);
+		bool ReadString(std::string& str);
+
+	private:
+		std::string_view m_Data = {};
+		size_t m_Offset = 0;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,382 @@
+#include "MipChain.hpp"
+#include "BlockCompression.hpp"
+#include "VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ASSETS_MIPS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ASSETS_MIPS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Assets
+{
+
+	// Fine enough that the darkest steps, where the sRGB curve is steepest, still round correctly
+	static constexpr uint32_t EncodeTableSize = 1 << 14;
+
+	struct ColorTables
+	{
+		float Decode[256];
+		uint8_t Encode[EncodeTableSize];
+
+		ColorTables(bool srgb)
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				const float c = i / 255.0f;
+
+				if (!srgb) Decode[i] = c;
+				else Decode[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+
+			for (uint32_t i = 0; i < EncodeTableSize; i++)
+			{
+				const float l = i / (float)(EncodeTableSize - 1);
+				float c = l;
+
+				if (srgb) c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+
+				Encode[i] = (uint8_t)(c * 255.0f + 0.5f);
+			}
+		}
+	};
+
+	static const ColorTables& GetColorTables(bool srgb)
+	{
+		static const ColorTables srgbTables(true), linearTables(false);
+		return srgb ? srgbTables : linearTables;
+	}
+
+#if defined(ASSETS_MIPS_SSE2)
+
+	typedef __m128 Texel;
+
+	static inline Texel LoadTexel(const float* p)
+	{
+		return _mm_loadu_ps(p);
+	}
+
+	static inline void StoreTexel(float* p, Texel t)
+	{
+		_mm_storeu_ps(p, t);
+	}
+
+	static inline Texel AddTexel(Texel a, Texel b)
+	{
+		return _mm_add_ps(a, b);
+	}
+
+	static inline Texel ScaleTexel(Texel t, float s)
+	{
+		return _mm_mul_ps(t, _mm_set1_ps(s));
+	}
+
+#elif defined(ASSETS_MIPS_NEON)
+
+	typedef float32x4_t Texel;
+
+	static inline Texel LoadTexel(const float* p)
+	{
+		return vld1q_f32(p);
+	}
+
+	static inline void StoreTexel(float* p, Texel t)
+	{
+		vst1q_f32(p, t);
+	}
+
+	static inline Texel AddTexel(Texel a, Texel b)
+	{
+		return vaddq_f32(a, b);
+	}
+
+	static inline Texel ScaleTexel(Texel t, float s)
+	{
+		return vmulq_n_f32(t, s);
+	}
+
+#else
+
+	struct Texel
+	{
+		float V[4];
+	};
+
+	static inline Texel LoadTexel(const float* p)
+	{
+		return { { p[0], p[1], p[2], p[3] } };
+	}
+
+	static inline void StoreTexel(float* p, Texel t)
+	{
+		memcpy(p, t.V, sizeof(t.V));
+	}
+
+	static inline Texel AddTexel(Texel a, Texel b)
+	{
+		return { { a.V[0] + b.V[0], a.V[1] + b.V[1], a.V[2] + b.V[2], a.V[3] + b.V[3] } };
+	}
+
+	static inline Texel ScaleTexel(Texel t, float s)
+	{
+		return { { t.V[0] * s, t.V[1] * s, t.V[2] * s, t.V[3] * s } };
+	}
+
+#endif
+
+	static uint8_t EncodeUnorm8(float value)
+	{
+		return (uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	static uint8_t EncodeColor(float value, const ColorTables& tables)
+	{
+		return tables.Encode[(uint32_t)(std::clamp(value, 0.0f, 1.0f) * (EncodeTableSize - 1) + 0.5f)];
+	}
+
+	// Expands one row of format into linear RGBA floats; channels the format lacks read as zero,
+	// alpha as one. The second channel of RG8 is alpha, so only the first goes through the tables.
+	static void DecodeRow(float* dst, const uint8_t* src, uint32_t width, TextureFormat format, const ColorTables& tables)
+	{
+		switch (format)
+		{
+			case TextureFormat::R8:
+				for (uint32_t x = 0; x < width; x++)
+				{
+					dst[x * 4 + 0] = tables.Decode[src[x]];
+					dst[x * 4 + 1] = dst[x * 4 + 2] = 0.0f;
+					dst[x * 4 + 3] = 1.0f;
+				}
+
+				break;
+
+			case TextureFormat::RG8:
+				for (uint32_t x = 0; x < width; x++)
+				{
+					dst[x * 4 + 0] = tables.Decode[src[x * 2 + 0]];
+					dst[x * 4 + 1] = src[x * 2 + 1] / 255.0f;
+					dst[x * 4 + 2] = 0.0f;
+					dst[x * 4 + 3] = 1.0f;
+				}
+
+				break;
+
+			case TextureFormat::R16:
+				for (uint32_t x = 0; x < width; x++)
+				{
+					uint16_t value;
+					memcpy(&value, src + x * 2, sizeof(value));
+
+					dst[x * 4 + 0] = value / 65535.0f;
+					dst[x * 4 + 1] = dst[x * 4 + 2] = 0.0f;
+					dst[x * 4 + 3] = 1.0f;
+				}
+
+				break;
+
+			case TextureFormat::RGBA16F:
+				for (uint32_t x = 0; x < width * 4; x++)
+				{
+					uint16_t value;
+					memcpy(&value, src + x * 2, sizeof(value));
+
+					dst[x] = DecodeHalf(value);
+				}
+
+				break;
+
+			default:
+				for (uint32_t x = 0; x < width; x++)
+				{
+					dst[x * 4 + 0] = tables.Decode[src[x * 4 + 0]];
+					dst[x * 4 + 1] = tables.Decode[src[x * 4 + 1]];
+					dst[x * 4 + 2] = tables.Decode[src[x * 4 + 2]];
+					dst[x * 4 + 3] = src[x * 4 + 3] / 255.0f;
+				}
+
+				break;
+		}
+	}
+
+	static void EncodeRow(uint8_t* dst, const float* src, uint32_t width, TextureFormat format, const ColorTables& tables)
+	{
+		switch (format)
+		{
+			case TextureFormat::R8:
+				for (uint32_t x = 0; x < width; x++)
+					dst[x] = EncodeColor(src[x * 4], tables);
+
+				break;
+
+			case TextureFormat::RG8:
+				for (uint32_t x = 0; x < width; x++)
+				{
+					dst[x * 2 + 0] = EncodeColor(src[x * 4 + 0], tables);
+					dst[x * 2 + 1] = EncodeUnorm8(src[x * 4 + 1]);
+				}
+
+				break;
+
+			case TextureFormat::R16:
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const uint16_t value = (uint16_t)(std::clamp(src[x * 4], 0.0f, 1.0f) * 65535.0f + 0.5f);
+					memcpy(dst + x * 2, &value, sizeof(value));
+				}
+
+				break;
+
+			case TextureFormat::RGBA16F:
+				for (uint32_t x = 0; x < width * 4; x++)
+				{
+					const uint16_t value = EncodeHalf(src[x]);
+					memcpy(dst + x * 2, &value, sizeof(value));
+				}
+
+				break;
+
+			default:
+				for (uint32_t x = 0; x < width; x++)
+				{
+					for (uint32_t c = 0; c < 3; c++)
+						dst[x * 4 + c] = EncodeColor(src[x * 4 + c], tables);
+
+					dst[x * 4 + 3] = EncodeUnorm8(src[x * 4 + 3]);
+				}
+
+				break;
+		}
+	}
+
+	// Averages rowCount linear source rows of srcWidth texels into one row of dstWidth texels
+	static void DownsampleRow(float* dst, const float* const* rows, uint32_t rowCount, uint32_t srcWidth, uint32_t dstWidth)
+	{
+		if (srcWidth == 1)
+		{
+			Texel sum = LoadTexel(rows[0]);
+
+			for (uint32_t r = 1; r < rowCount; r++)
+				sum = AddTexel(sum, LoadTexel(rows[r]));
+
+			StoreTexel(dst, ScaleTexel(sum, 1.0f / rowCount));
+			return;
+		}
+
+		// Halving an odd width leaves the last texel covering three columns
+		const uint32_t pairs = (srcWidth & 1) != 0 ? dstWidth - 1 : dstWidth;
+		const float weight = 1.0f / (2 * rowCount);
+
+		for (uint32_t x = 0; x < pairs; x++)
+		{
+			Texel sum = AddTexel(LoadTexel(rows[0] + x * 8), LoadTexel(rows[0] + x * 8 + 4));
+
+			for (uint32_t r = 1; r < rowCount; r++)
+				sum = AddTexel(sum, AddTexel(LoadTexel(rows[r] + x * 8), LoadTexel(rows[r] + x * 8 + 4)));
+
+			StoreTexel(dst + x * 4, ScaleTexel(sum, weight));
+		}
+
+		if (pairs == dstWidth) return;
+
+		Texel sum = LoadTexel(rows[0] + pairs * 8);
+
+		for (uint32_t r = 0; r < rowCount; r++)
+		{
+			for (uint32_t c = r == 0 ? 1 : 0; c < 3; c++)
+				sum = AddTexel(sum, LoadTexel(rows[r] + (pairs * 2 + c) * 4));
+		}
+
+		StoreTexel(dst + pairs * 4, ScaleTexel(sum, 1.0f / (3 * rowCount)));
+	}
+
+	uint32_t GetMipLevelCount(uint32_t width, uint32_t height)
+	{
+		uint32_t levels = 1;
+
+		for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+			levels++;
+
+		return levels;
+	}
+
+	void GenerateMipChain(TextureFormat format, const uint8_t* src, uint32_t width, uint32_t height, std::vector<uint8_t>& dst, std::vector<TextureMip>& mips, bool srgb)
+	{
+		const uint32_t levels = GetMipLevelCount(width, height);
+		const size_t texelBytes = GetTexelBytes(format);
+		uint64_t offset = 0;
+
+		mips.resize(levels);
+
+		for (uint32_t i = 0; i < levels; i++)
+		{
+			const uint32_t w = std::max(width >> i, 1u);
+			const uint32_t h = std::max(height >> i, 1u);
+
+			// Buffer to image copies want every level on a four byte boundary, which only the small
+			// levels of one and two byte formats would otherwise miss
+			offset = (offset + 3) & ~(uint64_t)3;
+
+			mips[i] = { offset, (uint64_t)w * h * texelBytes, w, h };
+			offset += mips[i].Size;
+		}
+
+		dst.assign(offset, 0);
+		memcpy(dst.data(), src, mips[0].Size);
+
+		const bool color = format == TextureFormat::RGBA8 || format == TextureFormat::R8 || format == TextureFormat::RG8;
+		const ColorTables& tables = GetColorTables(srgb && color);
+
+		// The base level is decoded a few rows at a time, smaller ones stay linear for the next level
+		std::vector<float> decoded((size_t)width * 4 * 3);
+		std::vector<float> previous, current;
+
+		for (uint32_t level = 1; level < levels; level++)
+		{
+			const TextureMip& above = mips[level - 1];
+			const TextureMip& mip = mips[level];
+
+			current.resize((size_t)mip.Width * mip.Height * 4);
+
+			for (uint32_t y = 0; y < mip.Height; y++)
+			{
+				const uint32_t first = above.Height > 1 ? y * 2 : 0;
+				uint32_t rowCount = above.Height > 1 ? 2 : 1;
+
+				if (above.Height > 1 && (above.Height & 1) != 0 && y == mip.Height - 1)
+					rowCount = 3;
+
+				const float* rows[3];
+
+				for (uint32_t r = 0; r < rowCount; r++)
+				{
+					const size_t row = first + r;
+
+					if (level == 1)
+					{
+						float* decodedRow = decoded.data() + (size_t)r * width * 4;
+
+						DecodeRow(decodedRow, src + row * width * texelBytes, width, format, tables);
+						rows[r] = decodedRow;
+					}
+
+					else
+						rows[r] = previous.data() + row * above.Width * 4;
+				}
+
+				float* linear = current.data() + (size_t)y * mip.Width * 4;
+
+				DownsampleRow(linear, rows, rowCount, above.Width, mip.Width);
+				EncodeRow(dst.data() + mip.Offset + y * mip.Width * texelBytes, linear, mip.Width, format, tables);
+			}
+
+			std::swap(previous, current);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "TextureAsset.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Assets
+{
+
+	// Number of levels in a full chain down to 1x1
+	uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+
+	// Writes every level of an image in an uncompressed format (RGBA8, R8, RG8, R16 or RGBA16F)
+	// into dst, starting with a copy of src, and describes them in mips. Each level is a box filter
+	// of the one above. For sRGB RGBA8, R8 and RG8 images color is averaged in linear space and
+	// alpha (the second channel of RG8) directly, so dark and bright texels keep their weight; R16,
+	// RGBA16F and non-sRGB images (e.g. normal maps) are averaged as stored. An odd row or column
+	// count folds the last three source texels into the last one of the level.
+	void GenerateMipChain(TextureFormat format, const uint8_t* src, uint32_t width, uint32_t height, std::vector<uint8_t>& dst, std::vector<TextureMip>& mips, bool srgb = true);
+
+}
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "Overdraw.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace Assets
+{
+
+	static const uint32_t OverdrawGridSize = 256;
+	static const uint32_t ClusterCacheSize = 16;
+
+	static const float* GetPosition(const float* positions, size_t vertexStride, uint32_t index)
+	{
+		return (const float*)((const uint8_t*)positions + index * vertexStride);
+	}
+
+	static void RasterizeTriangle(const float* a, const float* b, const float* c, std::vector<float>& depth, OverdrawStats& stats)
+	{
+		// Edge functions are kept positive inside regardless of the projected winding
+		float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+
+		if (area == 0.0f) return;
+		if (area < 0.0f) std::swap(b, c), area = -area;
+
+		const int32_t minX = std::max((int32_t)std::floor(std::min({ a[0], b[0], c[0] })), 0);
+		const int32_t minY = std::max((int32_t)std::floor(std::min({ a[1], b[1], c[1] })), 0);
+		const int32_t maxX = std::min((int32_t)std::ceil(std::max({ a[0], b[0], c[0] })), (int32_t)OverdrawGridSize - 1);
+		const int32_t maxY = std::min((int32_t)std::ceil(std::max({ a[1], b[1], c[1] })), (int32_t)OverdrawGridSize - 1);
+
+		for (int32_t y = minY; y <= maxY; y++)
+		{
+			for (int32_t x = minX; x <= maxX; x++)
+			{
+				const float px = x + 0.5f, py = y + 0.5f;
+
+				const float w0 = (c[0] - b[0]) * (py - b[1]) - (c[1] - b[1]) * (px - b[0]);
+				const float w1 = (a[0] - c[0]) * (py - c[1]) - (a[1] - c[1]) * (px - c[0]);
+				const float w2 = (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+
+				if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+				const float z = (w0 * a[2] + w1 * b[2] + w2 * c[2]) / area;
+				float& d = depth[y * OverdrawGridSize + x];
+
+				if (z >= d) continue;
+
+				d = z;
+				stats.PixelsShaded++;
+			}
+		}
+	}
+
+	OverdrawStats AnalyzeOverdraw(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride)
+	{
+		OverdrawStats stats = {};
+
+		if (indexCount < 3 || vertexCount == 0) return stats;
+
+		float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const float* p = GetPosition(positions, vertexStride, (uint32_t)i);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				minimum[k] = std::min(minimum[k], p[k]);
+				maximum[k] = std::max(maximum[k], p[k]);
+			}
+		}
+
+		const float extent = std::max({ maximum[0] - minimum[0], maximum[1] - minimum[1], maximum[2] - minimum[2], FLT_MIN });
+		const float scale = (OverdrawGridSize - 1) / extent;
+
+		std::vector<float> depth(OverdrawGridSize * OverdrawGridSize);
+
+		for (uint32_t axis = 0; axis < 3; axis++)
+		{
+			const uint32_t u = (axis + 1) % 3, v = (axis + 2) % 3;
+
+			for (float direction : { 1.0f, -1.0f })
+			{
+				std::fill(depth.begin(), depth.end(), FLT_MAX);
+
+				for (size_t i = 0; i + 2 < indexCount; i += 3)
+				{
+					const float* p[3] = { GetPosition(positions, vertexStride, indices[i]), GetPosition(positions, vertexStride, indices[i + 1]), GetPosition(positions, vertexStride, indices[i + 2]) };
+
+					// Counter-clockwise triangles face along their normal; cull the ones facing away
+					const float e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+					const float e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+					const float normal = e1[u] * e2[v] - e1[v] * e2[u];
+
+					if (normal * direction >= 0.0f) continue;
+
+					float projected[3][3];
+
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						projected[k][0] = (p[k][u] - minimum[u]) * scale;
+						projected[k][1] = (p[k][v] - minimum[v]) * scale;
+						projected[k][2] = (p[k][axis] - minimum[axis]) * direction;
+					}
+
+					RasterizeTriangle(projected[0], projected[1], projected[2], depth, stats);
+				}
+
+				for (float d : depth)
+					stats.PixelsCovered += d != FLT_MAX;
+			}
+		}
+
+		if (stats.PixelsCovered > 0)
+			stats.Overdraw = (float)stats.PixelsShaded / stats.PixelsCovered;
+
+		return stats;
+	}
+
+	// FIFO cache misses of one triangle; a vertex is cached while its timestamp is recent
+	static uint32_t SimulateTriangle(const uint32_t* tri, std::vector<uint32_t>& timestamps, uint32_t& time)
+	{
+		uint32_t misses = 0;
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			if (time - timestamps[tri[k]] >= ClusterCacheSize)
+			{
+				timestamps[tri[k]] = ++time;
+				misses++;
+			}
+		}
+
+		return misses;
+	}
+
+	void OptimizeOverdraw(uint32_t* dst, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride, float threshold)
+	{
+		const size_t triangleCount = indexCount / 3;
+
+		if (triangleCount == 0) return;
+
+		// Hard boundaries: triangles where the cache optimizer restarted with three misses
+		std::vector<uint32_t> timestamps(vertexCount, 0), hard;
+		uint32_t time = ClusterCacheSize + 1;
+
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			if (SimulateTriangle(indices + t * 3, timestamps, time) == 3 || t == 0)
+				hard.push_back((uint32_t)t);
+		}
+
+		hard.push_back((uint32_t)triangleCount);
+
+		// Soft boundaries: split a hard cluster as soon as its running ACMR, counting the
+		// cold start, is within threshold of the ACMR of the whole cluster
+		std::vector<uint32_t> clusters;
+
+		for (size_t h = 0; h + 1 < hard.size(); h++)
+		{
+			const uint32_t begin = hard[h], end = hard[h + 1];
+
+			time += ClusterCacheSize + 1;
+			uint32_t misses = 0;
+
+			for (uint32_t t = begin; t < end; t++)
+				misses += SimulateTriangle(indices + t * 3, timestamps, time);
+
+			const float limit = (float)misses / (end - begin) * threshold;
+
+			time += ClusterCacheSize + 1;
+			uint32_t runningMisses = 0, start = begin;
+
+			clusters.push_back(begin);
+
+			for (uint32_t t = begin; t < end; t++)
+			{
+				runningMisses += SimulateTriangle(indices + t * 3, timestamps, time);
+
+				if (t + 1 < end && (float)runningMisses / (t + 1 - start) <= limit)
+				{
+					clusters.push_back(t + 1);
+
+					time += ClusterCacheSize + 1;
+					runningMisses = 0;
+					start = t + 1;
+				}
+			}
+		}
+
+		clusters.push_back((uint32_t)triangleCount);
+
+		// Area weighted centroid and normal of the mesh and of every cluster
+		const size_t clusterCount = clusters.size() - 1;
+
+		std::vector<float> centroids(clusterCount * 3, 0.0f), normals(clusterCount * 3, 0.0f), areas(clusterCount, 0.0f);
+		float meshCentroid[3] = {}, meshArea = 0.0f;
+
+		for (size_t c = 0; c < clusterCount; c++)
+		{
+			for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++)
+			{
+				const float* p0 = GetPosition(positions, vertexStride, indices[t * 3]);
+				const float* p1 = GetPosition(positions, vertexStride, indices[t * 3 + 1]);
+				const float* p2 = GetPosition(positions, vertexStride, indices[t * 3 + 2]);
+
+				const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+				const float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					centroids[c * 3 + k] += (p0[k] + p1[k] + p2[k]) / 3.0f * area;
+					normals[c * 3 + k] += n[k];
+				}
+
+				areas[c] += area;
+			}
+
+			for (uint32_t k = 0; k < 3; k++)
+				meshCentroid[k] += centroids[c * 3 + k];
+
+			meshArea += areas[c];
+		}
+
+		for (uint32_t k = 0; k < 3; k++)
+			meshCentroid[k] /= std::max(meshArea, FLT_MIN);
+
+		std::vector<float> sortKeys(clusterCount);
+		std::vector<uint32_t> order(clusterCount);
+
+		for (size_t c = 0; c < clusterCount; c++)
+		{
+			const float* n = &normals[c * 3];
+			const float length = std::max(std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]), FLT_MIN);
+
+			float key = 0.0f;
+
+			for (uint32_t k = 0; k < 3; k++)
+				key += (centroids[c * 3 + k] / std::max(areas[c], FLT_MIN) - meshCentroid[k]) * n[k] / length;
+
+			sortKeys[c] = key;
+			order[c] = (uint32_t)c;
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		for (uint32_t c : order)
+		{
+			const size_t count = (clusters[c + 1] - clusters[c]) * 3;
+
+			std::copy(indices + clusters[c] * 3, indices + clusters[c] * 3 + count, dst);
+			dst += count;
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Assets
+{
+
+	// Pixels drawn by a software rasterizer with depth testing and backface culling, summed
+	// over orthographic views along both directions of each axis. Overdraw is shaded over
+	// covered pixels, so 1.0 means every visible pixel was shaded exactly once.
+	struct OverdrawStats
+	{
+		uint32_t PixelsCovered = 0;
+		uint32_t PixelsShaded = 0;
+		float Overdraw = 0.0f;
+	};
+
+	// positions points at the first vertex position (three floats), vertexStride is in bytes
+	OverdrawStats AnalyzeOverdraw(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride);
+
+	// Splits a vertex cache optimized index buffer into clusters and sorts them so the ones
+	// on the outside of the mesh, facing away from its centre, are drawn first. threshold
+	// is how much worse than the input each cluster's ACMR may get (1.05 allows 5%); higher
+	// values give smaller clusters and less overdraw. dst must not alias indices.
+	void OptimizeOverdraw(uint32_t* dst, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride, float threshold);
+
+}
\ No newline at end of file
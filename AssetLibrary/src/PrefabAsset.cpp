@@ -1,18 +1,66 @@
 #include "Asset.hpp"
 #include "PrefabAsset.hpp"
+#include "Metadata.hpp"
 
 #include <nlohmann/json.hpp>
 
-#include <lz4.h>
+#include <map>
 
 namespace Assets
 {
 
-	PrefabAssetInfo ParsePrefabAssetInfo(Asset* file)
+	struct PrefabMetadata
 	{
-		nlohmann::json metadata = nlohmann::json::parse(file->Json);
+		uint32_t HeaderSize;
+		uint32_t Compression;
+		uint32_t MatricesSize;
+		uint32_t NodeNameCount;
+		uint32_t NodeParentCount;
+		uint32_t NodeMatrixCount;
+		uint32_t NodeMeshCount;
+		uint32_t BlockSize;
+		int32_t CompressionLevel;
+		uint32_t DictionaryId;
+		uint64_t ContentHash;
+	};
 
-		PrefabAssetInfo info = {};
+	// Hashes the node tables in key order, so equal prefabs hash the same regardless of
+	// the iteration order of their maps
+	static uint64_t HashPrefabContent(const PrefabAssetInfo* info)
+	{
+		uint64_t hash = HashContent(info->Matrices.data(), info->Matrices.size() * sizeof(info->Matrices[0]));
+
+		for (const auto& [node, name] : std::map<uint64_t, std::string>(info->NodeNames.begin(), info->NodeNames.end()))
+		{
+			hash = HashContent(&node, sizeof(node), hash);
+			hash = HashContent(name.data(), name.size(), hash);
+		}
+
+		for (const auto& [node, parent] : std::map<uint64_t, uint64_t>(info->NodeParents.begin(), info->NodeParents.end()))
+		{
+			hash = HashContent(&node, sizeof(node), hash);
+			hash = HashContent(&parent, sizeof(parent), hash);
+		}
+
+		for (const auto& [node, matrix] : std::map<uint64_t, uint64_t>(info->NodeMatrices.begin(), info->NodeMatrices.end()))
+		{
+			hash = HashContent(&node, sizeof(node), hash);
+			hash = HashContent(&matrix, sizeof(matrix), hash);
+		}
+
+		for (const auto& [node, mesh] : std::map<uint64_t, MeshNode>(info->NodeMeshes.begin(), info->NodeMeshes.end()))
+		{
+			hash = HashContent(&node, sizeof(node), hash);
+			hash = HashContent(mesh.MeshPath.data(), mesh.MeshPath.size(), hash);
+			hash = HashContent(mesh.MaterialPath.data(), mesh.MaterialPath.size(), hash);
+		}
+
+		return hash;
+	}
+
+	static uint32_t ParsePrefabMetadataJson(std::string_view json, PrefabAssetInfo& info)
+	{
+		nlohmann::json metadata = nlohmann::json::parse(json);
 
 		for (const auto& p : metadata["nodenames"].items())
 		{
@@ -44,24 +92,158 @@ namespace Assets
 			info.NodeMeshes[p.first] = std::move(node);
 		}
 
-		const uint32_t matricesSize = metadata["matricessize"];
+		const std::string compression = metadata.value("compression", "LZ4");
+		info.Compression = ParseCompressionMode(compression.c_str());
+		info.BlockSize = metadata.value("blocksize", 0u);
+		info.CompressionLevel = metadata.value("compressionlevel", 0);
+		info.DictionaryId = metadata.value("dictionary", 0u);
+		info.ContentHash = metadata.value("hash", 0ull);
+
+		return metadata["matricessize"];
+	}
+
+	static uint32_t ParsePrefabMetadataBinary(std::string_view data, PrefabAssetInfo& info)
+	{
+		PrefabMetadata metadata;
+		MetadataReader reader(data);
+
+		if (!reader.ReadHeader(&metadata, sizeof(PrefabMetadata)))
+			return 0;
+
+		info.Compression = (CompressionMode)metadata.Compression;
+		info.BlockSize = metadata.BlockSize;
+		info.CompressionLevel = metadata.CompressionLevel;
+		info.DictionaryId = metadata.DictionaryId;
+		info.ContentHash = metadata.ContentHash;
+
+		for (uint32_t i = 0; i < metadata.NodeNameCount; i++)
+		{
+			uint64_t node;
+			std::string name;
+
+			if (!reader.Read(node) || !reader.ReadString(name)) return 0;
+			info.NodeNames[node] = std::move(name);
+		}
+
+		for (uint32_t i = 0; i < metadata.NodeParentCount; i++)
+		{
+			uint64_t node, parent;
+
+			if (!reader.Read(node) || !reader.Read(parent)) return 0;
+			info.NodeParents[node] = parent;
+		}
+
+		for (uint32_t i = 0; i < metadata.NodeMatrixCount; i++)
+		{
+			uint64_t node, matrix;
+
+			if (!reader.Read(node) || !reader.Read(matrix)) return 0;
+			info.NodeMatrices[node] = matrix;
+		}
+
+		for (uint32_t i = 0; i < metadata.NodeMeshCount; i++)
+		{
+			uint64_t node;
+			MeshNode mesh;
+
+			if (!reader.Read(node) || !reader.ReadString(mesh.MeshPath) || !reader.ReadString(mesh.MaterialPath)) return 0;
+			info.NodeMeshes[node] = std::move(mesh);
+		}
+
+		return metadata.MatricesSize;
+	}
+
+	static PrefabAssetInfo ParsePrefabMetadata(uint32_t version, std::string_view data, const uint8_t* binary, size_t binarySize)
+	{
+		PrefabAssetInfo info = {};
+		uint32_t matricesSize = 0;
+
+		if (version >= AssetVersionBinary)
+			matricesSize = ParsePrefabMetadataBinary(data, info);
+
+		else
+			matricesSize = ParsePrefabMetadataJson(data, info);
+
 		info.Matrices.resize(matricesSize / (16 * sizeof(float)));
 
-		LZ4_decompress_safe((const char*)file->Binary.data(), (char*)info.Matrices.data(), file->Binary.size(), matricesSize);
+		// A payload that does not decompress leaves the prefab without nodes rather than with garbage
+		if (!DecompressPayload(info.Compression, info.DictionaryId, info.BlockSize, binary, binarySize, (uint8_t*)info.Matrices.data(), matricesSize))
+			info.Matrices.clear();
 
 		return info;
 	}
 
-	Asset PackPrefabAsset(PrefabAssetInfo* info)
+	static std::string WritePrefabMetadataBinary(const PrefabAssetInfo* info, uint32_t matricesSize)
+	{
+		PrefabMetadata metadata;
+		memset(&metadata, 0, sizeof(PrefabMetadata));
+
+		metadata.HeaderSize = sizeof(PrefabMetadata);
+		metadata.Compression = (uint32_t)info->Compression;
+		metadata.MatricesSize = matricesSize;
+		metadata.NodeNameCount = info->NodeNames.size();
+		metadata.NodeParentCount = info->NodeParents.size();
+		metadata.NodeMatrixCount = info->NodeMatrices.size();
+		metadata.NodeMeshCount = info->NodeMeshes.size();
+		metadata.BlockSize = info->BlockSize;
+		metadata.CompressionLevel = info->CompressionLevel;
+		metadata.DictionaryId = info->DictionaryId;
+		metadata.ContentHash = info->ContentHash;
+
+		MetadataWriter writer;
+		writer.Write(metadata);
+
+		for (const auto& [node, name] : info->NodeNames)
+		{
+			writer.Write(node);
+			writer.WriteString(name);
+		}
+
+		for (const auto& [node, parent] : info->NodeParents)
+		{
+			writer.Write(node);
+			writer.Write(parent);
+		}
+
+		for (const auto& [node, matrix] : info->NodeMatrices)
+		{
+			writer.Write(node);
+			writer.Write(matrix);
+		}
+
+		for (const auto& [node, mesh] : info->NodeMeshes)
+		{
+			writer.Write(node);
+			writer.WriteString(mesh.MeshPath);
+			writer.WriteString(mesh.MaterialPath);
+		}
+
+		return std::move(writer.Data());
+	}
+
+	PrefabAssetInfo ParsePrefabAssetInfo(Asset* file)
+	{
+		return ParsePrefabMetadata(file->Version, file->Json, file->Binary.data(), file->Binary.size());
+	}
+
+	PrefabAssetInfo ParsePrefabAssetInfo(const AssetView* view)
+	{
+		return ParsePrefabMetadata(view->Header->Version, view->Json, view->Binary.Data, view->Binary.Size);
+	}
+
+	static std::string WritePrefabMetadataJson(const PrefabAssetInfo* info, uint32_t matricesSize)
 	{
 		nlohmann::json metadata;
-		const uint32_t matricesSize = info->Matrices.size() * 16 * sizeof(float);
 
 		metadata["nodenames"] = info->NodeNames;
 		metadata["nodeparents"] = info->NodeParents;
 		metadata["nodematrices"] = info->NodeMatrices;
 		metadata["matricessize"] = matricesSize;
-		metadata["compression"] = "LZ4";
+		metadata["compression"] = GetCompressionModeName(info->Compression);
+		metadata["blocksize"] = info->BlockSize;
+		metadata["compressionlevel"] = info->CompressionLevel;
+		metadata["dictionary"] = info->DictionaryId;
+		metadata["hash"] = info->ContentHash;
 
 		std::unordered_map<uint64_t, nlohmann::json> meshData;
 
@@ -77,20 +259,28 @@ namespace Assets
 
 		metadata["nodemeshes"] = meshData;
 
-		const std::string jsonString = metadata.dump();
+		return metadata.dump();
+	}
+
+	Asset PackPrefabAsset(PrefabAssetInfo* info, uint32_t version)
+	{
+		const uint32_t matricesSize = info->Matrices.size() * 16 * sizeof(float);
 
 		Asset file = {};
 
 		file.Type[0] = 'P'; file.Type[1] = 'R';
 		file.Type[2] = 'F'; file.Type[3] = 'B';
 
-		file.Json = std::move(jsonString);
+		file.Version = version;
+		info->ContentHash = HashPrefabContent(info);
+
+		if (version >= AssetVersionBinary)
+			file.Json = WritePrefabMetadataBinary(info, matricesSize);
 
-		int stagingSize = LZ4_compressBound(matricesSize);
-		file.Binary.resize(stagingSize);
+		else
+			file.Json = WritePrefabMetadataJson(info, matricesSize);
 
-		int compressedSize = LZ4_compress_default((const char*)info->Matrices.data(), (char*)file.Binary.data(), matricesSize, stagingSize);
-		file.Binary.resize(compressedSize);
+		CompressPayload(info->Compression, info->CompressionLevel, info->DictionaryId, info->BlockSize, (const uint8_t*)info->Matrices.data(), matricesSize, file.Binary);
 
 		return file;
 	}
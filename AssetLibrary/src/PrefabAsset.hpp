@@ -1,8 +1,10 @@
 #pragma once
 
+#include "Asset.hpp"
 #include "Compression.hpp"
 
 #include <unordered_map>
+#include <array>
 
 namespace Assets
 {
@@ -22,12 +24,15 @@ namespace Assets
 		std::vector<std::array<float, 16>> Matrices;
 
 		CompressionMode Compression = CompressionMode::LZ4;
+		int CompressionLevel = 0;
+		uint32_t BlockSize = 0;
+		uint32_t DictionaryId = 0;
+		uint64_t ContentHash = 0;
 	};
 
-	struct Asset;
-
 	PrefabAssetInfo ParsePrefabAssetInfo(Asset* file);
+	PrefabAssetInfo ParsePrefabAssetInfo(const AssetView* view);
 
-	Asset PackPrefabAsset(PrefabAssetInfo* info);
+	Asset PackPrefabAsset(PrefabAssetInfo* info, uint32_t version = AssetVersionLatest);
 
 }
\ No newline at end of file
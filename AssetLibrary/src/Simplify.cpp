@@ -0,0 +1,434 @@
+#include "Simplify.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace Assets
+{
+
+	// Sum of squared distances to a set of planes, weighted by the area they came from
+	struct Quadric
+	{
+		double A00, A11, A22, A01, A02, A12;
+		double B0, B1, B2;
+		double C;
+		double Weight;
+	};
+
+	enum class SimplifyVertexKind : uint8_t
+	{
+		Manifold = 0,
+		Border,
+		Locked,
+	};
+
+	struct Collapse
+	{
+		uint32_t From;
+		uint32_t To;
+		float Cost;
+	};
+
+	static const double BorderWeight = 10.0;
+
+	static const float* GetPosition(const float* positions, size_t vertexStride, uint32_t index)
+	{
+		return (const float*)((const uint8_t*)positions + index * vertexStride);
+	}
+
+	static void Cross(double* out, const double* a, const double* b)
+	{
+		out[0] = a[1] * b[2] - a[2] * b[1];
+		out[1] = a[2] * b[0] - a[0] * b[2];
+		out[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	static double Dot(const double* a, const double* b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	static void AddPlane(Quadric& q, const double* n, double d, double weight)
+	{
+		q.A00 += weight * n[0] * n[0];
+		q.A11 += weight * n[1] * n[1];
+		q.A22 += weight * n[2] * n[2];
+		q.A01 += weight * n[0] * n[1];
+		q.A02 += weight * n[0] * n[2];
+		q.A12 += weight * n[1] * n[2];
+		q.B0 += weight * n[0] * d;
+		q.B1 += weight * n[1] * d;
+		q.B2 += weight * n[2] * d;
+		q.C += weight * d * d;
+		q.Weight += weight;
+	}
+
+	static void AddQuadric(Quadric& q, const Quadric& other)
+	{
+		q.A00 += other.A00; q.A11 += other.A11; q.A22 += other.A22;
+		q.A01 += other.A01; q.A02 += other.A02; q.A12 += other.A12;
+		q.B0 += other.B0; q.B1 += other.B1; q.B2 += other.B2;
+		q.C += other.C;
+		q.Weight += other.Weight;
+	}
+
+	// Mean squared distance from p to the planes of q
+	static double EvaluateQuadric(const Quadric& q, const double* p)
+	{
+		const double rx = q.A00 * p[0] + q.A01 * p[1] + q.A02 * p[2];
+		const double ry = q.A01 * p[0] + q.A11 * p[1] + q.A12 * p[2];
+		const double rz = q.A02 * p[0] + q.A12 * p[1] + q.A22 * p[2];
+
+		const double error = p[0] * rx + p[1] * ry + p[2] * rz + 2.0 * (q.B0 * p[0] + q.B1 * p[1] + q.B2 * p[2]) + q.C;
+
+		return q.Weight > 0.0 ? std::fabs(error) / q.Weight : 0.0;
+	}
+
+	static uint64_t GetEdgeKey(uint32_t a, uint32_t b)
+	{
+		return ((uint64_t)a << 32) | b;
+	}
+
+	// Vertices sharing a position share an id, so seams don't count as open borders
+	static uint32_t BuildPositionIds(const float* positions, size_t vertexCount, size_t vertexStride, std::vector<uint32_t>& ids, std::vector<uint32_t>& wedges)
+	{
+		std::vector<uint32_t> order(vertexCount);
+		std::iota(order.begin(), order.end(), 0);
+
+		const auto less = [&](uint32_t a, uint32_t b)
+		{
+			const float* pa = GetPosition(positions, vertexStride, a);
+			const float* pb = GetPosition(positions, vertexStride, b);
+
+			return std::lexicographical_compare(pa, pa + 3, pb, pb + 3);
+		};
+
+		std::sort(order.begin(), order.end(), less);
+
+		ids.resize(vertexCount);
+		wedges.clear();
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			if (i == 0 || less(order[i - 1], order[i]))
+				wedges.push_back(0);
+
+			ids[order[i]] = (uint32_t)wedges.size() - 1;
+			wedges.back()++;
+		}
+
+		return (uint32_t)wedges.size();
+	}
+
+	// Border vertices have exactly one open edge leaving and one entering them; anything on a
+	// seam, a non-manifold edge or several borders is locked
+	static void ClassifyVertices(const std::vector<uint32_t>& indices, size_t indexCount, const std::vector<uint32_t>& ids, const std::vector<uint32_t>& wedges,
+		std::vector<SimplifyVertexKind>& kinds, std::vector<uint32_t>& borderNext, std::vector<uint32_t>& borderPrev)
+	{
+		const size_t vertexCount = ids.size();
+
+		std::unordered_map<uint64_t, uint32_t> edges;
+		edges.reserve(indexCount);
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			const uint32_t a = ids[indices[i]];
+			const uint32_t b = ids[indices[i % 3 == 2 ? i - 2 : i + 1]];
+
+			edges[GetEdgeKey(a, b)]++;
+		}
+
+		std::vector<uint32_t> openOut(vertexCount, 0), openIn(vertexCount, 0);
+
+		kinds.assign(vertexCount, SimplifyVertexKind::Manifold);
+		borderNext.assign(vertexCount, ~0u);
+		borderPrev.assign(vertexCount, ~0u);
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			const uint32_t v0 = indices[i];
+			const uint32_t v1 = indices[i % 3 == 2 ? i - 2 : i + 1];
+			const uint32_t a = ids[v0], b = ids[v1];
+
+			const uint32_t count = edges[GetEdgeKey(a, b)];
+			const auto reverse = edges.find(GetEdgeKey(b, a));
+
+			if (count > 1 || (reverse != edges.end() && reverse->second > 1))
+			{
+				kinds[v0] = kinds[v1] = SimplifyVertexKind::Locked;
+				continue;
+			}
+
+			if (reverse == edges.end())
+			{
+				openOut[v0]++;
+				openIn[v1]++;
+				borderNext[v0] = b;
+				borderPrev[v1] = a;
+			}
+		}
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			if (kinds[v] == SimplifyVertexKind::Locked) continue;
+
+			if (wedges[ids[v]] > 1 || openOut[v] > 1 || openIn[v] > 1 || openOut[v] != openIn[v])
+				kinds[v] = SimplifyVertexKind::Locked;
+
+			else if (openOut[v] == 1)
+				kinds[v] = SimplifyVertexKind::Border;
+		}
+	}
+
+	static bool CanCollapse(uint32_t from, uint32_t to, const std::vector<uint32_t>& ids, const std::vector<SimplifyVertexKind>& kinds,
+		const std::vector<uint32_t>& borderNext, const std::vector<uint32_t>& borderPrev)
+	{
+		if (kinds[from] == SimplifyVertexKind::Manifold) return true;
+		if (kinds[from] == SimplifyVertexKind::Border) return ids[to] == borderNext[from] || ids[to] == borderPrev[from];
+
+		return false;
+	}
+
+	static void GetTriangleNormal(double* n, const double* p0, const double* p1, const double* p2)
+	{
+		const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+		Cross(n, e1, e2);
+	}
+
+	// Rejects collapses that turn any remaining triangle around from by more than ~75 degrees
+	static bool HasTriangleFlips(uint32_t from, uint32_t to, const std::vector<uint32_t>& indices, const std::vector<uint32_t>& adjacencyOffsets,
+		const std::vector<uint32_t>& adjacency, const std::vector<double>& points, const std::vector<uint32_t>& ids)
+	{
+		for (uint32_t k = adjacencyOffsets[from]; k < adjacencyOffsets[from + 1]; k++)
+		{
+			const uint32_t* tri = &indices[adjacency[k] * 3];
+
+			if (ids[tri[0]] == ids[to] || ids[tri[1]] == ids[to] || ids[tri[2]] == ids[to])
+				continue;
+
+			const double* before[3] = { &points[tri[0] * 3], &points[tri[1] * 3], &points[tri[2] * 3] };
+			const double* after[3] = { before[0], before[1], before[2] };
+
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				if (tri[i] == from) after[i] = &points[to * 3];
+			}
+
+			double n0[3], n1[3];
+			GetTriangleNormal(n0, before[0], before[1], before[2]);
+			GetTriangleNormal(n1, after[0], after[1], after[2]);
+
+			if (Dot(n0, n1) < 0.25 * std::sqrt(Dot(n0, n0) * Dot(n1, n1)))
+				return true;
+		}
+
+		return false;
+	}
+
+	size_t SimplifyMesh(uint32_t* dst, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride,
+		size_t targetIndexCount, float targetError, float* resultError)
+	{
+		std::vector<uint32_t> result(indices, indices + indexCount - indexCount % 3);
+		size_t count = result.size();
+
+		targetIndexCount -= targetIndexCount % 3;
+
+		// Work in a unit cube so errors don't depend on the model scale
+		const float scale = GetMeshScale(positions, vertexCount, vertexStride);
+		float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			const float* p = GetPosition(positions, vertexStride, (uint32_t)v);
+			for (uint32_t k = 0; k < 3; k++) minimum[k] = std::min(minimum[k], p[k]);
+		}
+
+		std::vector<double> points(vertexCount * 3);
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			const float* p = GetPosition(positions, vertexStride, (uint32_t)v);
+			for (uint32_t k = 0; k < 3; k++) points[v * 3 + k] = scale > 0.0f ? (p[k] - minimum[k]) / scale : 0.0;
+		}
+
+		std::vector<uint32_t> ids, wedges;
+		const uint32_t positionCount = BuildPositionIds(positions, vertexCount, vertexStride, ids, wedges);
+
+		std::vector<SimplifyVertexKind> kinds;
+		std::vector<uint32_t> borderNext, borderPrev;
+
+		ClassifyVertices(result, count, ids, wedges, kinds, borderNext, borderPrev);
+
+		// Quadrics live per position so wedges of one point agree on its error
+		std::vector<Quadric> quadrics(positionCount, Quadric{});
+
+		for (size_t i = 0; i < count; i += 3)
+		{
+			const double* p[3] = { &points[result[i] * 3], &points[result[i + 1] * 3], &points[result[i + 2] * 3] };
+
+			double n[3];
+			GetTriangleNormal(n, p[0], p[1], p[2]);
+
+			const double area = std::sqrt(Dot(n, n));
+			if (area == 0.0) continue;
+
+			n[0] /= area; n[1] /= area; n[2] /= area;
+
+			for (uint32_t k = 0; k < 3; k++)
+				AddPlane(quadrics[ids[result[i + k]]], n, -Dot(n, p[0]), area);
+
+			// Open edges also get a plane through them, perpendicular to the face, which keeps
+			// collapses along the border from pulling it inwards
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const uint32_t v0 = result[i + k], v1 = result[i + (k + 1) % 3];
+
+				if (kinds[v0] != SimplifyVertexKind::Border || borderNext[v0] != ids[v1]) continue;
+
+				const double edge[3] = { p[(k + 1) % 3][0] - p[k][0], p[(k + 1) % 3][1] - p[k][1], p[(k + 1) % 3][2] - p[k][2] };
+				const double length = std::sqrt(Dot(edge, edge));
+
+				double normal[3];
+				Cross(normal, edge, n);
+
+				const double normalLength = std::sqrt(Dot(normal, normal));
+				if (normalLength == 0.0) continue;
+
+				normal[0] /= normalLength; normal[1] /= normalLength; normal[2] /= normalLength;
+
+				const double d = -Dot(normal, p[k]);
+				AddPlane(quadrics[ids[v0]], normal, d, length * length * BorderWeight);
+				AddPlane(quadrics[ids[v1]], normal, d, length * length * BorderWeight);
+			}
+		}
+
+		const double limit = (double)targetError * targetError;
+		double error = 0.0;
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1), adjacency, remap(vertexCount);
+		std::vector<uint8_t> locked(vertexCount);
+		std::vector<Collapse> collapses;
+
+		while (count > targetIndexCount)
+		{
+			ClassifyVertices(result, count, ids, wedges, kinds, borderNext, borderPrev);
+
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+
+			for (size_t i = 0; i < count; i++)
+				adjacencyOffsets[result[i] + 1]++;
+
+			for (size_t v = 0; v < vertexCount; v++)
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+			adjacency.resize(count);
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+			for (size_t i = 0; i < count; i++)
+				adjacency[fill[result[i]]++] = (uint32_t)(i / 3);
+
+			// Every edge is a candidate in whichever allowed direction is cheaper
+			collapses.clear();
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const uint32_t a = result[i];
+				const uint32_t b = result[i % 3 == 2 ? i - 2 : i + 1];
+
+				if (ids[a] == ids[b]) continue;
+
+				Quadric q = quadrics[ids[a]];
+				AddQuadric(q, quadrics[ids[b]]);
+
+				const double costAB = CanCollapse(a, b, ids, kinds, borderNext, borderPrev) ? EvaluateQuadric(q, &points[b * 3]) : DBL_MAX;
+				const double costBA = CanCollapse(b, a, ids, kinds, borderNext, borderPrev) ? EvaluateQuadric(q, &points[a * 3]) : DBL_MAX;
+
+				if (costAB == DBL_MAX && costBA == DBL_MAX) continue;
+
+				if (costAB <= costBA) collapses.push_back({ a, b, (float)costAB });
+				else collapses.push_back({ b, a, (float)costBA });
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.Cost < y.Cost; });
+
+			std::iota(remap.begin(), remap.end(), 0);
+			std::fill(locked.begin(), locked.end(), 0);
+
+			// Each collapse removes two triangles, or one on a border
+			const size_t goal = (count - targetIndexCount) / 3;
+			size_t removed = 0, applied = 0;
+
+			for (const auto& c : collapses)
+			{
+				if (c.Cost > limit || removed >= goal) break;
+				if (locked[c.From] || locked[c.To]) continue;
+				if (HasTriangleFlips(c.From, c.To, result, adjacencyOffsets, adjacency, points, ids)) continue;
+
+				remap[c.From] = c.To;
+				AddQuadric(quadrics[ids[c.To]], quadrics[ids[c.From]]);
+
+				// The triangles around From change shape, so none of their vertices may move again this pass
+				for (uint32_t k = adjacencyOffsets[c.From]; k < adjacencyOffsets[c.From + 1]; k++)
+				{
+					const uint32_t* tri = &result[adjacency[k] * 3];
+					locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+				}
+
+				removed += kinds[c.From] == SimplifyVertexKind::Border ? 1 : 2;
+				error = std::max(error, (double)c.Cost);
+				applied++;
+			}
+
+			if (applied == 0) break;
+
+			size_t write = 0;
+
+			for (size_t i = 0; i < count; i += 3)
+			{
+				const uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+
+				if (ids[a] == ids[b] || ids[b] == ids[c] || ids[a] == ids[c]) continue;
+
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+
+			count = write;
+		}
+
+		std::copy(result.begin(), result.begin() + count, dst);
+
+		if (resultError != nullptr)
+			*resultError = (float)std::sqrt(error);
+
+		return count;
+	}
+
+	float GetMeshScale(const float* positions, size_t vertexCount, size_t vertexStride)
+	{
+		float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			const float* p = GetPosition(positions, vertexStride, (uint32_t)v);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				minimum[k] = std::min(minimum[k], p[k]);
+				maximum[k] = std::max(maximum[k], p[k]);
+			}
+		}
+
+		if (vertexCount == 0) return 0.0f;
+
+		return std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Assets
+{
+
+	// Collapses edges in order of quadric error until the index count reaches targetIndexCount
+	// or the next collapse would move the surface by more than targetError, then writes the
+	// remaining triangles to dst (which may alias indices) and returns their index count.
+	// Vertices are only ever moved onto existing ones, so the result indexes the same vertex
+	// buffer. Open borders only collapse along themselves and vertices split by attribute
+	// seams are kept. Errors are relative to the mesh extent, see GetMeshScale.
+	size_t SimplifyMesh(uint32_t* dst, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t vertexStride,
+		size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+	// Largest side of the bounding box, which turns relative simplification errors into model units
+	float GetMeshScale(const float* positions, size_t vertexCount, size_t vertexStride);
+
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "TaskPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace Assets
+{
+
+	static std::unique_ptr<TaskPool> s_Instance = nullptr;
+	static std::mutex s_InstanceMutex;
+
+	struct ParallelJob
+	{
+		const std::function<void(uint32_t)>* Fn = nullptr;
+		uint32_t Count = 0;
+
+		std::atomic<uint32_t> Next = 0;
+		std::atomic<uint32_t> Completed = 0;
+
+		std::mutex Mutex;
+		std::condition_variable Done;
+
+		void Run()
+		{
+			uint32_t i;
+
+			while ((i = Next++) < Count)
+			{
+				(*Fn)(i);
+
+				if (++Completed == Count)
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					Done.notify_all();
+				}
+			}
+		}
+	};
+
+	TaskPool::TaskPool(uint32_t numWorkers)
+	{
+		m_Workers.reserve(numWorkers);
+
+		for (uint32_t i = 0; i < numWorkers; i++)
+			m_Workers.emplace_back([this]() { WorkerLoop(); });
+	}
+
+	TaskPool::~TaskPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Running = false;
+		}
+
+		m_Signal.notify_all();
+
+		for (auto& w : m_Workers)
+			w.join();
+	}
+
+	void TaskPool::Submit(std::function<void()>&& task)
+	{
+		if (m_Workers.empty())
+		{
+			task();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Tasks.push_back(std::move(task));
+		}
+
+		m_Signal.notify_one();
+	}
+
+	void TaskPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn)
+	{
+		if (count <= 1 || m_Workers.empty())
+		{
+			for (uint32_t i = 0; i < count; i++)
+				fn(i);
+
+			return;
+		}
+
+		auto job = std::make_shared<ParallelJob>();
+		job->Fn = &fn;
+		job->Count = count;
+
+		const uint32_t helpers = std::min(count - 1, GetWorkerCount());
+
+		for (uint32_t i = 0; i < helpers; i++)
+			Submit([job]() { job->Run(); });
+
+		job->Run();
+
+		std::unique_lock<std::mutex> lock(job->Mutex);
+		job->Done.wait(lock, [&]() { return job->Completed == job->Count; });
+	}
+
+	TaskPool* TaskPool::Create(uint32_t numThreads)
+	{
+		std::lock_guard<std::mutex> lock(s_InstanceMutex);
+
+		if (s_Instance == nullptr)
+		{
+			if (numThreads == 0) numThreads = std::max(std::thread::hardware_concurrency(), 2u);
+			s_Instance.reset(new TaskPool(numThreads - 1));
+		}
+
+		return s_Instance.get();
+	}
+
+	TaskPool& TaskPool::Get()
+	{
+		return *Create();
+	}
+
+	void TaskPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Signal.wait(lock, [this]() { return !m_Running || !m_Tasks.empty(); });
+
+				if (!m_Running && m_Tasks.empty()) return;
+
+				task = std::move(m_Tasks.front());
+				m_Tasks.pop_front();
+			}
+
+			task();
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Assets
+{
+
+	// Fixed set of worker threads shared by everything in the asset pipeline
+	class TaskPool final
+	{
+	public:
+		TaskPool(TaskPool&) = delete;
+		~TaskPool();
+
+		TaskPool& operator=(TaskPool&) = delete;
+
+		void Submit(std::function<void()>&& task);
+
+		// Runs fn(0) .. fn(count - 1) across the workers. The calling thread takes part
+		// too, so nested calls from inside a task cannot deadlock the pool.
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn);
+
+		inline uint32_t GetWorkerCount() const { return (uint32_t)m_Workers.size(); }
+
+		// Sizes the shared pool (workers plus the calling thread, 0 = one per hardware thread).
+		// Only the first call creates it, later ones return the existing pool.
+		static TaskPool* Create(uint32_t numThreads = 0);
+		static TaskPool& Get();
+
+	private:
+		std::vector<std::thread> m_Workers = {};
+		std::deque<std::function<void()>> m_Tasks = {};
+
+		std::mutex m_Mutex;
+		std::condition_variable m_Signal;
+		bool m_Running = true;
+
+		TaskPool(uint32_t numWorkers);
+
+		void WorkerLoop();
+	};
+
+}
\ No newline at end of file
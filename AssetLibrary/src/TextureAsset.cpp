@@ -1,35 +1,142 @@
 #include "Asset.hpp"
 #include "TextureAsset.hpp"
 #include "Compression.hpp"
+#include "Metadata.hpp"
 
 #include <nlohmann/json.hpp>
 
-#include <lz4.h>
-
 namespace Assets
 {
 
-	static TextureFormat ParseTextureAssetFormat(const char* format)
+	struct TextureMetadata
+	{
+		uint32_t HeaderSize;
+		uint32_t Format;
+		uint32_t Compression;
+		uint32_t PixelSize[3];
+		uint64_t FileSize;
+		uint32_t BlockSize;
+		int32_t CompressionLevel;
+		uint32_t DictionaryId;
+		uint64_t ContentHash;
+		uint32_t MipLevels;
+		uint32_t ColorSpace;
+		uint32_t PunchThroughAlpha;
+	};
+
+	TextureFormat ParseTextureFormat(const char* format)
 	{
 		if (strcmp(format, "RGBA8") == 0)
 			return TextureFormat::RGBA8;
 
+		if (strcmp(format, "BC1") == 0)
+			return TextureFormat::BC1;
+
+		if (strcmp(format, "BC3") == 0)
+			return TextureFormat::BC3;
+
+		if (strcmp(format, "BC5") == 0)
+			return TextureFormat::BC5;
+
+		if (strcmp(format, "BC7") == 0)
+			return TextureFormat::BC7;
+
+		if (strcmp(format, "R8") == 0)
+			return TextureFormat::R8;
+
+		if (strcmp(format, "RG8") == 0)
+			return TextureFormat::RG8;
+
+		if (strcmp(format, "R16") == 0)
+			return TextureFormat::R16;
+
+		if (strcmp(format, "RGBA16F") == 0)
+			return TextureFormat::RGBA16F;
+
 		return TextureFormat::None;
 	}
 
-	TextureAssetInfo ParseTextureAssetInfo(Asset* file)
+	const char* GetTextureFormatName(TextureFormat format)
+	{
+		switch (format)
+		{
+			case TextureFormat::RGBA8:
+				return "RGBA8";
+
+			case TextureFormat::BC1:
+				return "BC1";
+
+			case TextureFormat::BC3:
+				return "BC3";
+
+			case TextureFormat::BC5:
+				return "BC5";
+
+			case TextureFormat::BC7:
+				return "BC7";
+
+			case TextureFormat::R8:
+				return "R8";
+
+			case TextureFormat::RG8:
+				return "RG8";
+
+			case TextureFormat::R16:
+				return "R16";
+
+			case TextureFormat::RGBA16F:
+				return "RGBA16F";
+
+			default:
+				return "None";
+		}
+	}
+
+	bool IsTextureSrgb(const TextureAssetInfo* info)
+	{
+		if (info->ColorSpace != TextureColorSpace::Default)
+			return info->ColorSpace == TextureColorSpace::Srgb;
+
+		switch (info->Format)
+		{
+			case TextureFormat::RGBA8:
+			case TextureFormat::BC1:
+			case TextureFormat::BC3:
+			case TextureFormat::BC7:
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	static TextureAssetInfo ParseTextureMetadataJson(std::string_view json)
 	{
 		TextureAssetInfo info = {};
-		nlohmann::json metadata = nlohmann::json::parse(file->Json);
+		nlohmann::json metadata = nlohmann::json::parse(json);
 
 		info.Name = metadata["name"];
 		info.FileSize = metadata["filesize"];
 		info.PixelSize[0] = metadata["width"];
 		info.PixelSize[1] = metadata["height"];
 		info.PixelSize[2] = metadata["depth"];
+		info.BlockSize = metadata.value("blocksize", 0u);
+		info.CompressionLevel = metadata.value("compressionlevel", 0);
+		info.DictionaryId = metadata.value("dictionary", 0u);
+		info.ContentHash = metadata.value("hash", 0ull);
+		info.MipLevels = metadata.value("mips", 0u);
+		info.PunchThroughAlpha = metadata.value("punchthrough", false);
+
+		const std::string colorSpace = metadata.value("colorspace", "");
+
+		if (colorSpace == "linear")
+			info.ColorSpace = TextureColorSpace::Linear;
+
+		else if (colorSpace == "srgb")
+			info.ColorSpace = TextureColorSpace::Srgb;
 
 		const std::string format = metadata["format"];
-		info.Format = ParseTextureAssetFormat(format.c_str());
+		info.Format = ParseTextureFormat(format.c_str());
 
 		const std::string compression = metadata["compression"];
 		info.Compression = ParseCompressionMode(compression.c_str());
@@ -37,43 +144,163 @@ namespace Assets
 		return info;
 	}
 
-	void UnpackTexture(TextureAssetInfo* info, const uint8_t* src, uint8_t* dst, size_t size)
+	static TextureAssetInfo ParseTextureMetadataBinary(std::string_view data)
 	{
-		if (info->Compression == CompressionMode::LZ4)
-		{
-			LZ4_decompress_safe((const char*)src, (char*)dst, size, info->FileSize);
-			return;
-		}
+		TextureAssetInfo info = {};
+		TextureMetadata metadata;
+
+		MetadataReader reader(data);
+
+		if (!reader.ReadHeader(&metadata, sizeof(TextureMetadata)))
+			return info;
+
+		info.Format = (TextureFormat)metadata.Format;
+		info.Compression = (CompressionMode)metadata.Compression;
+		info.FileSize = metadata.FileSize;
+		info.PixelSize[0] = metadata.PixelSize[0];
+		info.PixelSize[1] = metadata.PixelSize[1];
+		info.PixelSize[2] = metadata.PixelSize[2];
+		info.BlockSize = metadata.BlockSize;
+		info.CompressionLevel = metadata.CompressionLevel;
+		info.DictionaryId = metadata.DictionaryId;
+		info.ContentHash = metadata.ContentHash;
+		info.MipLevels = metadata.MipLevels;
+		info.ColorSpace = (TextureColorSpace)metadata.ColorSpace;
+		info.PunchThroughAlpha = metadata.PunchThroughAlpha != 0;
+
+		reader.ReadString(info.Name);
+
+		return info;
+	}
+
+	static TextureAssetInfo ParseTextureMetadata(uint32_t version, std::string_view data)
+	{
+		if (version >= AssetVersionBinary)
+			return ParseTextureMetadataBinary(data);
 
-		memcpy(dst, src, size);
+		return ParseTextureMetadataJson(data);
 	}
 
-	Asset PackTexture(TextureAssetInfo* info, void* data)
+	static std::string WriteTextureMetadata(const TextureAssetInfo* info, uint32_t version)
 	{
+		if (version >= AssetVersionBinary)
+		{
+			TextureMetadata metadata;
+			memset(&metadata, 0, sizeof(TextureMetadata));
+
+			metadata.HeaderSize = sizeof(TextureMetadata);
+			metadata.Format = (uint32_t)info->Format;
+			metadata.Compression = (uint32_t)info->Compression;
+			metadata.PixelSize[0] = info->PixelSize[0];
+			metadata.PixelSize[1] = info->PixelSize[1];
+			metadata.PixelSize[2] = info->PixelSize[2];
+			metadata.FileSize = info->FileSize;
+			metadata.BlockSize = info->BlockSize;
+			metadata.CompressionLevel = info->CompressionLevel;
+			metadata.DictionaryId = info->DictionaryId;
+			metadata.ContentHash = info->ContentHash;
+			metadata.MipLevels = info->MipLevels;
+			metadata.ColorSpace = (uint32_t)info->ColorSpace;
+			metadata.PunchThroughAlpha = info->PunchThroughAlpha;
+
+			MetadataWriter writer;
+			writer.Write(metadata);
+			writer.WriteString(info->Name);
+
+			return std::move(writer.Data());
+		}
+
 		nlohmann::json metadata;
 
-		metadata["format"] = "RGBA8";
-		metadata["compression"] = "LZ4";
+		metadata["format"] = GetTextureFormatName(info->Format);
+		metadata["compression"] = GetCompressionModeName(info->Compression);
 		metadata["name"] = info->Name;
 		metadata["filesize"] = info->FileSize;
 		metadata["width"] = info->PixelSize[0];
 		metadata["height"] = info->PixelSize[1];
 		metadata["depth"] = info->PixelSize[2];
+		metadata["blocksize"] = info->BlockSize;
+		metadata["compressionlevel"] = info->CompressionLevel;
+		metadata["dictionary"] = info->DictionaryId;
+		metadata["hash"] = info->ContentHash;
+		metadata["mips"] = info->MipLevels;
+		metadata["punchthrough"] = info->PunchThroughAlpha;
+
+		if (info->ColorSpace != TextureColorSpace::Default)
+			metadata["colorspace"] = info->ColorSpace == TextureColorSpace::Srgb ? "srgb" : "linear";
+
+		return metadata.dump();
+	}
+
+	TextureAssetInfo ParseTextureAssetInfo(Asset* file)
+	{
+		return ParseTextureMetadata(file->Version, file->Json);
+	}
+
+	TextureAssetInfo ParseTextureAssetInfo(const AssetView* view)
+	{
+		return ParseTextureMetadata(view->Header->Version, view->Json);
+	}
+
+	static size_t GetMipTableSize(const TextureAssetInfo* info)
+	{
+		return (size_t)info->MipLevels * sizeof(TextureMip);
+	}
+
+	bool UnpackTexture(TextureAssetInfo* info, const uint8_t* src, uint8_t* dst, size_t size)
+	{
+		const size_t tableSize = std::min(GetMipTableSize(info), size);
+
+		return DecompressPayload(info->Compression, info->DictionaryId, info->BlockSize, src, size - tableSize, dst, info->FileSize);
+	}
+
+	bool UnpackTextureRange(const TextureAssetInfo* info, const uint8_t* src, size_t srcSize, uint64_t offset, uint64_t size, uint8_t* dst)
+	{
+		const size_t tableSize = std::min(GetMipTableSize(info), srcSize);
+
+		return DecompressPayloadRange(info->Compression, info->DictionaryId, info->BlockSize, src, srcSize - tableSize, info->FileSize, offset, dst, size);
+	}
+
+	bool UnpackTextureMips(const TextureAssetInfo* info, const uint8_t* src, size_t srcSize, TextureMip* dst)
+	{
+		if (info->MipLevels == 0)
+		{
+			dst[0] = { 0, info->FileSize, info->PixelSize[0], info->PixelSize[1] };
+			return true;
+		}
+
+		const size_t tableSize = GetMipTableSize(info);
 
-		const std::string jsonString = metadata.dump();
+		if (tableSize > srcSize) return false;
+
+		memcpy(dst, src + srcSize - tableSize, tableSize);
+
+		return true;
+	}
 
+	Asset PackTexture(TextureAssetInfo* info, void* data, uint32_t version, const TextureMip* mips)
+	{
 		Asset file = {};
 
 		file.Type[0] = 'T'; file.Type[1] = 'E';
 		file.Type[2] = 'X'; file.Type[3] = 'I';
 
-		file.Json = std::move(jsonString);
+		file.Version = version;
+
+		// Identical texels decode differently in another color space or BC1 mode
+		const uint64_t seed = (uint64_t)info->Format | ((uint64_t)info->ColorSpace << 8) | ((uint64_t)info->PunchThroughAlpha << 16);
+
+		info->ContentHash = HashContent(info->PixelSize, sizeof(info->PixelSize), seed);
+		info->ContentHash = HashContent(data, info->FileSize, info->ContentHash);
+
+		if (mips == nullptr) info->MipLevels = 0;
+
+		file.Json = WriteTextureMetadata(info, version);
 
-		int stagingSize = LZ4_compressBound(info->FileSize);
-		file.Binary.resize(stagingSize);
+		CompressPayload(info->Compression, info->CompressionLevel, info->DictionaryId, info->BlockSize, (const uint8_t*)data, info->FileSize, file.Binary);
 
-		int compressedSize = LZ4_compress_default((const char*)data, (char*)file.Binary.data(), info->FileSize, stagingSize);
-		file.Binary.resize(compressedSize);
+		const uint8_t* table = (const uint8_t*)mips;
+		file.Binary.insert(file.Binary.end(), table, table + GetMipTableSize(info));
 
 		return file;
 	}
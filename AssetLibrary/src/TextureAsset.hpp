@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Asset.hpp"
+
 #include <string>
 
 namespace Assets
@@ -9,10 +11,36 @@ namespace Assets
 	{
 		None = 0,
 		RGBA8,
+		BC1,
+		BC3,
+		BC5,
+		BC7,
+		R8,
+		RG8,
+		R16,
+		RGBA16F,
+	};
+
+	// How color is encoded. Textures written without one use the format's default: sRGB for
+	// RGBA8, BC1, BC3 and BC7, linear for the rest.
+	enum class TextureColorSpace
+	{
+		Default = 0,
+		Linear,
+		Srgb,
 	};
 
 	enum class CompressionMode;
 
+	// Where one mip level sits in the unpacked payload; levels are stored largest first
+	struct TextureMip
+	{
+		uint64_t Offset;
+		uint64_t Size;
+		uint32_t Width;
+		uint32_t Height;
+	};
+
 	struct TextureAssetInfo
 	{
 		std::string Name = "";
@@ -20,13 +48,38 @@ namespace Assets
 		CompressionMode Compression;
 		size_t FileSize = 0;
 		uint32_t PixelSize[3] = { 0, 0, 0 };
+		int CompressionLevel = 0;
+		uint32_t BlockSize = 0;
+		uint32_t DictionaryId = 0;
+		uint64_t ContentHash = 0;
+		uint32_t MipLevels = 0;
+		TextureColorSpace ColorSpace = TextureColorSpace::Default;
+
+		// BC1 blocks in their three color mode decode index 3 as transparent black rather than opaque
+		bool PunchThroughAlpha = false;
 	};
 
-	struct Asset;
+	TextureFormat ParseTextureFormat(const char* format);
+	const char* GetTextureFormatName(TextureFormat format);
+
+	// Whether the texels hold sRGB encoded color, resolving TextureColorSpace::Default by format
+	bool IsTextureSrgb(const TextureAssetInfo* info);
 
 	TextureAssetInfo ParseTextureAssetInfo(Asset* file);
+	TextureAssetInfo ParseTextureAssetInfo(const AssetView* view);
+
+	// Returns false when the payload is corrupt or its dictionary is not loaded
+	bool UnpackTexture(TextureAssetInfo* info, const uint8_t* src, uint8_t* dst, size_t size);
+
+	// Unpacks only bytes [offset, offset + size) of the pixel payload, e.g. the levels a streaming
+	// texture is missing, decompressing just the blocks that overlap them
+	bool UnpackTextureRange(const TextureAssetInfo* info, const uint8_t* src, size_t srcSize, uint64_t offset, uint64_t size, uint8_t* dst);
+
+	// The mip table is stored uncompressed after the pixel payload. dst must hold
+	// max(info->MipLevels, 1) entries; a texture without a table is a single level.
+	bool UnpackTextureMips(const TextureAssetInfo* info, const uint8_t* src, size_t srcSize, TextureMip* dst);
 
-	void UnpackTexture(TextureAssetInfo* info, const uint8_t* src, uint8_t* dst, size_t size);
-	Asset PackTexture(TextureAssetInfo* info, void* data);
+	// mips must hold info->MipLevels entries, or be null to store the payload as a single level
+	Asset PackTexture(TextureAssetInfo* info, void* data, uint32_t version = AssetVersionLatest, const TextureMip* mips = nullptr);
 
 }
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "VertexCache.hpp"
+
+#include "VertexRemap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Assets
+{
+
+	// Simulated LRU size and score weights from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	static const uint32_t OptimizerCacheSize = 32;
+	static const float LastTriangleScore = 0.75f;
+	static const float CacheDecayPower = 1.5f;
+	static const float ValenceBoostScale = 2.0f;
+	static const float ValenceBoostPower = 0.5f;
+
+	static float GetVertexScore(int32_t cachePosition, uint32_t remaining)
+	{
+		if (remaining == 0) return -1.0f;
+
+		float score = 0.0f;
+
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+				score = LastTriangleScore;
+
+			else
+				score = std::pow(1.0f - (float)(cachePosition - 3) / (OptimizerCacheSize - 3), CacheDecayPower);
+		}
+
+		// Vertices with few triangles left are worth finishing before they fall out of the cache
+		return score + ValenceBoostScale * std::pow((float)remaining, -ValenceBoostPower);
+	}
+
+	VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+	{
+		VertexCacheStats stats = {};
+
+		// A vertex is cached while fewer than cacheSize misses happened since it was loaded
+		std::vector<uint32_t> loadedAt(vertexCount, 0);
+		std::vector<uint8_t> referenced(vertexCount, 0);
+		uint32_t misses = 0, uniqueCount = 0;
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			const uint32_t v = indices[i];
+
+			if (!referenced[v])
+			{
+				referenced[v] = 1;
+				uniqueCount++;
+			}
+
+			else if (misses - loadedAt[v] < cacheSize)
+				continue;
+
+			loadedAt[v] = ++misses;
+		}
+
+		stats.VerticesTransformed = misses;
+
+		if (indexCount > 0) stats.ACMR = (float)misses / (indexCount / 3);
+		if (uniqueCount > 0) stats.ATVR = (float)misses / uniqueCount;
+
+		return stats;
+	}
+
+	void OptimizeVertexCache(uint32_t* dst, const uint32_t* indices, size_t indexCount, size_t vertexCount)
+	{
+		const size_t triangleCount = indexCount / 3;
+
+		if (triangleCount == 0) return;
+
+		// Triangles adjacent to each vertex, the live ones packed at the front of its range
+		std::vector<uint32_t> remaining(vertexCount, 0), offsets(vertexCount + 1, 0);
+
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			remaining[indices[i]]++;
+
+		for (size_t v = 0; v < vertexCount; v++)
+			offsets[v + 1] = offsets[v] + remaining[v];
+
+		std::vector<uint32_t> adjacency(triangleCount * 3), filled(vertexCount, 0);
+
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			for (size_t k = 0; k < 3; k++)
+			{
+				const uint32_t v = indices[t * 3 + k];
+				adjacency[offsets[v] + filled[v]++] = (uint32_t)t;
+			}
+		}
+
+		std::vector<float> vertexScores(vertexCount);
+
+		for (size_t v = 0; v < vertexCount; v++)
+			vertexScores[v] = GetVertexScore(-1, remaining[v]);
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<uint8_t> emitted(triangleCount, 0);
+
+		for (size_t t = 0; t < triangleCount; t++)
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+		// dst may alias indices, so the output is built separately
+		std::vector<uint32_t> result;
+		result.reserve(triangleCount * 3);
+
+		std::vector<uint32_t> cache, nextCache;
+		cache.reserve(OptimizerCacheSize + 3);
+		nextCache.reserve(OptimizerCacheSize + 3);
+
+		uint32_t best = 0;
+		size_t cursor = 0;
+
+		for (uint32_t t = 1; t < (uint32_t)triangleCount; t++)
+		{
+			if (triangleScores[t] > triangleScores[best])
+				best = t;
+		}
+
+		for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+		{
+			// Nothing in the cache touches a live triangle: restart from the next unemitted one
+			if (best == InvalidVertex)
+			{
+				while (emitted[cursor]) cursor++;
+				best = (uint32_t)cursor;
+			}
+
+			const uint32_t* tri = indices + best * 3;
+			result.insert(result.end(), tri, tri + 3);
+			emitted[best] = 1;
+
+			nextCache.assign(tri, tri + 3);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const uint32_t v = tri[k];
+
+				uint32_t* begin = adjacency.data() + offsets[v];
+				uint32_t* end = begin + remaining[v];
+
+				for (uint32_t* it = begin; it != end; it++)
+				{
+					if (*it == best)
+					{
+						*it = *(end - 1);
+						break;
+					}
+				}
+
+				remaining[v]--;
+			}
+
+			for (uint32_t v : cache)
+			{
+				if (v != tri[0] && v != tri[1] && v != tri[2])
+					nextCache.push_back(v);
+			}
+
+			// Rescore every vertex whose position changed, including the ones just evicted
+			for (size_t i = 0; i < nextCache.size(); i++)
+			{
+				const uint32_t v = nextCache[i];
+				const int32_t position = i < OptimizerCacheSize ? (int32_t)i : -1;
+
+				const float score = GetVertexScore(position, remaining[v]);
+				const float delta = score - vertexScores[v];
+				vertexScores[v] = score;
+
+				for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; j++)
+					triangleScores[adjacency[j]] += delta;
+			}
+
+			if (nextCache.size() > OptimizerCacheSize)
+				nextCache.resize(OptimizerCacheSize);
+
+			cache.swap(nextCache);
+
+			best = InvalidVertex;
+			float bestScore = -1.0f;
+
+			for (uint32_t v : cache)
+			{
+				for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; j++)
+				{
+					const uint32_t t = adjacency[j];
+
+					if (triangleScores[t] > bestScore)
+					{
+						best = t;
+						bestScore = triangleScores[t];
+					}
+				}
+			}
+		}
+
+		std::copy(result.begin(), result.end(), dst);
+	}
+
+	uint32_t GenerateVertexFetchRemap(const uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap)
+	{
+		remap.assign(vertexCount, InvalidVertex);
+		uint32_t next = 0;
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			if (remap[indices[i]] == InvalidVertex)
+				remap[indices[i]] = next++;
+		}
+
+		return next;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Assets
+{
+
+	// Post-transform cache behaviour of an index buffer, simulated as a FIFO of CacheSize
+	// entries. ACMR is transformed vertices per triangle, ATVR per referenced vertex; 0.5
+	// and 1.0 respectively are the best any ordering can reach.
+	struct VertexCacheStats
+	{
+		uint32_t VerticesTransformed = 0;
+		float ACMR = 0.0f;
+		float ATVR = 0.0f;
+	};
+
+	VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+
+	// Reorders triangles for post-transform cache locality (Forsyth's linear-speed
+	// algorithm). dst may alias indices.
+	void OptimizeVertexCache(uint32_t* dst, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	// Numbers vertices in the order the indices first reference them, so vertex fetches
+	// walk the buffer front to back. Apply with RemapVertexBuffer and RemapIndexBuffer.
+	uint32_t GenerateVertexFetchRemap(const uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap);
+
+}
\ No newline at end of file
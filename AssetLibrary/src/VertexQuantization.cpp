@@ -0,0 +1,180 @@
+#include "VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace Assets
+{
+
+	uint16_t EncodeHalf(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		const uint16_t sign = (bits >> 16) & 0x8000;
+		const uint32_t magnitude = bits & 0x7fffffff;
+
+		// NaN keeps a quiet payload, infinity and overflow saturate to infinity
+		if (magnitude > 0x7f800000) return sign | 0x7e00;
+		if (magnitude >= 0x477ff000) return sign | 0x7c00;
+
+		// Normal halves: rebias the exponent and round the 13 dropped mantissa bits
+		if (magnitude >= 0x38800000)
+		{
+			const uint32_t rebiased = magnitude - 0x38000000;
+			return sign | (uint16_t)((rebiased + 0xfff + ((rebiased >> 13) & 1)) >> 13);
+		}
+
+		// Subnormal halves, or zero below half the smallest one
+		if (magnitude < 0x33000000) return sign;
+
+		const uint32_t exponent = magnitude >> 23;
+		const uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+		const uint32_t shift = 126 - exponent;
+
+		const uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t midpoint = 1u << (shift - 1);
+
+		return sign | (uint16_t)(half + (remainder > midpoint || (remainder == midpoint && (half & 1))));
+	}
+
+	float DecodeHalf(uint16_t value)
+	{
+		const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+		const uint32_t exponent = (value >> 10) & 0x1f;
+		const uint32_t mantissa = value & 0x3ff;
+
+		uint32_t bits;
+
+		if (exponent == 0x1f)
+			bits = sign | 0x7f800000 | (mantissa << 13);
+
+		else if (exponent != 0)
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+		else
+		{
+			const float magnitude = std::ldexp((float)mantissa, -24);
+			return sign != 0 ? -magnitude : magnitude;
+		}
+
+		float result;
+		memcpy(&result, &bits, sizeof(result));
+
+		return result;
+	}
+
+	static int16_t EncodeSnorm16(float value)
+	{
+		return (int16_t)std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+	}
+
+	void EncodeOctahedral(const float* normal, int16_t* encoded)
+	{
+		const float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+
+		if (length == 0.0f)
+		{
+			encoded[0] = encoded[1] = 0;
+			return;
+		}
+
+		float x = normal[0] / length, y = normal[1] / length;
+
+		// The lower hemisphere folds over the diagonals into the corners
+		if (normal[2] < 0.0f)
+		{
+			const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+			x = fx; y = fy;
+		}
+
+		encoded[0] = EncodeSnorm16(x);
+		encoded[1] = EncodeSnorm16(y);
+	}
+
+	void DecodeOctahedral(const int16_t* encoded, float* normal)
+	{
+		float x = std::max(encoded[0] / 32767.0f, -1.0f);
+		float y = std::max(encoded[1] / 32767.0f, -1.0f);
+		const float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+		const float t = std::max(-z, 0.0f);
+		x += x >= 0.0f ? -t : t;
+		y += y >= 0.0f ? -t : t;
+
+		const float length = std::sqrt(x * x + y * y + z * z);
+
+		normal[0] = x / length;
+		normal[1] = y / length;
+		normal[2] = z / length;
+	}
+
+	void PackVertices(VertexPackedPosColNorUV* dst, const VertexPosColNorUV* src, size_t vertexCount, MeshAssetInfo* info)
+	{
+		float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				minimum[k] = std::min(minimum[k], src[v].Position[k]);
+				maximum[k] = std::max(maximum[k], src[v].Position[k]);
+			}
+		}
+
+		info->Format = VertexFormat::PackedPosColNorUV;
+
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			info->PositionOffset[k] = vertexCount > 0 ? minimum[k] : 0.0f;
+			info->PositionScale[k] = vertexCount > 0 ? maximum[k] - minimum[k] : 0.0f;
+		}
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			VertexPackedPosColNorUV& out = dst[v];
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const float scale = info->PositionScale[k];
+				const float t = scale > 0.0f ? (src[v].Position[k] - info->PositionOffset[k]) / scale : 0.0f;
+
+				out.Position[k] = (uint16_t)std::lround(std::clamp(t, 0.0f, 1.0f) * 65535.0f);
+				out.Color[k] = (uint8_t)std::lround(std::clamp(src[v].Color[k], 0.0f, 1.0f) * 255.0f);
+			}
+
+			out.Position[3] = 0;
+			out.Color[3] = 255;
+
+			EncodeOctahedral(src[v].Normal, out.Normal);
+
+			out.UV[0] = EncodeHalf(src[v].UV[0]);
+			out.UV[1] = EncodeHalf(src[v].UV[1]);
+		}
+	}
+
+	void UnpackVertices(VertexPosColNorUV* dst, const VertexPackedPosColNorUV* src, size_t vertexCount, const MeshAssetInfo* info)
+	{
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			VertexPosColNorUV& out = dst[v];
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				out.Position[k] = info->PositionOffset[k] + src[v].Position[k] / 65535.0f * info->PositionScale[k];
+				out.Color[k] = src[v].Color[k] / 255.0f;
+			}
+
+			DecodeOctahedral(src[v].Normal, out.Normal);
+
+			out.UV[0] = DecodeHalf(src[v].UV[0]);
+			out.UV[1] = DecodeHalf(src[v].UV[1]);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "MeshAsset.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Assets
+{
+
+	// IEEE half precision, rounding to nearest even; out of range values become infinity
+	uint16_t EncodeHalf(float value);
+	float DecodeHalf(uint16_t value);
+
+	// Projects a unit normal onto the octahedron and unfolds it into [-1, 1]^2 as snorm16
+	void EncodeOctahedral(const float* normal, int16_t* encoded);
+	void DecodeOctahedral(const int16_t* encoded, float* normal);
+
+	// Quantizes positions to the bounds of src, which are stored in info along with the format.
+	// Colors are clamped to [0, 1].
+	void PackVertices(VertexPackedPosColNorUV* dst, const VertexPosColNorUV* src, size_t vertexCount, MeshAssetInfo* info);
+	void UnpackVertices(VertexPosColNorUV* dst, const VertexPackedPosColNorUV* src, size_t vertexCount, const MeshAssetInfo* info);
+
+}
\ No newline at end of file
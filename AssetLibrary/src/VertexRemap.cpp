@@ -0,0 +1,196 @@
+#include "VertexRemap.hpp"
+
+#include "Asset.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace Assets
+{
+
+	// Open addressing with linear probing, sized once so the load factor stays below 0.8
+	struct VertexTable
+	{
+		std::vector<uint32_t> Slots;
+		size_t Mask;
+
+		VertexTable(size_t count)
+		{
+			size_t size = 16;
+			while (size < count + count / 4) size *= 2;
+
+			Slots.assign(size, InvalidVertex);
+			Mask = size - 1;
+		}
+	};
+
+	struct WeldCell
+	{
+		int64_t Coords[3];
+	};
+
+	// Cells are twice epsilon wide, so anything within epsilon of a position is either in
+	// its cell or in the neighbour across the nearer boundary on each axis
+	static WeldCell GetWeldCell(const float* position, float epsilon, int64_t* nearest = nullptr)
+	{
+		WeldCell cell;
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			const double scaled = (double)position[i] / (2.0 * epsilon);
+			cell.Coords[i] = (int64_t)std::floor(scaled);
+
+			if (nearest != nullptr)
+				nearest[i] = scaled - (double)cell.Coords[i] < 0.5 ? -1 : 1;
+		}
+
+		return cell;
+	}
+
+	static bool IsWithinEpsilon(const float* a, const float* b, size_t count, float epsilon)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (std::fabs(a[i] - b[i]) > epsilon)
+				return false;
+		}
+
+		return true;
+	}
+
+	static uint32_t RemapExact(const uint8_t* vertices, size_t vertexCount, size_t vertexSize, const uint32_t* indices, size_t indexCount, std::vector<uint32_t>& remap)
+	{
+		VertexTable table(vertexCount);
+		uint32_t unique = 0;
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			const uint32_t v = indices != nullptr ? indices[i] : (uint32_t)i;
+
+			if (remap[v] != InvalidVertex) continue;
+
+			const uint8_t* data = vertices + v * vertexSize;
+			size_t slot = HashContent(data, vertexSize) & table.Mask;
+
+			while (true)
+			{
+				const uint32_t existing = table.Slots[slot];
+
+				if (existing == InvalidVertex)
+				{
+					table.Slots[slot] = v;
+					remap[v] = unique++;
+					break;
+				}
+
+				if (memcmp(vertices + existing * vertexSize, data, vertexSize) == 0)
+				{
+					remap[v] = remap[existing];
+					break;
+				}
+
+				slot = (slot + 1) & table.Mask;
+			}
+		}
+
+		return unique;
+	}
+
+	// Welds the unique vertices found by RemapExact, given as one vertex of each in order
+	static uint32_t RemapWelded(const uint8_t* vertices, size_t vertexSize, const std::vector<uint32_t>& firsts, std::vector<uint32_t>& remap, float epsilon)
+	{
+		VertexTable table(firsts.size());
+		std::vector<WeldCell> cells(firsts.size());
+		uint32_t unique = 0;
+
+		const size_t floatCount = vertexSize / sizeof(float);
+		remap.assign(firsts.size(), InvalidVertex);
+
+		for (uint32_t i = 0; i < (uint32_t)firsts.size(); i++)
+		{
+			const float* data = (const float*)(vertices + firsts[i] * vertexSize);
+
+			int64_t nearest[3];
+			cells[i] = GetWeldCell(data, epsilon, nearest);
+
+			for (uint32_t n = 0; n < 8 && remap[i] == InvalidVertex; n++)
+			{
+				WeldCell neighbour = cells[i];
+
+				for (uint32_t axis = 0; axis < 3; axis++)
+				{
+					if (n & (1 << axis)) neighbour.Coords[axis] += nearest[axis];
+				}
+
+				size_t slot = HashContent(&neighbour, sizeof(WeldCell)) & table.Mask;
+
+				for (uint32_t existing; (existing = table.Slots[slot]) != InvalidVertex; slot = (slot + 1) & table.Mask)
+				{
+					if (memcmp(&cells[existing], &neighbour, sizeof(WeldCell)) != 0) continue;
+
+					if (IsWithinEpsilon((const float*)(vertices + firsts[existing] * vertexSize), data, floatCount, epsilon))
+					{
+						remap[i] = remap[existing];
+						break;
+					}
+				}
+			}
+
+			if (remap[i] != InvalidVertex) continue;
+
+			size_t slot = HashContent(&cells[i], sizeof(WeldCell)) & table.Mask;
+
+			while (table.Slots[slot] != InvalidVertex)
+				slot = (slot + 1) & table.Mask;
+
+			table.Slots[slot] = i;
+			remap[i] = unique++;
+		}
+
+		return unique;
+	}
+
+	uint32_t GenerateVertexRemap(const void* vertices, size_t vertexCount, size_t vertexSize, const uint32_t* indices, size_t indexCount, std::vector<uint32_t>& remap, float epsilon)
+	{
+		remap.assign(vertexCount, InvalidVertex);
+
+		if (indices == nullptr) indexCount = vertexCount;
+
+		const uint32_t unique = RemapExact((const uint8_t*)vertices, vertexCount, vertexSize, indices, indexCount, remap);
+
+		if (epsilon <= 0.0f) return unique;
+
+		// Exact duplicates go first, so the neighbourhood search only runs once per value
+		std::vector<uint32_t> firsts(unique), welded;
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			if (remap[i] != InvalidVertex) firsts[remap[i]] = (uint32_t)i;
+		}
+
+		const uint32_t weldedCount = RemapWelded((const uint8_t*)vertices, vertexSize, firsts, welded, epsilon);
+
+		for (auto& r : remap)
+		{
+			if (r != InvalidVertex) r = welded[r];
+		}
+
+		return weldedCount;
+	}
+
+	void RemapVertexBuffer(void* dst, const void* vertices, size_t vertexCount, size_t vertexSize, const std::vector<uint32_t>& remap)
+	{
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			if (remap[i] != InvalidVertex)
+				memcpy((uint8_t*)dst + remap[i] * vertexSize, (const uint8_t*)vertices + i * vertexSize, vertexSize);
+		}
+	}
+
+	void RemapIndexBuffer(uint32_t* dst, const uint32_t* indices, size_t indexCount, const std::vector<uint32_t>& remap)
+	{
+		for (size_t i = 0; i < indexCount; i++)
+			dst[i] = remap[indices != nullptr ? indices[i] : i];
+	}
+
+}
\ No newline at end of file
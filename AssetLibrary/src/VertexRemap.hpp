@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Assets
+{
+
+	static const uint32_t InvalidVertex = ~0u;
+
+	// Maps every vertex to the first one with identical bytes, numbered in the order the
+	// indices (or the vertices themselves, when indices is null) first reference them.
+	// Unreferenced vertices map to InvalidVertex. Returns the number of unique vertices.
+	//
+	// With epsilon > 0 vertices are welded instead: every vertex is read as floats, the
+	// first three being the position, and merges with an earlier unique vertex when all
+	// of its components are within epsilon of it.
+	uint32_t GenerateVertexRemap(const void* vertices, size_t vertexCount, size_t vertexSize, const uint32_t* indices, size_t indexCount, std::vector<uint32_t>& remap, float epsilon = 0.0f);
+
+	// dst must hold as many vertices as GenerateVertexRemap returned
+	void RemapVertexBuffer(void* dst, const void* vertices, size_t vertexCount, size_t vertexSize, const std::vector<uint32_t>& remap);
+
+	// With a null indices the vertices are assumed unindexed, as in GenerateVertexRemap
+	void RemapIndexBuffer(uint32_t* dst, const uint32_t* indices, size_t indexCount, const std::vector<uint32_t>& remap);
+
+}
\ No newline at end of file
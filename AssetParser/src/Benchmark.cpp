@@ -0,0 +1,842 @@
+#include "Benchmark.hpp"
+#include "DictionaryTrainer.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+
+struct MetadataTimings
+{
+	uint32_t Files = 0;
+	double JsonTime = 0.0;
+	double BinaryTime = 0.0;
+	size_t JsonBytes = 0;
+	size_t BinaryBytes = 0;
+};
+
+static double TimeIterations(uint32_t iterations, const std::function<void()>& fn)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < iterations; i++)
+		fn();
+
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / iterations;
+}
+
+static bool RepackMetadata(Assets::Asset& file, uint32_t version, Assets::Asset& out)
+{
+	if (memcmp(file.Type, "MESH", 4) == 0)
+	{
+		auto info = Assets::ParseMeshAssetInfo(&file);
+
+		std::vector<uint8_t> vbo(info.VertexBufferSize), ibo(info.IndexBufferSize);
+
+		if (!Assets::UnpackMesh(&info, file.Binary.data(), file.Binary.size(), vbo.data(), ibo.data()))
+			return false;
+
+		std::vector<Assets::Meshlet> meshlets(info.MeshletCount);
+		Assets::UnpackMeshlets(&info, file.Binary.data(), file.Binary.size(), meshlets.data());
+
+		std::vector<Assets::MeshLod> lods(info.LodCount);
+		Assets::UnpackMeshLods(&info, file.Binary.data(), file.Binary.size(), lods.data());
+
+		out = Assets::PackMesh(&info, vbo.data(), ibo.data(), version, meshlets.data(), lods.data());
+		return true;
+	}
+
+	if (memcmp(file.Type, "TEXI", 4) == 0)
+	{
+		auto info = Assets::ParseTextureAssetInfo(&file);
+
+		std::vector<uint8_t> pixels(info.FileSize);
+
+		if (!Assets::UnpackTexture(&info, file.Binary.data(), pixels.data(), file.Binary.size()))
+			return false;
+
+		std::vector<Assets::TextureMip> mips(std::max(info.MipLevels, 1u));
+		Assets::UnpackTextureMips(&info, file.Binary.data(), file.Binary.size(), mips.data());
+
+		out = Assets::PackTexture(&info, pixels.data(), version, mips.data());
+		return true;
+	}
+
+	if (memcmp(file.Type, "MATX", 4) == 0)
+	{
+		auto info = Assets::ParseMaterialAssetInfo(&file);
+		out = Assets::PackMaterial(&info, version);
+		return true;
+	}
+
+	if (memcmp(file.Type, "PRFB", 4) == 0)
+	{
+		auto info = Assets::ParsePrefabAssetInfo(&file);
+		out = Assets::PackPrefabAsset(&info, version);
+		return true;
+	}
+
+	return false;
+}
+
+static double TimeParse(Assets::Asset& file, uint32_t iterations)
+{
+	volatile size_t sink = 0;
+
+	if (memcmp(file.Type, "MESH", 4) == 0)
+		return TimeIterations(iterations, [&]() { sink += Assets::ParseMeshAssetInfo(&file).VertexBufferSize; });
+
+	if (memcmp(file.Type, "TEXI", 4) == 0)
+		return TimeIterations(iterations, [&]() { sink += Assets::ParseTextureAssetInfo(&file).FileSize; });
+
+	if (memcmp(file.Type, "MATX", 4) == 0)
+		return TimeIterations(iterations, [&]() { sink += Assets::ParseMaterialAssetInfo(&file).Textures.size(); });
+
+	return TimeIterations(iterations, [&]() { sink += Assets::ParsePrefabAssetInfo(&file).NodeNames.size(); });
+}
+
+// Compares Parse*AssetInfo on JSON (version 1) and binary (version 2) metadata for
+// every asset found in the input directory
+static int RunMetadataBenchmark(const ParserOptions& options)
+{
+	const uint32_t iterations = 1000;
+	std::map<std::string, MetadataTimings> timings;
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		const auto ext = it.path().extension();
+
+		if (ext != ".mesh" && ext != ".texi" && ext != ".matx" && ext != ".prfb")
+			continue;
+
+		Assets::Asset file = {};
+
+		if (!Assets::LoadBinary(it.path().c_str(), file))
+			continue;
+
+		Assets::Asset jsonFile = {}, binaryFile = {};
+
+		if (!RepackMetadata(file, Assets::AssetVersionJson, jsonFile)) continue;
+		if (!RepackMetadata(file, Assets::AssetVersionBinary, binaryFile)) continue;
+
+		auto& t = timings[ext.string()];
+
+		t.Files++;
+		t.JsonBytes += jsonFile.Json.size();
+		t.BinaryBytes += binaryFile.Json.size();
+		t.JsonTime += TimeParse(jsonFile, iterations);
+		t.BinaryTime += TimeParse(binaryFile, iterations);
+	}
+
+	if (timings.empty())
+	{
+		std::cout << "-- No assets found in " << options.Input.c_str() << " --\n";
+		return 1;
+	}
+
+	std::cout << "-- Metadata parse time per asset (" << iterations << " iterations) --\n";
+
+	for (const auto& [ext, t] : timings)
+	{
+		std::cout << "   " << ext << " x" << t.Files
+			<< ": json " << t.JsonTime / t.Files << " us (" << t.JsonBytes / t.Files << " B)"
+			<< ", binary " << t.BinaryTime / t.Files << " us (" << t.BinaryBytes / t.Files << " B)"
+			<< ", speedup " << t.JsonTime / t.BinaryTime << "x\n";
+	}
+
+	return 0;
+}
+
+// Compares the legacy mesh load path (decompress into a temporary, split it into vertex
+// and index vectors, copy those into staging) with decompressing straight into staging
+static int RunUploadBenchmark(const ParserOptions& options)
+{
+	const uint32_t iterations = 100;
+
+	size_t totalSize = 0, legacyBytes = 0, directBytes = 0;
+	double legacyTime = 0.0, directTime = 0.0;
+	uint32_t meshCount = 0;
+
+	std::cout << "-- Mesh upload bytes copied and time per mesh (" << iterations << " iterations) --\n";
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		if (it.path().extension() != ".mesh")
+			continue;
+
+		Assets::AssetView file = {};
+
+		if (!Assets::MapBinary(it.path().c_str(), file))
+			continue;
+
+		auto info = Assets::ParseMeshAssetInfo(&file);
+		const size_t size = info.VertexBufferSize + info.IndexBufferSize;
+
+		// Stand-in for the mapped staging allocation
+		std::vector<uint8_t> staging(size);
+		std::vector<uint8_t> vertices(info.VertexBufferSize), indices(info.IndexBufferSize);
+
+		const double legacy = TimeIterations(iterations, [&]()
+		{
+			Assets::UnpackMesh(&info, file.Binary.Data, file.Binary.Size, vertices.data(), indices.data());
+
+			memcpy(staging.data(), vertices.data(), info.VertexBufferSize);
+			memcpy(staging.data() + info.VertexBufferSize, indices.data(), info.IndexBufferSize);
+		});
+
+		const double direct = TimeIterations(iterations, [&]()
+		{
+			Assets::UnpackMesh(&info, file.Binary.Data, file.Binary.Size, staging.data());
+		});
+
+		Assets::UnmapBinary(file);
+
+		// Decompression writes the payload once, every intermediate buffer adds a full copy
+		const size_t legacyCopied = (info.Compression == Assets::CompressionMode::None ? 2 : 3) * size;
+
+		std::cout << "   " << it.path().filename().c_str() << " (" << size << " B): legacy " << legacyCopied << " B in " << legacy
+			<< " us, direct " << size << " B in " << direct << " us\n";
+
+		meshCount++;
+		totalSize += size;
+		legacyBytes += legacyCopied;
+		directBytes += size;
+		legacyTime += legacy;
+		directTime += direct;
+	}
+
+	if (meshCount == 0)
+	{
+		std::cout << "-- No meshes found in " << options.Input.c_str() << " --\n";
+		return 1;
+	}
+
+	std::cout << "-- " << meshCount << " meshes, " << totalSize << " B: legacy " << legacyBytes / meshCount << " B/mesh in " << legacyTime / meshCount
+		<< " us, direct " << directBytes / meshCount << " B/mesh in " << directTime / meshCount << " us --\n";
+
+	return 0;
+}
+
+// Compares decoding texture and mesh payloads as a single LZ4 block with decoding the
+// block-split layout across the TaskPool workers
+static int RunDecompressBenchmark(const ParserOptions& options)
+{
+	const uint32_t iterations = 20;
+	const uint32_t blockSize = options.BlockSize > 0 ? options.BlockSize : 256 * 1024;
+
+	double serialTime = 0.0, parallelTime = 0.0;
+	size_t totalSize = 0;
+	uint32_t fileCount = 0;
+
+	std::cout << "-- Payload decode time per asset, " << blockSize / 1024 << " KiB blocks, "
+		<< Assets::TaskPool::Get().GetWorkerCount() + 1 << " threads (" << iterations << " iterations) --\n";
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		const auto ext = it.path().extension();
+
+		if (ext != ".mesh" && ext != ".texi")
+			continue;
+
+		Assets::Asset file = {};
+
+		if (!Assets::LoadBinary(it.path().c_str(), file))
+			continue;
+
+		std::vector<uint8_t> data;
+		std::function<void(Assets::Asset&)> unpack;
+
+		if (ext == ".mesh")
+		{
+			auto info = Assets::ParseMeshAssetInfo(&file);
+			data.resize(info.VertexBufferSize + info.IndexBufferSize);
+
+			Assets::UnpackMesh(&info, file.Binary.data(), file.Binary.size(), data.data());
+
+			unpack = [&data](Assets::Asset& f)
+			{
+				auto info = Assets::ParseMeshAssetInfo(&f);
+				Assets::UnpackMesh(&info, f.Binary.data(), f.Binary.size(), data.data());
+			};
+		}
+
+		else
+		{
+			auto info = Assets::ParseTextureAssetInfo(&file);
+			data.resize(info.FileSize);
+
+			Assets::UnpackTexture(&info, file.Binary.data(), data.data(), file.Binary.size());
+
+			unpack = [&data](Assets::Asset& f)
+			{
+				auto info = Assets::ParseTextureAssetInfo(&f);
+				Assets::UnpackTexture(&info, f.Binary.data(), data.data(), f.Binary.size());
+			};
+		}
+
+		Assets::Asset serialFile = {}, parallelFile = {};
+
+		// Swap the payload layout without touching the rest of the metadata
+		const auto repack = [&](uint32_t size, Assets::Asset& out)
+		{
+			if (ext == ".mesh")
+			{
+				auto info = Assets::ParseMeshAssetInfo(&file);
+				info.BlockSize = size;
+
+				std::vector<Assets::Meshlet> meshlets(info.MeshletCount);
+				Assets::UnpackMeshlets(&info, file.Binary.data(), file.Binary.size(), meshlets.data());
+
+				std::vector<Assets::MeshLod> lods(info.LodCount);
+				Assets::UnpackMeshLods(&info, file.Binary.data(), file.Binary.size(), lods.data());
+
+				out = Assets::PackMesh(&info, data.data(), data.data() + info.VertexBufferSize, file.Version, meshlets.data(), lods.data());
+				return;
+			}
+
+			auto info = Assets::ParseTextureAssetInfo(&file);
+			info.BlockSize = size;
+
+			std::vector<Assets::TextureMip> mips(std::max(info.MipLevels, 1u));
+			Assets::UnpackTextureMips(&info, file.Binary.data(), file.Binary.size(), mips.data());
+
+			out = Assets::PackTexture(&info, data.data(), file.Version, mips.data());
+		};
+
+		repack(0, serialFile);
+		repack(blockSize, parallelFile);
+
+		const double serial = TimeIterations(iterations, [&]() { unpack(serialFile); });
+		const double parallel = TimeIterations(iterations, [&]() { unpack(parallelFile); });
+
+		std::cout << "   " << it.path().filename().c_str() << " (" << data.size() << " B): single block " << serial
+			<< " us, " << (data.size() + blockSize - 1) / blockSize << " blocks " << parallel << " us\n";
+
+		fileCount++;
+		totalSize += data.size();
+		serialTime += serial;
+		parallelTime += parallel;
+	}
+
+	if (fileCount == 0)
+	{
+		std::cout << "-- No meshes or textures found in " << options.Input.c_str() << " --\n";
+		return 1;
+	}
+
+	std::cout << "-- " << fileCount << " assets, " << totalSize << " B: single block " << serialTime / fileCount
+		<< " us/asset, parallel " << parallelTime / fileCount << " us/asset, speedup " << serialTime / parallelTime << "x --\n";
+
+	return 0;
+}
+
+// Compares plain LZ4 on the raw mesh payload with LZ4 on the byte-shuffled and delta-encoded
+// one, as single blocks without a dictionary, and times the filter decode on its own
+static int RunMeshFilterBenchmark(const ParserOptions& options)
+{
+	const uint32_t iterations = 20;
+
+	size_t totalSize = 0, plainSize = 0, filteredSize = 0;
+	double plainTime = 0.0, filteredTime = 0.0, filterTime = 0.0;
+	uint32_t meshCount = 0;
+
+	std::cout << "-- Mesh payload size and decode time, LZ4 vs filter + LZ4 (" << iterations << " iterations) --\n";
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		if (it.path().extension() != ".mesh")
+			continue;
+
+		Assets::Asset file = {};
+
+		if (!Assets::LoadBinary(it.path().c_str(), file))
+			continue;
+
+		auto info = Assets::ParseMeshAssetInfo(&file);
+
+		std::vector<uint8_t> data(info.VertexBufferSize + info.IndexBufferSize);
+		Assets::UnpackMesh(&info, file.Binary.data(), file.Binary.size(), data.data());
+
+		info.Compression = Assets::CompressionMode::LZ4;
+		info.CompressionLevel = 0;
+		info.BlockSize = 0;
+		info.DictionaryId = 0;
+
+		info.Filter = Assets::MeshFilter::None;
+		Assets::Asset plainFile = Assets::PackMesh(&info, data.data(), data.data() + info.VertexBufferSize, file.Version);
+
+		info.Filter = Assets::MeshFilter::DeltaShuffle;
+		Assets::Asset filteredFile = Assets::PackMesh(&info, data.data(), data.data() + info.VertexBufferSize, file.Version);
+
+		std::vector<uint8_t> filtered(data.size()), scratch(data.size());
+		Assets::EncodeMeshFilter(&info, data.data(), data.data() + info.VertexBufferSize, filtered.data());
+
+		const auto unpack = [&scratch](Assets::Asset& f)
+		{
+			auto info = Assets::ParseMeshAssetInfo(&f);
+			Assets::UnpackMesh(&info, f.Binary.data(), f.Binary.size(), scratch.data());
+		};
+
+		const double plain = TimeIterations(iterations, [&]() { unpack(plainFile); });
+		const double filter = TimeIterations(iterations, [&]() { unpack(filteredFile); });
+		const double decode = TimeIterations(iterations, [&]() { Assets::DecodeMeshFilter(&info, filtered.data(), scratch.data()); });
+
+		std::cout << "   " << it.path().filename().c_str() << " (" << data.size() << " B): LZ4 " << plainFile.Binary.size() << " B in " << plain
+			<< " us, filter + LZ4 " << filteredFile.Binary.size() << " B in " << filter << " us, filter alone " << data.size() / decode << " MB/s\n";
+
+		meshCount++;
+		totalSize += data.size();
+		plainSize += plainFile.Binary.size();
+		filteredSize += filteredFile.Binary.size();
+		plainTime += plain;
+		filteredTime += filter;
+		filterTime += decode;
+	}
+
+	if (meshCount == 0)
+	{
+		std::cout << "-- No meshes found in " << options.Input.c_str() << " --\n";
+		return 1;
+	}
+
+	std::cout << "-- " << meshCount << " meshes, " << totalSize << " B: LZ4 ratio " << (double)totalSize / plainSize << " at " << totalSize / plainTime
+		<< " MB/s, filter + LZ4 ratio " << (double)totalSize / filteredSize << " at " << totalSize / filteredTime << " MB/s, filter decode " << totalSize / filterTime << " MB/s --\n";
+
+	return 0;
+}
+
+static double GetPsnr(double squaredError, size_t count)
+{
+	return squaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 * count / squaredError) : INFINITY;
+}
+
+static const Assets::TextureFormat BenchmarkFormats[] = { Assets::TextureFormat::BC1, Assets::TextureFormat::BC3, Assets::TextureFormat::BC5, Assets::TextureFormat::BC7 };
+static const uint32_t BenchmarkChannels[] = { 3, 4, 2, 4 };
+
+// Compresses an RGBA8 image into each BC format, printing and adding up the encode time and the
+// squared error over the channels each format keeps
+static void CompressImage(const uint8_t* data, uint32_t width, uint32_t height, double* totalTime, double* totalError)
+{
+	const size_t texels = (size_t)width * height;
+	std::vector<uint8_t> decoded(texels * 4);
+
+	for (uint32_t f = 0; f < 4; f++)
+	{
+		std::vector<uint8_t> blocks(Assets::GetTextureLevelSize(BenchmarkFormats[f], width, height));
+
+		const double time = TimeIterations(1, [&]() { Assets::CompressBlocks(BenchmarkFormats[f], blocks.data(), data, width, height); });
+		Assets::DecompressBlocks(BenchmarkFormats[f], decoded.data(), blocks.data(), width, height);
+
+		double error = 0.0;
+
+		for (size_t i = 0; i < texels; i++)
+		{
+			for (uint32_t c = 0; c < BenchmarkChannels[f]; c++)
+			{
+				const double d = (double)decoded[i * 4 + c] - data[i * 4 + c];
+				error += d * d;
+			}
+		}
+
+		totalTime[f] += time;
+		totalError[f] += error / BenchmarkChannels[f];
+
+		std::cout << ' ' << Assets::GetTextureFormatName(BenchmarkFormats[f]) << ' ' << GetPsnr(error, texels * BenchmarkChannels[f]) << " dB " << texels / time << " MP/s";
+	}
+
+	std::cout << '\n';
+}
+
+// Compresses the base level of every source image into each BC format and reports encode speed
+// and PSNR over the channels the format keeps
+static int RunBlockCompressionBenchmark(const ParserOptions& options)
+{
+	double totalTime[4] = {}, totalError[4] = {};
+	size_t totalTexels = 0;
+	uint32_t imageCount = 0;
+
+	std::cout << "-- Block compression PSNR and encode speed per image, " << Assets::TaskPool::Get().GetWorkerCount() + 1 << " threads --\n";
+
+	// Red rising while green falls across every block: the principal axis has channels moving in
+	// opposite directions, which endpoint search has to find instead of treating blocks as flat
+	{
+		const uint32_t size = 64;
+		std::vector<uint8_t> image(size * size * 4);
+
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				const uint8_t value = (uint8_t)((x % 4 + (y % 4) * 4) * 17);
+				uint8_t* texel = &image[(y * size + x) * 4];
+
+				texel[0] = value;
+				texel[1] = 255 - value;
+				texel[2] = 128;
+				texel[3] = 255;
+			}
+		}
+
+		double time[4] = {}, error[4] = {};
+
+		std::cout << "   red/green gradient (" << size << "x" << size << "):";
+		CompressImage(image.data(), size, size, time, error);
+	}
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		const auto ext = it.path().extension();
+
+		if (ext != ".png" && ext != ".jpg")
+			continue;
+
+		int width, height, nrChannels;
+		uint8_t* data = stbi_load(it.path().c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+
+		if (data == nullptr)
+			continue;
+
+		std::cout << "   " << it.path().filename().c_str() << " (" << width << "x" << height << "):";
+		CompressImage(data, width, height, totalTime, totalError);
+
+		stbi_image_free(data);
+
+		totalTexels += (size_t)width * height;
+		imageCount++;
+	}
+
+	if (imageCount == 0)
+	{
+		std::cout << "-- No images found in " << options.Input.c_str() << " --\n";
+		return 1;
+	}
+
+	std::cout << "-- " << imageCount << " images, " << totalTexels << " texels:";
+
+	for (uint32_t f = 0; f < 4; f++)
+		std::cout << ' ' << Assets::GetTextureFormatName(BenchmarkFormats[f]) << ' ' << GetPsnr(totalError[f], totalTexels) << " dB " << totalTexels / totalTime[f] << " MP/s";
+
+	std::cout << " --\n";
+
+	return 0;
+}
+
+// The std::hash specialization meshes used to be deduplicated with: it hashes sums of
+// components, so every permutation of the same values lands in one bucket
+struct LegacyVertexHash
+{
+	size_t operator()(const Assets::VertexPosColNorUV& v) const
+	{
+		return ((std::hash<float>()(v.Position[0] + v.Position[1] + v.Position[2]) ^ (std::hash<float>()(v.Normal[0] + v.Normal[1] + v.Normal[2]) << 1) ^ (std::hash<float>()(v.Color[0] + v.Color[1] + v.Color[2]) << 2)) >> 1) ^ (std::hash<float>()(v.UV[0] + v.UV[1]) << 1);
+	}
+};
+
+// Unindexed triangle list of a size x size quad grid, as an OBJ import would produce it
+static void GenerateGridCorners(uint32_t size, std::vector<Assets::VertexPosColNorUV>& corners)
+{
+	static const uint32_t quadCorners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+
+	corners.clear();
+	corners.reserve((size_t)size * size * 6);
+
+	for (uint32_t y = 0; y < size; y++)
+	{
+		for (uint32_t x = 0; x < size; x++)
+		{
+			for (const auto& c : quadCorners)
+			{
+				Assets::VertexPosColNorUV v = {};
+
+				v.Position[0] = (float)(x + c[0]);
+				v.Position[1] = (float)(y + c[1]);
+				v.Normal[2] = 1.0f;
+				v.UV[0] = (float)(x + c[0]) / size;
+				v.UV[1] = (float)(y + c[1]) / size;
+				v.Color[0] = 1.0f; v.Color[1] = 1.0f; v.Color[2] = 1.0f;
+
+				corners.push_back(v);
+			}
+		}
+	}
+}
+
+// Compares the old unordered_map deduplication with GenerateVertexRemap, exact and
+// welded, on generated grids of up to two million triangles
+static int RunWeldBenchmark(const ParserOptions& options)
+{
+	const float epsilon = options.WeldEpsilon > 0.0f ? options.WeldEpsilon : 1e-5f;
+
+	std::cout << "-- Vertex deduplication time per mesh, weld epsilon " << epsilon << " --\n";
+
+	for (uint32_t size : { 64u, 256u, 1024u })
+	{
+		std::vector<Assets::VertexPosColNorUV> corners;
+		GenerateGridCorners(size, corners);
+
+		size_t legacyCount = 0, exactCount = 0, weldedCount = 0;
+
+		const double legacy = TimeIterations(1, [&]()
+		{
+			std::unordered_map<Assets::VertexPosColNorUV, uint32_t, LegacyVertexHash> unique;
+
+			for (const auto& v : corners)
+				unique.emplace(v, (uint32_t)unique.size());
+
+			legacyCount = unique.size();
+		});
+
+		std::vector<uint32_t> remap;
+
+		const double exact = TimeIterations(1, [&]()
+		{
+			exactCount = Assets::GenerateVertexRemap(corners.data(), corners.size(), sizeof(Assets::VertexPosColNorUV), nullptr, 0, remap);
+		});
+
+		const double welded = TimeIterations(1, [&]()
+		{
+			weldedCount = Assets::GenerateVertexRemap(corners.data(), corners.size(), sizeof(Assets::VertexPosColNorUV), nullptr, 0, remap, epsilon);
+		});
+
+		std::cout << "   " << (size_t)size * size * 2 << " triangles, " << corners.size() << " corners: legacy " << legacy / 1000.0 << " ms ("
+			<< legacyCount << " vertices), remap " << exact / 1000.0 << " ms (" << exactCount << "), welded " << welded / 1000.0 << " ms (" << weldedCount << ")\n";
+	}
+
+	return 0;
+}
+
+// Estimates overdraw and vertex cache efficiency of every mesh as stored, and after
+// re-running the cache and overdraw optimizers at a range of thresholds
+static int RunOverdrawBenchmark(const ParserOptions& options)
+{
+	uint32_t meshCount = 0;
+
+	std::cout << "-- Overdraw and ACMR per mesh, stored order then by overdraw threshold --\n";
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		if (it.path().extension() != ".mesh")
+			continue;
+
+		Assets::Asset file = {};
+
+		if (!Assets::LoadBinary(it.path().c_str(), file))
+			continue;
+
+		auto info = Assets::ParseMeshAssetInfo(&file);
+
+		if (info.Format != Assets::VertexFormat::PosColNorUV && info.Format != Assets::VertexFormat::PackedPosColNorUV)
+			continue;
+
+		std::vector<uint8_t> vertexData(info.VertexBufferSize), indexData(info.IndexBufferSize);
+		Assets::UnpackMesh(&info, file.Binary.data(), file.Binary.size(), vertexData.data(), indexData.data());
+
+		std::vector<uint32_t> indices(info.IndexBufferSize / Assets::GetIndexSize(info.IndexType));
+
+		if (info.IndexType == Assets::IndexFormat::UInt16)
+			std::copy((const uint16_t*)indexData.data(), (const uint16_t*)indexData.data() + indices.size(), indices.begin());
+
+		else
+			memcpy(indices.data(), indexData.data(), info.IndexBufferSize);
+
+		std::vector<Assets::VertexPosColNorUV> vertices(Assets::GetVertexCount(&info));
+
+		// Split streams go back to the interleaved layout of their format first
+		std::vector<uint8_t> interleaved(vertices.size() * Assets::GetVertexSize(info.Format));
+		Assets::ConvertVertexStreams(info.Format, interleaved.data(), 0, vertexData.data(), info.Attributes, vertices.size());
+
+		if (info.Format == Assets::VertexFormat::PackedPosColNorUV)
+			Assets::UnpackVertices(vertices.data(), (const Assets::VertexPackedPosColNorUV*)interleaved.data(), vertices.size(), &info);
+
+		else
+			memcpy(vertices.data(), interleaved.data(), interleaved.size());
+
+		// Only the full detail level, the others follow it in the index buffer
+		std::vector<Assets::MeshLod> lods(info.LodCount);
+
+		if (!lods.empty() && Assets::UnpackMeshLods(&info, file.Binary.data(), file.Binary.size(), lods.data()))
+			indices.resize(lods[0].IndexCount);
+
+		if (vertices.empty() || indices.size() < 3)
+			continue;
+
+		const auto measure = [&](const std::vector<uint32_t>& order)
+		{
+			const auto overdraw = Assets::AnalyzeOverdraw(order.data(), order.size(), vertices[0].Position, vertices.size(), sizeof(Assets::VertexPosColNorUV));
+			const auto cache = Assets::AnalyzeVertexCache(order.data(), order.size(), vertices.size());
+
+			std::cout << " " << overdraw.Overdraw << " / " << cache.ACMR;
+		};
+
+		std::cout << "   " << it.path().filename().c_str() << " (" << indices.size() / 3 << " triangles): stored";
+		measure(indices);
+
+		std::vector<uint32_t> cached(indices), sorted(indices.size());
+		Assets::OptimizeVertexCache(cached.data(), cached.data(), cached.size(), vertices.size());
+
+		for (float threshold : { 1.0f, 1.05f, 1.2f, 2.0f })
+		{
+			Assets::OptimizeOverdraw(sorted.data(), cached.data(), cached.size(), vertices[0].Position, vertices.size(), sizeof(Assets::VertexPosColNorUV), threshold);
+
+			std::cout << ", " << threshold << ":";
+			measure(sorted);
+		}
+
+		std::cout << '\n';
+		meshCount++;
+	}
+
+	if (meshCount == 0)
+	{
+		std::cout << "-- No meshes found in " << options.Input.c_str() << " --\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+// Decodes a mesh or texture payload, or returns false when it no longer decodes
+static bool DecodePayload(Assets::Asset& file, std::vector<uint8_t>& data)
+{
+	if (memcmp(file.Type, "MESH", 4) == 0)
+	{
+		auto info = Assets::ParseMeshAssetInfo(&file);
+		data.resize(info.VertexBufferSize + info.IndexBufferSize);
+
+		return Assets::UnpackMesh(&info, file.Binary.data(), file.Binary.size(), data.data());
+	}
+
+	if (memcmp(file.Type, "MATX", 4) == 0)
+	{
+		auto info = Assets::ParseMaterialAssetInfo(&file);
+		const std::string tables = Assets::WriteMaterialTables(&info);
+
+		data.assign(tables.begin(), tables.end());
+
+		return !info.Textures.empty();
+	}
+
+	auto info = Assets::ParseTextureAssetInfo(&file);
+	data.resize(info.FileSize);
+
+	return Assets::UnpackTexture(&info, file.Binary.data(), data.data(), file.Binary.size());
+}
+
+// Trains a dictionary on half of the meshes, textures and materials, then adds the other half and
+// trains again, the way an incremental --dictionary run does. Every asset has to decode to its
+// original bytes afterwards with only the dictionary left on disk loaded.
+static int RunDictionaryBenchmark(const ParserOptions& options)
+{
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "AssetParserDictionary";
+	const std::filesystem::path out = dir / "assets.dict";
+
+	std::vector<std::filesystem::path> paths;
+	std::map<std::string, std::vector<uint8_t>> originals;
+
+	// Assets that already went through --dictionary need theirs to decode
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		if (it.path().extension() == ".dict")
+			Assets::LoadDictionary(it.path().c_str());
+	}
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		const auto ext = it.path().extension();
+
+		if (ext != ".mesh" && ext != ".texi" && ext != ".matx")
+			continue;
+
+		Assets::Asset file = {};
+		std::vector<uint8_t> data;
+
+		if (!Assets::LoadBinary(it.path().c_str(), file) || !DecodePayload(file, data))
+			continue;
+
+		paths.push_back(it.path());
+		originals[it.path().filename().string()] = std::move(data);
+	}
+
+	if (paths.size() < 4)
+	{
+		std::cout << "-- Not enough meshes, textures or materials in " << options.Input.c_str() << " --\n";
+		return 1;
+	}
+
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	for (uint32_t run = 0; run < 2; run++)
+	{
+		for (size_t i = run; i < paths.size(); i += 2)
+			std::filesystem::copy_file(paths[i], dir / paths[i].filename());
+
+		std::cout << "-- Run " << run + 1 << " --\n";
+
+		if (!BuildDirectoryDictionary(dir, out, options))
+		{
+			std::cout << "-- Unable to build the dictionary --\n";
+			return 1;
+		}
+	}
+
+	Assets::UnloadDictionaries();
+	Assets::LoadDictionary(out.c_str());
+
+	uint32_t failed = 0;
+
+	for (auto& [name, original] : originals)
+	{
+		Assets::Asset file = {};
+		std::vector<uint8_t> data;
+
+		if (!Assets::LoadBinary((dir / name).c_str(), file) || !DecodePayload(file, data) || data != original)
+		{
+			std::cout << "   " << name << " no longer decodes\n";
+			failed++;
+		}
+	}
+
+	Assets::UnloadDictionaries();
+	std::filesystem::remove_all(dir);
+
+	std::cout << "-- " << originals.size() - failed << '/' << originals.size() << " assets decode after two runs --\n";
+
+	return failed == 0 ? 0 : 1;
+}
+
+int RunBenchmark(const ParserOptions& options)
+{
+	if (options.Benchmark == "metadata")
+		return RunMetadataBenchmark(options);
+
+	if (options.Benchmark == "upload")
+		return RunUploadBenchmark(options);
+
+	if (options.Benchmark == "decompress")
+		return RunDecompressBenchmark(options);
+
+	if (options.Benchmark == "weld")
+		return RunWeldBenchmark(options);
+
+	if (options.Benchmark == "overdraw")
+		return RunOverdrawBenchmark(options);
+
+	if (options.Benchmark == "meshfilter")
+		return RunMeshFilterBenchmark(options);
+
+	if (options.Benchmark == "blocks")
+		return RunBlockCompressionBenchmark(options);
+
+	if (options.Benchmark == "dictionary")
+		return RunDictionaryBenchmark(options);
+
+	std::cout << "-- Unknown benchmark " << options.Benchmark << " --\n";
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "Options.hpp"
+
+int RunBenchmark(const ParserOptions& options);
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "CompressionSelect.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+struct CompressionCandidate
+{
+	Assets::CompressionMode Mode;
+	int Level;
+};
+
+static const CompressionCandidate s_Candidates[] =
+{
+	{ Assets::CompressionMode::LZ4, 0 },
+	{ Assets::CompressionMode::LZ4HC, 4 },
+	{ Assets::CompressionMode::LZ4HC, 9 },
+	{ Assets::CompressionMode::LZ4HC, 12 },
+};
+
+// Decode cost model in nanoseconds: every LZ4 sequence pays for its token and a likely branch
+// miss, literals are a plain copy and matches a copy that may overlap its own output
+static const double SequenceCost = 4.0;
+static const double LiteralCost = 0.1;
+static const double MatchCost = 0.2;
+
+// Reads an LZ4 length extension: while the last byte read is 255 another one follows
+static bool ReadSequenceLength(const uint8_t*& src, const uint8_t* end, size_t& length)
+{
+	uint8_t byte = 255;
+
+	while (byte == 255)
+	{
+		if (src >= end) return false;
+
+		byte = *src++;
+		length += byte;
+	}
+
+	return true;
+}
+
+// Walks the sequences of one LZ4 block and adds its modeled decode time
+static bool EstimateBlockCost(const uint8_t* src, size_t size, double& cost)
+{
+	const uint8_t* end = src + size;
+
+	while (src < end)
+	{
+		const uint8_t token = *src++;
+		size_t literals = token >> 4;
+
+		if (literals == 15 && !ReadSequenceLength(src, end, literals)) return false;
+		if ((size_t)(end - src) < literals) return false;
+
+		src += literals;
+		cost += SequenceCost + literals * LiteralCost;
+
+		// The last sequence of a block only carries literals
+		if (src == end) break;
+		if (end - src < 2) return false;
+
+		src += 2;
+		size_t match = token & 15;
+
+		if (match == 15 && !ReadSequenceLength(src, end, match)) return false;
+
+		cost += (match + 4) * MatchCost;
+	}
+
+	return true;
+}
+
+// Decode throughput in MB/s from the sequences of the packed payload rather than a timed run,
+// so the choice does not depend on the machine, its load or the worker count
+static double EstimateDecodeSpeed(const ParserOptions& options, Assets::CompressionMode mode, const std::vector<uint8_t>& packed, size_t rawSize)
+{
+	double cost = 0.0;
+
+	if (mode == Assets::CompressionMode::None)
+		cost = rawSize * LiteralCost;
+
+	else if (options.BlockSize == 0)
+	{
+		if (!EstimateBlockCost(packed.data(), packed.size(), cost)) return 0.0;
+	}
+
+	else
+	{
+		// Split payloads start with the block count and count + 1 offsets past the table
+		uint32_t blockCount = 0;
+		memcpy(&blockCount, packed.data(), sizeof(uint32_t));
+
+		const size_t tableSize = ((size_t)blockCount + 2) * sizeof(uint32_t);
+		std::vector<uint32_t> offsets(blockCount + 1);
+
+		memcpy(offsets.data(), packed.data() + sizeof(uint32_t), offsets.size() * sizeof(uint32_t));
+
+		for (uint32_t i = 0; i < blockCount; i++)
+		{
+			if (!EstimateBlockCost(packed.data() + tableSize + offsets[i], offsets[i + 1] - offsets[i], cost)) return 0.0;
+		}
+	}
+
+	return rawSize / (1024.0 * 1024.0) / std::max(cost * 1e-9, 1e-12);
+}
+
+void SelectCompression(const ParserOptions& options, const std::vector<Assets::ByteSpan>& payload, Assets::CompressionMode& mode, int& level, std::ostream& log)
+{
+	mode = options.Compression;
+	level = options.CompressionLevel;
+
+	if (!options.AutoCompression) return;
+
+	std::vector<uint8_t> data;
+
+	for (const auto& p : payload)
+		data.insert(data.end(), p.Data, p.Data + p.Size);
+
+	if (data.empty()) return;
+
+	std::vector<uint8_t> packed;
+	size_t bestSize = SIZE_MAX;
+	double bestSpeed = 0.0;
+
+	for (const auto& c : s_Candidates)
+	{
+		Assets::CompressPayload(c.Mode, c.Level, 0, options.BlockSize, data.data(), data.size(), packed);
+
+		const double speed = EstimateDecodeSpeed(options, c.Mode, packed, data.size());
+
+		if (speed < options.DecodeBudget || packed.size() >= bestSize) continue;
+
+		mode = c.Mode;
+		level = c.Level;
+		bestSize = packed.size();
+		bestSpeed = speed;
+	}
+
+	// Nothing met the budget: fall back to the fastest decoder rather than failing the asset
+	if (bestSize == SIZE_MAX)
+	{
+		mode = Assets::CompressionMode::LZ4;
+		level = 0;
+
+		log << "   -- Compression: no candidate decodes at " << options.DecodeBudget << " MB/s, using LZ4\n";
+		return;
+	}
+
+	log << "   -- Compression: " << Assets::GetCompressionModeName(mode) << " level " << level << ", "
+		<< data.size() << " >> " << bestSize << " B, modeled decode " << (uint32_t)bestSpeed << " MB/s\n";
+}
\ No newline at end of file
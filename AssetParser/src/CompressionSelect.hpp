@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Options.hpp"
+
+#include <ostream>
+#include <vector>
+
+// Picks the compression mode and level for a payload made of one or more consecutive
+// parts. Unless auto compression is enabled this just returns the command line choice,
+// otherwise every candidate is packed and the smallest output whose modeled decode throughput
+// stays above options.DecodeBudget wins, reported to log. The model counts the LZ4 sequences
+// of each candidate instead of timing a decode, so the same input always picks the same level.
+void SelectCompression(const ParserOptions& options, const std::vector<Assets::ByteSpan>& payload, Assets::CompressionMode& mode, int& level, std::ostream& log);
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "DictionaryTrainer.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <queue>
+
+struct DictionarySegment
+{
+	uint32_t Sample;
+	uint32_t Offset;
+	uint32_t Size;
+	uint64_t Score;
+
+	bool operator<(const DictionarySegment& s) const { return Score < s.Score; }
+};
+
+struct DictionarySample
+{
+	std::filesystem::path Path = "";
+	Assets::Asset File = {};
+	std::vector<uint8_t> Data = {};
+	std::vector<uint8_t> Filtered = {};
+	uint32_t DictionaryId = 0;
+	bool Train = false;
+};
+
+static const uint32_t KmerSize = 8;
+static const uint32_t SegmentSize = 256;
+static const uint32_t KmerTableBits = 20;
+
+static uint32_t HashKmer(const uint8_t* data)
+{
+	uint64_t value;
+	memcpy(&value, data, sizeof(uint64_t));
+
+	return (uint32_t)((value * 0x9E3779B97F4A7C15ull) >> (64 - KmerTableBits));
+}
+
+static uint64_t ScoreSegment(const Assets::ByteSpan& sample, const DictionarySegment& segment, const std::vector<uint32_t>& frequency)
+{
+	uint64_t score = 0;
+
+	for (uint32_t i = 0; i + KmerSize <= segment.Size; i++)
+	{
+		// A substring only one sample contains cannot help any other asset
+		const uint32_t f = frequency[HashKmer(sample.Data + segment.Offset + i)];
+		if (f > 1) score += f;
+	}
+
+	return score;
+}
+
+std::vector<uint8_t> TrainDictionary(const std::vector<Assets::ByteSpan>& samples, uint32_t maxSize)
+{
+	std::vector<uint32_t> frequency(1u << KmerTableBits, 0);
+	std::vector<uint32_t> lastSample(1u << KmerTableBits, UINT32_MAX);
+
+	for (uint32_t s = 0; s < samples.size(); s++)
+	{
+		for (size_t i = 0; i + KmerSize <= samples[s].Size; i++)
+		{
+			const uint32_t h = HashKmer(samples[s].Data + i);
+
+			if (lastSample[h] == s) continue;
+
+			lastSample[h] = s;
+			frequency[h]++;
+		}
+	}
+
+	std::priority_queue<DictionarySegment> segments;
+
+	for (uint32_t s = 0; s < samples.size(); s++)
+	{
+		for (size_t offset = 0; offset + KmerSize <= samples[s].Size; offset += SegmentSize)
+		{
+			DictionarySegment segment = {};
+
+			segment.Sample = s;
+			segment.Offset = (uint32_t)offset;
+			segment.Size = (uint32_t)std::min<size_t>(SegmentSize, samples[s].Size - offset);
+			segment.Score = ScoreSegment(samples[s], segment, frequency);
+
+			if (segment.Score > 0) segments.push(segment);
+		}
+	}
+
+	std::vector<DictionarySegment> selected;
+	uint32_t size = 0;
+
+	while (!segments.empty() && size < maxSize)
+	{
+		DictionarySegment best = segments.top();
+		segments.pop();
+
+		// Scores only ever go down, so a stale score is an upper bound: re-queue the segment
+		// unless its current score still beats everything left
+		best.Score = ScoreSegment(samples[best.Sample], best, frequency);
+
+		if (best.Score == 0) continue;
+
+		if (!segments.empty() && best.Score < segments.top().Score)
+		{
+			segments.push(best);
+			continue;
+		}
+
+		best.Size = std::min(best.Size, maxSize - size);
+		size += best.Size;
+
+		for (uint32_t i = 0; i + KmerSize <= best.Size; i++)
+			frequency[HashKmer(samples[best.Sample].Data + best.Offset + i)] = 0;
+
+		selected.push_back(best);
+	}
+
+	// Most valuable segments go last, right before the data they will be matched from
+	std::vector<uint8_t> dictionary;
+	dictionary.reserve(size);
+
+	for (auto it = selected.rbegin(); it != selected.rend(); it++)
+	{
+		const uint8_t* data = samples[it->Sample].Data + it->Offset;
+		dictionary.insert(dictionary.end(), data, data + it->Size);
+	}
+
+	return dictionary;
+}
+
+static bool UnpackPayload(Assets::Asset& file, std::vector<uint8_t>& data)
+{
+	if (memcmp(file.Type, "MESH", 4) == 0)
+	{
+		auto info = Assets::ParseMeshAssetInfo(&file);
+
+		data.resize(info.VertexBufferSize + info.IndexBufferSize);
+		return Assets::UnpackMesh(&info, file.Binary.data(), file.Binary.size(), data.data());
+	}
+
+	if (memcmp(file.Type, "TEXI", 4) == 0)
+	{
+		auto info = Assets::ParseTextureAssetInfo(&file);
+
+		data.resize(info.FileSize);
+		return Assets::UnpackTexture(&info, file.Binary.data(), data.data(), file.Binary.size());
+	}
+
+	if (memcmp(file.Type, "MATX", 4) == 0)
+	{
+		// Only binary materials can move their tables into a compressed payload
+		if (file.Version < Assets::AssetVersionBinary) return false;
+
+		auto info = Assets::ParseMaterialAssetInfo(&file);
+		const std::string tables = Assets::WriteMaterialTables(&info);
+
+		data.assign(tables.begin(), tables.end());
+
+		return true;
+	}
+
+	if (memcmp(file.Type, "PRFB", 4) == 0)
+	{
+		auto info = Assets::ParsePrefabAssetInfo(&file);
+		const uint8_t* matrices = (const uint8_t*)info.Matrices.data();
+
+		data.assign(matrices, matrices + info.Matrices.size() * sizeof(info.Matrices[0]));
+
+		return true;
+	}
+
+	return false;
+}
+
+// Filtered meshes are compressed after the filter, so that is what the dictionary has to match
+static void FilterPayload(DictionarySample& sample)
+{
+	if (memcmp(sample.File.Type, "MESH", 4) != 0) return;
+
+	auto info = Assets::ParseMeshAssetInfo(&sample.File);
+
+	if (info.Filter == Assets::MeshFilter::None) return;
+
+	sample.Filtered.resize(sample.Data.size());
+	Assets::EncodeMeshFilter(&info, sample.Data.data(), sample.Data.data() + info.VertexBufferSize, sample.Filtered.data());
+}
+
+static uint32_t GetDictionaryId(Assets::Asset& file)
+{
+	if (memcmp(file.Type, "MESH", 4) == 0) return Assets::ParseMeshAssetInfo(&file).DictionaryId;
+	if (memcmp(file.Type, "TEXI", 4) == 0) return Assets::ParseTextureAssetInfo(&file).DictionaryId;
+	if (memcmp(file.Type, "MATX", 4) == 0) return Assets::ParseMaterialAssetInfo(&file).DictionaryId;
+
+	return Assets::ParsePrefabAssetInfo(&file).DictionaryId;
+}
+
+static Assets::Asset RepackPayload(Assets::Asset& file, std::vector<uint8_t>& data, uint32_t dictionaryId)
+{
+	if (memcmp(file.Type, "MESH", 4) == 0)
+	{
+		auto info = Assets::ParseMeshAssetInfo(&file);
+		info.DictionaryId = dictionaryId;
+
+		std::vector<Assets::Meshlet> meshlets(info.MeshletCount);
+		Assets::UnpackMeshlets(&info, file.Binary.data(), file.Binary.size(), meshlets.data());
+
+		std::vector<Assets::MeshLod> lods(info.LodCount);
+		Assets::UnpackMeshLods(&info, file.Binary.data(), file.Binary.size(), lods.data());
+
+		return Assets::PackMesh(&info, data.data(), data.data() + info.VertexBufferSize, file.Version, meshlets.data(), lods.data());
+	}
+
+	if (memcmp(file.Type, "TEXI", 4) == 0)
+	{
+		auto info = Assets::ParseTextureAssetInfo(&file);
+		info.DictionaryId = dictionaryId;
+
+		std::vector<Assets::TextureMip> mips(std::max(info.MipLevels, 1u));
+		Assets::UnpackTextureMips(&info, file.Binary.data(), file.Binary.size(), mips.data());
+
+		return Assets::PackTexture(&info, data.data(), file.Version, mips.data());
+	}
+
+	if (memcmp(file.Type, "MATX", 4) == 0)
+	{
+		auto info = Assets::ParseMaterialAssetInfo(&file);
+		info.DictionaryId = dictionaryId;
+
+		return Assets::PackMaterial(&info, file.Version);
+	}
+
+	auto info = Assets::ParsePrefabAssetInfo(&file);
+	info.DictionaryId = dictionaryId;
+
+	return Assets::PackPrefabAsset(&info, file.Version);
+}
+
+// Materials move their tables from the metadata into the payload, so both count
+static size_t GetAssetSize(const Assets::Asset& file)
+{
+	return file.Json.size() + file.Binary.size();
+}
+
+bool BuildDirectoryDictionary(const std::filesystem::path& dir, const std::filesystem::path& out, const ParserOptions& options)
+{
+	// Assets left over from a previous run may already reference the old dictionary
+	Assets::LoadDictionary(out.c_str());
+
+	std::vector<DictionarySample> samples;
+	uint32_t trainCount = 0;
+
+	for (auto& it : std::filesystem::directory_iterator(dir))
+	{
+		const auto ext = it.path().extension();
+
+		if (ext != ".mesh" && ext != ".texi" && ext != ".matx" && ext != ".prfb")
+			continue;
+
+		DictionarySample sample = {};
+		sample.Path = it.path();
+
+		if (!Assets::LoadBinary(sample.Path.c_str(), sample.File)) continue;
+		if (!UnpackPayload(sample.File, sample.Data)) continue;
+
+		if (sample.Data.empty()) continue;
+
+		sample.DictionaryId = GetDictionaryId(sample.File);
+		sample.Train = sample.Data.size() < options.DictionaryThreshold;
+
+		// Assets packed against the old dictionary are kept even when too large to train on,
+		// since replacing the dictionary means repacking them
+		if (!sample.Train && sample.DictionaryId == 0)
+			continue;
+
+		FilterPayload(sample);
+		trainCount += sample.Train;
+		samples.push_back(std::move(sample));
+	}
+
+	if (trainCount < 2)
+	{
+		std::cout << "-- Not enough assets below " << options.DictionaryThreshold / 1024 << " KiB to train a dictionary --\n";
+		return true;
+	}
+
+	std::vector<Assets::ByteSpan> spans;
+
+	for (const auto& s : samples)
+	{
+		if (!s.Train) continue;
+
+		const auto& data = s.Filtered.empty() ? s.Data : s.Filtered;
+		spans.push_back({ data.data(), data.size() });
+	}
+
+	Assets::DictionaryAssetInfo dictionary = {};
+	dictionary.Data = TrainDictionary(spans, Assets::MaxDictionarySize);
+	dictionary.Id = Assets::ComputeDictionaryId(dictionary.Data.data(), dictionary.Data.size());
+
+	if (!Assets::RegisterDictionary(dictionary))
+	{
+		std::cout << "-- The sampled assets share no content, skipping the dictionary --\n";
+		return true;
+	}
+
+	std::vector<Assets::Asset> files(samples.size());
+	uint32_t smaller = 0;
+
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		files[i] = RepackPayload(samples[i].File, samples[i].Data, dictionary.Id);
+
+		if (samples[i].Train && GetAssetSize(files[i]) < GetAssetSize(samples[i].File))
+			smaller++;
+	}
+
+	// Without a single asset getting smaller the old dictionary stays, along with everything packed against it
+	if (smaller == 0)
+	{
+		std::cout << "-- Dictionary " << out.c_str() << " would not make any asset smaller, keeping the previous one --\n";
+		return true;
+	}
+
+	size_t sizeBefore = 0, sizeAfter = 0;
+	uint32_t repacked = 0;
+
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		const DictionarySample& s = samples[i];
+		sizeBefore += GetAssetSize(s.File);
+
+		// The file at out is about to be replaced, so an asset still referencing another dictionary
+		// would no longer decode and moves over even if it grows
+		const bool orphaned = s.DictionaryId != 0 && s.DictionaryId != dictionary.Id;
+
+		if (!orphaned && (!s.Train || GetAssetSize(files[i]) >= GetAssetSize(s.File)))
+		{
+			sizeAfter += GetAssetSize(s.File);
+			continue;
+		}
+
+		if (!Assets::SaveBinary(s.Path.c_str(), files[i])) return false;
+
+		sizeAfter += GetAssetSize(files[i]);
+		repacked++;
+	}
+
+	std::cout << "-- Dictionary " << out.c_str() << " (" << dictionary.Data.size() << " B): repacked " << repacked << '/' << samples.size()
+		<< " assets, " << sizeBefore << " >> " << sizeAfter << " B\n";
+
+	return Assets::SaveBinary(out.c_str(), Assets::PackDictionary(&dictionary, options.AssetVersion));
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Options.hpp"
+
+#include <filesystem>
+#include <vector>
+
+// Greedy segment selection: every sample is cut into fixed-size segments, each scored by
+// how many other samples share its 8-byte substrings. The best segments are copied in
+// until maxSize is reached, and substrings already covered stop counting towards others.
+std::vector<uint8_t> TrainDictionary(const std::vector<Assets::ByteSpan>& samples, uint32_t maxSize);
+
+// Trains a dictionary on the mesh, texture, material and prefab payloads in dir that are smaller than
+// options.DictionaryThreshold, writes it to out and repacks every asset it makes smaller, along
+// with every asset still packed against the dictionary it replaces
+bool BuildDirectoryDictionary(const std::filesystem::path& dir, const std::filesystem::path& out, const ParserOptions& options);
\ No newline at end of file
@@ -1,6 +1,14 @@
-#include <AssetLibrary.hpp>
+#include "Options.hpp"
+#include "Benchmark.hpp"
+#include "CompressionSelect.hpp"
+#include "DictionaryTrainer.hpp"
+#include "Manifest.hpp"
+#include "MeshProcessing.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureImport.hpp"
+#include "TextureProcessing.hpp"
 
-#include <stb_image.h>
+#include <AssetLibrary.hpp>
 
 #include <tiny_obj_loader.h>
 
@@ -14,35 +22,172 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <sstream>
 #include <unordered_map>
+#include <unordered_set>
+
+// Content hash -> first asset written with it during this run, every later path with
+// the same content -> that asset, and every known output -> the source that produced it.
+// Only the main thread writes these, between the parallel stages of a build.
+static std::unordered_map<uint64_t, std::string> s_WrittenAssets = {};
+static std::unordered_map<std::string, std::string> s_AssetAliases = {};
+static std::unordered_map<std::string, std::string> s_AssetSources = {};
+
+// Texture path -> the atlas page it was packed into instead of being written
+static std::unordered_map<std::string, AtlasRegion> s_AtlasRegions = {};
+
+// An asset kept in memory until every source has been parsed, so deduplication and the
+// output itself do not depend on which task finished first
+struct PendingAsset
+{
+	std::filesystem::path Path = "";
+	Assets::Asset File = {};
+	uint64_t ContentHash = 0;
+	bool Deduplicate = false;
+	bool Write = true;
+	bool Written = false;
+};
+
+// One source being rebuilt. Tasks only touch their own job, messages are buffered in Log
+// and printed in input order once the build is done.
+struct SourceJob
+{
+	std::filesystem::path Input = "";
+	ManifestEntry* Entry = nullptr;
+	std::ostringstream Log;
+	std::vector<PendingAsset> Assets = {};
+	tinygltf::Model Model = {};
+	size_t Committed = 0;
+	bool Success = false;
+};
+
+bool IsTextureSource(const std::filesystem::path& path)
+{
+	return path.extension() == ".png" || path.extension() == ".jpg" || path.extension() == ".hdr" || IsCompressedTextureSource(path);
+}
+
+// Decides whether asset is written or, when an asset with the same content hash was
+// committed before it, becomes an alias of that one; references to it should then go
+// through ResolveAssetPath. Called in input order from the main thread.
+void CommitAsset(PendingAsset& asset, SourceJob& job)
+{
+	ManifestEntry& entry = *job.Entry;
+	const std::string path = asset.Path.string();
+
+	if (asset.Deduplicate)
+	{
+		auto it = s_WrittenAssets.find(asset.ContentHash);
+
+		if (it != s_WrittenAssets.end() && it->second != path)
+		{
+			job.Log << "   -- " << asset.Path.filename().c_str() << ": same content as " << it->second << ", not written\n";
+
+			asset.Write = false;
+			s_AssetAliases[path] = it->second;
+			entry.Aliases.push_back({ path, it->second });
+
+			// The shared file changes with its own source, which this one has to follow
+			auto source = s_AssetSources.find(it->second);
+			if (source != s_AssetSources.end()) AddDependency(entry, source->second);
+
+			return;
+		}
 
-bool ParseTexture(const std::filesystem::path& in, const std::filesystem::path& out)
+		s_WrittenAssets[asset.ContentHash] = path;
+	}
+
+	entry.Outputs.push_back({ path, asset.Deduplicate ? asset.ContentHash : 0 });
+	s_AssetSources[path] = job.Input.string();
+}
+
+std::string ResolveAssetPath(const std::filesystem::path& path, ManifestEntry& entry)
+{
+	auto it = s_AssetAliases.find(path.string());
+
+	if (it == s_AssetAliases.end()) return path.string();
+
+	auto source = s_AssetSources.find(it->second);
+	if (source != s_AssetSources.end()) AddDependency(entry, source->second);
+
+	return it->second;
+}
+
+// Decodes an image with stb_image, builds its mip chain and encodes every level in the selected format
+bool DecodeTexture(const std::filesystem::path& in, const ParserOptions& options, Assets::TextureFormat& format, Assets::TextureColorSpace& colorSpace,
+	uint32_t& width, uint32_t& height, std::vector<uint8_t>& pixels, std::vector<Assets::TextureMip>& mips)
 {
-	int width, height, nrChannels;
-	void* data = stbi_load(in.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+	Assets::TextureFormat sourceFormat;
+	std::vector<uint8_t> source;
 
-	if (data == nullptr) return false;
+	if (!LoadTextureSource(in, options, sourceFormat, width, height, source)) return false;
+
+	// Only color images are block compressed, one and two channel or wide ones keep their format
+	format = sourceFormat;
+
+	if (sourceFormat == Assets::TextureFormat::RGBA8)
+		format = SelectTextureFormat(in, source.data(), (size_t)width * height, options);
+
+	// 8 bit color images are sRGB apart from normal maps going to BC5. Grayscale ones are usually
+	// data like roughness or occlusion, and R8_SRGB or R8G8_SRGB sampling is optional, so they stay
+	// linear along with R16 and RGBA16F.
+	const bool srgb = sourceFormat == Assets::TextureFormat::RGBA8 && format != Assets::TextureFormat::BC5;
+
+	colorSpace = srgb ? Assets::TextureColorSpace::Srgb : Assets::TextureColorSpace::Linear;
+
+	Assets::GenerateMipChain(sourceFormat, source.data(), width, height, pixels, mips, srgb);
+	EncodeTexture(pixels, mips, format);
+
+	return true;
+}
+
+bool ParseTexture(const std::filesystem::path& in, const std::filesystem::path& out, const ParserOptions& options, SourceJob& job)
+{
+	Assets::TextureFormat format = Assets::TextureFormat::None;
+	Assets::TextureColorSpace colorSpace = Assets::TextureColorSpace::Default;
+	bool punchThroughAlpha = false;
+	uint32_t width = 0, height = 0;
+
+	std::vector<uint8_t> pixels;
+	std::vector<Assets::TextureMip> mips;
+
+	// DDS and KTX2 files keep the format and mips they were authored with
+	if (IsCompressedTextureSource(in))
+	{
+		if (!LoadCompressedTexture(in, format, colorSpace, punchThroughAlpha, width, height, pixels, mips, job.Log)) return false;
+	}
+
+	else if (!DecodeTexture(in, options, format, colorSpace, width, height, pixels, mips))
+		return false;
+
+	job.Log << "   -- " << Assets::GetTextureFormatName(format) << ", " << mips.size() << " mip levels, " << pixels.size() << " B\n";
 
 	Assets::TextureAssetInfo info = {};
 	info.Name = in.string();
-	info.FileSize = width * height * STBI_rgb_alpha;
-	info.Format = Assets::TextureFormat::RGBA8;
-	info.Compression = Assets::CompressionMode::LZ4;
+	info.FileSize = pixels.size();
+	info.Format = format;
+	info.BlockSize = options.BlockSize;
 	info.PixelSize[0] = width;
 	info.PixelSize[1] = height;
 	info.PixelSize[2] = 1;
+	info.MipLevels = (uint32_t)mips.size();
+	info.ColorSpace = colorSpace;
+	info.PunchThroughAlpha = punchThroughAlpha;
 
-	Assets::Asset file = Assets::PackTexture(&info, data);
-	Assets::SaveBinary(out.c_str(), file);
+	SelectCompression(options, { { pixels.data(), info.FileSize } }, info.Compression, info.CompressionLevel, job.Log);
 
-	stbi_image_free(data);
+	PendingAsset& asset = job.Assets.emplace_back();
+	asset.Path = out;
+	asset.File = Assets::PackTexture(&info, pixels.data(), options.AssetVersion, mips.data());
+	asset.ContentHash = info.ContentHash;
+	asset.Deduplicate = true;
 
 	return true;
 }
 
-bool ParseObj(const std::filesystem::path& in, const std::filesystem::path& out)
+bool ParseObj(const std::filesystem::path& in, const std::filesystem::path& out, const ParserOptions& options, SourceJob& job)
 {
 	tinyobj::attrib_t attrib;
 	std::vector<tinyobj::shape_t> shapes;
@@ -54,7 +199,6 @@ bool ParseObj(const std::filesystem::path& in, const std::filesystem::path& out)
 
 	std::vector<Assets::VertexPosColNorUV> vertices;
 	std::vector<uint32_t> indices;
-	std::unordered_map<Assets::VertexPosColNorUV, uint32_t> uniqueVertices;
 
 	for (const auto& s : shapes)
 	{
@@ -75,26 +219,44 @@ bool ParseObj(const std::filesystem::path& in, const std::filesystem::path& out)
 
 			v.Color[0] = 1.0f; v.Color[1] = 1.0f; v.Color[2] = 1.0f;
 
-			if (uniqueVertices.count(v) == 0)
-			{
-				uniqueVertices[v] = static_cast<uint32_t>(vertices.size());
-				vertices.push_back(v);
-			}
-
-			indices.push_back(uniqueVertices[v]);
+			vertices.push_back(v);
 		}
 	}
 
+	WeldVertices(vertices, indices, options.WeldEpsilon);
+	OptimizeMesh(vertices, indices, options.OverdrawThreshold, job.Log);
+
+	std::vector<Assets::Meshlet> meshlets;
+	SplitMeshlets(vertices, indices, meshlets, job.Log);
+
+	std::vector<Assets::MeshLod> lods;
+	GenerateLods(vertices, indices, lods, options.LodCount, options.LodError, job.Log);
+
 	Assets::MeshAssetInfo info = {};
 
 	info.Name = in.string();
-	info.Format = Assets::VertexFormat::PosColNorUV;
-	info.Compression = Assets::CompressionMode::LZ4;
-	info.VertexBufferSize = vertices.size() * sizeof(Assets::VertexPosColNorUV);
-	info.IndexBufferSize = indices.size() * sizeof(uint32_t);
+	info.BlockSize = options.BlockSize;
+	info.MeshletCount = meshlets.size();
+	info.LodCount = lods.size();
+	info.Filter = options.FilterMeshes ? Assets::MeshFilter::DeltaShuffle : Assets::MeshFilter::None;
+
+	std::vector<uint8_t> vertexData;
+	EncodeVertices(vertices, options.PackVertices, Assets::VertexAttributeNormal | Assets::VertexAttributeUV, info, vertexData);
 
-	Assets::Asset file = Assets::PackMesh(&info, vertices.data(), indices.data());
-	Assets::SaveBinary(out.c_str(), file);
+	std::vector<uint8_t> indexData;
+	EncodeIndices(indices, vertices.size(), info, indexData);
+
+	// Auto compression has to judge the candidates on the bytes PackMesh will actually compress
+	std::vector<uint8_t> payload(info.VertexBufferSize + info.IndexBufferSize);
+	Assets::EncodeMeshFilter(&info, vertexData.data(), indexData.data(), payload.data());
+
+	SelectCompression(options, { { payload.data(), payload.size() } }, info.Compression, info.CompressionLevel, job.Log);
+
+	PendingAsset& asset = job.Assets.emplace_back();
+	asset.Path = out;
+	asset.File = Assets::PackMesh(&info, vertexData.data(), indexData.data(), options.AssetVersion, meshlets.data(), lods.data());
+	asset.ContentHash = info.ContentHash;
+	asset.Deduplicate = true;
 
 	return true;
 }
@@ -152,47 +314,19 @@ std::string ParseGltfMaterialName(const tinygltf::Model& model, int materialInde
 	return name;
 }
 
-bool ParseGltfVertices(tinygltf::Model& model, tinygltf::Primitive& primitive, std::vector<Assets::VertexPosColNorUV>& verts)
+bool ParseGltfNormals(tinygltf::Model& model, tinygltf::Primitive& primitive, std::vector<Assets::VertexPosColNorUV>& verts, std::ostream& log)
 {
-	tinygltf::Accessor& posAccess = model.accessors[primitive.attributes["POSITION"]];
-
-	if (posAccess.type != TINYGLTF_TYPE_VEC3)
-	{
-		std::cout << "GLTF Error: Unsupported vector format for Position data\n";
-		return false;
-	}
-
-	if (posAccess.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
-	{
-		std::cout << "GLTF Error: Unsupported data type for Position data\n";
-		return false;
-	}
-
-	verts.resize(posAccess.count);
-
-	std::vector<uint8_t> posData = {};
-	UnpackGltfBuffer(model, posAccess, posData);
-
-	for (size_t i = 0; i < verts.size(); i++)
-	{
-		float* floatPtr = (float*)posData.data();
-
-		verts[i].Position[0] = *(floatPtr + (i * 3) + 0);
-		verts[i].Position[1] = *(floatPtr + (i * 3) + 1);
-		verts[i].Position[2] = *(floatPtr + (i * 3) + 2);
-	}
-
 	tinygltf::Accessor& normAccess = model.accessors[primitive.attributes["NORMAL"]];
 
 	if (normAccess.type != TINYGLTF_TYPE_VEC3)
 	{
-		std::cout << "GLTF Error: Unsupported vector format for Normal data\n";
+		log << "GLTF Error: Unsupported vector format for Normal data\n";
 		return false;
 	}
 
 	if (normAccess.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
 	{
-		std::cout << "GLTF Error: Unsupported data type for Normal data\n";
+		log << "GLTF Error: Unsupported data type for Normal data\n";
 		return false;
 	}
 
@@ -206,23 +340,24 @@ bool ParseGltfVertices(tinygltf::Model& model, tinygltf::Primitive& primitive, s
 		verts[i].Normal[0] = *(floatPtr + (i * 3) + 0);
 		verts[i].Normal[1] = *(floatPtr + (i * 3) + 1);
 		verts[i].Normal[2] = *(floatPtr + (i * 3) + 2);
-
-		verts[i].Color[0] = verts[i].Normal[0];
-		verts[i].Color[1] = verts[i].Normal[1];
-		verts[i].Color[2] = verts[i].Normal[2];
 	}
 
+	return true;
+}
+
+bool ParseGltfUVs(tinygltf::Model& model, tinygltf::Primitive& primitive, std::vector<Assets::VertexPosColNorUV>& verts, std::ostream& log)
+{
 	tinygltf::Accessor& uvAccess = model.accessors[primitive.attributes["TEXCOORD_0"]];
 
 	if (uvAccess.type != TINYGLTF_TYPE_VEC2)
 	{
-		std::cout << "GLTF Error: Unsupported vector format for UV data\n";
+		log << "GLTF Error: Unsupported vector format for UV data\n";
 		return false;
 	}
 
 	if (uvAccess.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
 	{
-		std::cout << "GLTF Error: Unsupported data type for UV data\n";
+		log << "GLTF Error: Unsupported data type for UV data\n";
 		return false;
 	}
 
@@ -240,7 +375,55 @@ bool ParseGltfVertices(tinygltf::Model& model, tinygltf::Primitive& primitive, s
 	return true;
 }
 
-bool ParseGltfIndices(tinygltf::Model& model, tinygltf::Primitive& primitive, std::vector<uint32_t>& indices)
+// Normals and UVs are optional; attributes gets a flag for each one the primitive has
+bool ParseGltfVertices(tinygltf::Model& model, tinygltf::Primitive& primitive, std::vector<Assets::VertexPosColNorUV>& verts, uint32_t& attributes, std::ostream& log)
+{
+	tinygltf::Accessor& posAccess = model.accessors[primitive.attributes["POSITION"]];
+
+	if (posAccess.type != TINYGLTF_TYPE_VEC3)
+	{
+		log << "GLTF Error: Unsupported vector format for Position data\n";
+		return false;
+	}
+
+	if (posAccess.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+	{
+		log << "GLTF Error: Unsupported data type for Position data\n";
+		return false;
+	}
+
+	verts.resize(posAccess.count);
+
+	std::vector<uint8_t> posData = {};
+	UnpackGltfBuffer(model, posAccess, posData);
+
+	for (size_t i = 0; i < verts.size(); i++)
+	{
+		float* floatPtr = (float*)posData.data();
+
+		verts[i].Position[0] = *(floatPtr + (i * 3) + 0);
+		verts[i].Position[1] = *(floatPtr + (i * 3) + 1);
+		verts[i].Position[2] = *(floatPtr + (i * 3) + 2);
+	}
+
+	attributes = Assets::VertexAttributePosition;
+
+	if (primitive.attributes.count("NORMAL") != 0)
+	{
+		if (!ParseGltfNormals(model, primitive, verts, log)) return false;
+		attributes |= Assets::VertexAttributeNormal;
+	}
+
+	if (primitive.attributes.count("TEXCOORD_0") != 0)
+	{
+		if (!ParseGltfUVs(model, primitive, verts, log)) return false;
+		attributes |= Assets::VertexAttributeUV;
+	}
+
+	return true;
+}
+
+bool ParseGltfIndices(tinygltf::Model& model, tinygltf::Primitive& primitive, std::vector<uint32_t>& indices, std::ostream& log)
 {
 	tinygltf::Accessor& idxAccess = model.accessors[primitive.indices];
 
@@ -269,7 +452,7 @@ bool ParseGltfIndices(tinygltf::Model& model, tinygltf::Primitive& primitive, st
 
 			default:
 			{
-				std::cout << "GLTF Error: Unsupported data type for indices data\n";
+				log << "GLTF Error: Unsupported data type for indices data\n";
 				return false;
 			}
 		}
@@ -280,49 +463,100 @@ bool ParseGltfIndices(tinygltf::Model& model, tinygltf::Primitive& primitive, st
 	return true;
 }
 
-bool ParseGltfMeshes(tinygltf::Model& model, const std::filesystem::path& out)
+bool ParseGltfMeshes(tinygltf::Model& model, const std::filesystem::path& out, const ParserOptions& options, SourceJob& job)
 {
+	struct PrimitiveTask
+	{
+		size_t Mesh, Primitive;
+		std::ostringstream Log;
+		bool Success = false;
+	};
+
+	std::vector<PrimitiveTask> primitives;
+
 	for (size_t i = 0; i < model.meshes.size(); i++)
 	{
-		auto& m = model.meshes[i];
+		for (size_t j = 0; j < model.meshes[i].primitives.size(); j++)
+		{
+			auto& p = primitives.emplace_back();
+			p.Mesh = i;
+			p.Primitive = j;
+		}
+	}
+
+	// Every primitive packs into its own slot, so the outputs keep the model's order
+	const size_t first = job.Assets.size();
+	job.Assets.resize(first + primitives.size());
+
+	Assets::TaskPool::Get().ParallelFor((uint32_t)primitives.size(), [&](uint32_t t)
+	{
+		PrimitiveTask& p = primitives[t];
+		tinygltf::Primitive& primitive = model.meshes[p.Mesh].primitives[p.Primitive];
 
 		std::vector<Assets::VertexPosColNorUV> vertices = {};
 		std::vector<uint32_t> indices = {};
+		uint32_t attributes = 0;
+
+		bool success = ParseGltfVertices(model, primitive, vertices, attributes, p.Log);
+		if (success) success = ParseGltfIndices(model, primitive, indices, p.Log);
 
-		for (size_t j = 0; j < m.primitives.size(); j++)
+		if (!success)
 		{
-			vertices.clear();
-			indices.clear();
+			p.Log << "GLTF Error: Unable to parse mesh vertices or indices\n";
+			return;
+		}
 
-			bool success = ParseGltfVertices(model, m.primitives[j], vertices);
-			if (success) success = ParseGltfIndices(model, m.primitives[j], indices);
+		Assets::MeshAssetInfo info = {};
+		info.Name = ParseGltfMeshName(model, p.Mesh, p.Primitive);
 
-			if (!success)
-			{
-				std::cout << "GLTF Error: Unable to parse mesh vertices or indices\n";
-				return false;
-			}
+		PendingAsset& asset = job.Assets[first + t];
+		asset.Path = out / (info.Name + ".mesh");
 
-			Assets::MeshAssetInfo info = {};
-			info.Name = ParseGltfMeshName(model, i, j);
-			info.Format = Assets::VertexFormat::PosColNorUV;
-			info.Compression = Assets::CompressionMode::LZ4;
-			info.VertexBufferSize = vertices.size() * sizeof(Assets::VertexPosColNorUV);
-			info.IndexBufferSize = indices.size() * sizeof(uint32_t);
+		p.Log << "   -- Mesh: " << info.Name << " >> " << asset.Path.c_str() << '\n';
 
-			Assets::Asset file = Assets::PackMesh(&info, vertices.data(), indices.data());
-			const std::filesystem::path outPath = out / (info.Name + ".mesh");
+		WeldVertices(vertices, indices, options.WeldEpsilon);
+		OptimizeMesh(vertices, indices, options.OverdrawThreshold, p.Log);
 
-			std::cout << "   -- Mesh: " << info.Name << " >> " << outPath.c_str() << '\n';
+		std::vector<Assets::Meshlet> meshlets;
+		SplitMeshlets(vertices, indices, meshlets, p.Log);
 
-			Assets::SaveBinary(outPath.c_str(), file);
-		}
+		std::vector<Assets::MeshLod> lods;
+		GenerateLods(vertices, indices, lods, options.LodCount, options.LodError, p.Log);
+
+		info.BlockSize = options.BlockSize;
+		info.MeshletCount = meshlets.size();
+		info.LodCount = lods.size();
+		info.Filter = options.FilterMeshes ? Assets::MeshFilter::DeltaShuffle : Assets::MeshFilter::None;
+
+		std::vector<uint8_t> vertexData;
+		EncodeVertices(vertices, options.PackVertices, attributes, info, vertexData);
+
+		std::vector<uint8_t> indexData;
+		EncodeIndices(indices, vertices.size(), info, indexData);
+
+		// Auto compression has to judge the candidates on the bytes PackMesh will actually compress
+		std::vector<uint8_t> payload(info.VertexBufferSize + info.IndexBufferSize);
+		Assets::EncodeMeshFilter(&info, vertexData.data(), indexData.data(), payload.data());
+
+		SelectCompression(options, { { payload.data(), payload.size() } }, info.Compression, info.CompressionLevel, p.Log);
+
+		asset.File = Assets::PackMesh(&info, vertexData.data(), indexData.data(), options.AssetVersion, meshlets.data(), lods.data());
+		asset.ContentHash = info.ContentHash;
+		asset.Deduplicate = true;
+
+		p.Success = true;
+	});
+
+	for (const auto& p : primitives)
+	{
+		job.Log << p.Log.str();
+		if (!p.Success) return false;
 	}
 
 	return true;
 }
 
-bool ParseGltfMaterials(const tinygltf::Model& model, const std::filesystem::path& out)
+bool ParseGltfMaterials(const tinygltf::Model& model, const std::filesystem::path& out, const ParserOptions& options, SourceJob& job)
 {
 	for (size_t i = 0; i < model.materials.size(); i++)
 	{
@@ -342,22 +576,31 @@ bool ParseGltfMaterials(const tinygltf::Model& model, const std::filesystem::pat
 			std::filesystem::path texPath = out / image.uri;
 			texPath.replace_extension(".texi");
 
-			info.Textures["diffuse"] = texPath.string();
+			info.Textures["diffuse"] = ResolveAssetPath(texPath, *job.Entry);
+
+			auto region = s_AtlasRegions.find(info.Textures["diffuse"]);
+
+			if (region != s_AtlasRegions.end())
+			{
+				info.Textures["diffuse"] = region->second.Page;
+				info.Regions["diffuse"] = GetTextureRegion(region->second);
+			}
 		}
 
 		const std::string matName = ParseGltfMaterialName(model, i);
 		std::filesystem::path outPath = out / (matName + ".matx");
 
-		std::cout << "   -- Material: " << matName << " >> " << outPath.c_str() << '\n';
+		job.Log << "   -- Material: " << matName << " >> " << outPath.c_str() << '\n';
 
-		Assets::Asset file = Assets::PackMaterial(&info);
-		Assets::SaveBinary(outPath.c_str(), file);
+		PendingAsset& asset = job.Assets.emplace_back();
+		asset.Path = outPath;
+		asset.File = Assets::PackMaterial(&info, options.AssetVersion);
 	}
 
 	return true;
 }
 
-bool ParseGltfNodes(const tinygltf::Model& model, const std::filesystem::path& in, const std::filesystem::path& out)
+bool ParseGltfNodes(const tinygltf::Model& model, const std::filesystem::path& in, const std::filesystem::path& out, const ParserOptions& options, SourceJob& job)
 {
 	Assets::PrefabAssetInfo info = {};
 	std::vector<uint64_t> meshNodes;
@@ -417,7 +660,7 @@ bool ParseGltfNodes(const tinygltf::Model& model, const std::filesystem::path& i
 				std::string matName = ParseGltfMaterialName(model, primitive.material);
 				std::filesystem::path matPath = out / (matName + ".matx");
 
-				Assets::MeshNode meshNode = { matPath.string(), meshPath.string() };
+				Assets::MeshNode meshNode = { matPath.string(), ResolveAssetPath(meshPath, *job.Entry) };
 				info.NodeMeshes[i] = std::move(meshNode);
 			}
 		}
@@ -456,7 +699,7 @@ bool ParseGltfNodes(const tinygltf::Model& model, const std::filesystem::path& i
 			std::string matName = ParseGltfMaterialName(model, primitive.material);
 			std::filesystem::path matPath = out / (matName + ".matx");
 
-			Assets::MeshNode meshNode = { matPath.string(), meshPath.string() };
+			Assets::MeshNode meshNode = { matPath.string(), ResolveAssetPath(meshPath, *job.Entry) };
 			info.NodeMeshes[nextIdx] = std::move(meshNode);
 
 			auto& m = info.Matrices.emplace_back();
@@ -467,92 +710,433 @@ bool ParseGltfNodes(const tinygltf::Model& model, const std::filesystem::path& i
 		}
 	}
 
-	Assets::Asset file = Assets::PackPrefabAsset(&info);
+	info.BlockSize = options.BlockSize;
 
 	std::filesystem::path prefabPath = out / in.stem();
 	prefabPath.replace_extension(".prfb");
 
-	std::cout << "   -- Prefab: " << in.stem().c_str() << " >> " << prefabPath.c_str() << '\n';
+	job.Log << "   -- Prefab: " << in.stem().c_str() << " >> " << prefabPath.c_str() << '\n';
+
+	SelectCompression(options, { { (const uint8_t*)info.Matrices.data(), info.Matrices.size() * sizeof(info.Matrices[0]) } }, info.Compression, info.CompressionLevel, job.Log);
 
-	Assets::SaveBinary(prefabPath.c_str(), file);
+	PendingAsset& asset = job.Assets.emplace_back();
+	asset.Path = prefabPath;
+	asset.File = Assets::PackPrefabAsset(&info, options.AssetVersion);
 
 	return true;
 }
 
-bool ParseGltf(const std::filesystem::path& in)
+// Loads the model and packs its meshes. Materials and the prefab need the meshes and
+// textures of every source deduplicated first, so they are left to ParseGltfScene.
+bool ParseGltf(const std::filesystem::path& in, const ParserOptions& options, SourceJob& job)
 {
 	tinygltf::TinyGLTF loader;
-	tinygltf::Model model;
+	tinygltf::Model& model = job.Model;
 	std::string warn, err;
 
 	bool success = loader.LoadASCIIFromFile(&model, &err, &warn, in.c_str());
 
 	if (!warn.empty())
-		std::cout << "GLTF Warning: " << warn << '\n';
+		job.Log << "GLTF Warning: " << warn << '\n';
 
 	if (!err.empty())
-		std::cout << "GLTF Error: " << err << '\n';
+		job.Log << "GLTF Error: " << err << '\n';
 
 	const std::filesystem::path out = in.parent_path();
 	std::filesystem::create_directory(out);
 
-	if (success) success = ParseGltfMeshes(model, out);
-	if (success) success = ParseGltfMaterials(model, out);
-	if (success) success = ParseGltfNodes(model, in, out);
+	// External buffers and images invalidate the model just like the .gltf itself
+	for (const auto& b : model.buffers)
+	{
+		if (!b.uri.empty() && b.uri.rfind("data:", 0) != 0)
+			AddDependency(*job.Entry, out / b.uri);
+	}
+
+	for (const auto& i : model.images)
+	{
+		if (!i.uri.empty() && i.uri.rfind("data:", 0) != 0)
+			AddDependency(*job.Entry, out / i.uri);
+	}
+
+	if (success) success = ParseGltfMeshes(model, out, options, job);
 
 	return success;
 }
 
-int main(int argc, char** argv)
+bool ParseGltfScene(const ParserOptions& options, SourceJob& job)
+{
+	const std::filesystem::path out = job.Input.parent_path();
+
+	bool success = ParseGltfMaterials(job.Model, out, options, job);
+	if (success) success = ParseGltfNodes(job.Model, job.Input, out, options, job);
+
+	// The model is not needed past this point, only the packed assets are
+	job.Model = tinygltf::Model();
+
+	return success;
+}
+
+bool ParseSource(const ParserOptions& options, SourceJob& job)
+{
+	const std::filesystem::path& in = job.Input;
+
+	if (IsTextureSource(in))
+	{
+		auto out = in;
+		out.replace_extension(".texi");
+
+		job.Log << "-- Parsing texture " << in.stem().c_str() << " >> " << out.c_str() << '\n';
+
+		return ParseTexture(in, out, options, job);
+	}
+
+	if (in.extension() == ".obj")
+	{
+		auto out = in;
+		out.replace_extension(".mesh");
+
+		job.Log << "-- Parsing mesh (OBJ) " << in.stem().c_str() << " >> " << out.c_str() << '\n';
+
+		return ParseObj(in, out, options, job);
+	}
+
+	job.Log << "-- Parsing mesh (GLTF) " << in.stem().c_str() << '\n';
+
+	return ParseGltf(in, options, job);
+}
+
+void CommitJob(SourceJob& job)
 {
-	std::filesystem::path p(argv[1]);
+	for (; job.Committed < job.Assets.size(); job.Committed++)
+		CommitAsset(job.Assets[job.Committed], job);
+}
 
-	for (auto& it : std::filesystem::directory_iterator(p))
+// Prints the buffered output of every job up to the first failed one, in input order
+bool ReportJobs(std::vector<SourceJob>& jobs)
+{
+	for (auto& job : jobs)
 	{
-		if (it.path().extension() == ".png" || it.path().extension() == ".jpg")
+		std::cout << job.Log.str();
+		job.Log.str("");
+
+		if (!job.Success)
 		{
-			auto out = it.path();
-			out.replace_extension(".texi");
+			std::cout << (IsTextureSource(job.Input) ? "-- Unable to parse texture file --\n" : "-- Unable to parse mesh file --\n");
+			return false;
+		}
+	}
 
-			std::cout << "-- Parsing texture " << it.path().stem().c_str() << " >> " << out.c_str() << '\n';
+	return true;
+}
+
+std::filesystem::path GetDirectoryAssetPath(const std::filesystem::path& dir, const char* extension)
+{
+	std::filesystem::path name = std::filesystem::absolute(dir).lexically_normal();
+	if (!name.has_filename()) name = name.parent_path();
+
+	return dir / (name.filename().string() + extension);
+}
 
-			if (!ParseTexture(it.path(), out))
+// Packs the small textures written by this run into shared pages. Each page is added to the
+// job of its first texture, and every packed texture is dropped from the outputs of its own
+// job and listed as a region of the page. Called from the main thread once every texture
+// job has been committed.
+void PackTextureAtlases(const ParserOptions& options, std::vector<SourceJob>& jobs)
+{
+	// Other paths point at these through aliases, which only work for files that get written
+	std::unordered_set<std::string> aliased;
+
+	for (const auto& [path, target] : s_AssetAliases)
+		aliased.insert(target);
+
+	std::vector<AtlasTexture> textures;
+	std::vector<SourceJob*> owners;
+
+	for (auto& job : jobs)
+	{
+		if (!job.Success || !IsTextureSource(job.Input)) continue;
+
+		for (auto& asset : job.Assets)
+		{
+			if (!asset.Write || aliased.count(asset.Path.string()) != 0) continue;
+
+			Assets::TextureAssetInfo info = Assets::ParseTextureAssetInfo(&asset.File);
+
+			if (!CanAtlasTexture(info.Format, info.PixelSize[0], info.PixelSize[1])) continue;
+
+			AtlasTexture& texture = textures.emplace_back();
+			texture.Path = asset.Path.string();
+			texture.Format = info.Format;
+			texture.ColorSpace = info.ColorSpace;
+			texture.PunchThroughAlpha = info.PunchThroughAlpha;
+			texture.Pixels.resize(info.FileSize);
+			texture.Mips.resize(std::max(info.MipLevels, 1u));
+
+			// A texture that does not unpack is left to be written on its own
+			if (!Assets::UnpackTexture(&info, asset.File.Binary.data(), texture.Pixels.data(), asset.File.Binary.size()) ||
+				!Assets::UnpackTextureMips(&info, asset.File.Binary.data(), asset.File.Binary.size(), texture.Mips.data()))
 			{
-				std::cout << "-- Unable to parse texture file --\n";
-				return 1;
+				textures.pop_back();
+				continue;
 			}
 
-			continue;
+			owners.push_back(&job);
 		}
+	}
+
+	std::vector<AtlasPage> pages;
+	std::vector<AtlasRegion> regions;
+	PackAtlasPages(textures, pages, regions);
 
-		if (it.path().extension() == ".obj")
+	std::unordered_map<Assets::TextureFormat, uint32_t> pageCounts;
+
+	for (auto& page : pages)
+	{
+		const std::string suffix = std::string("_atlas_") + Assets::GetTextureFormatName(page.Format) + "_" + std::to_string(pageCounts[page.Format]++) + ".texi";
+		const std::filesystem::path path = GetDirectoryAssetPath(options.Input, suffix.c_str());
+
+		SourceJob& owner = *owners[page.Textures[0]];
+
+		owner.Log << "   -- Atlas: " << page.Textures.size() << " textures, " << page.Width << "x" << page.Height << ", " << page.Mips.size() << " mip levels >> " << path.c_str() << '\n';
+
+		for (size_t t : page.Textures)
 		{
-			auto out = it.path();
-			out.replace_extension(".mesh");
+			AtlasRegion& region = regions[t];
+			region.Page = path.string();
 
-			std::cout << "-- Parsing mesh (OBJ) " << it.path().stem().c_str() << " >> " << out.c_str() << '\n';
+			SourceJob& job = *owners[t];
+			auto& outputs = job.Entry->Outputs;
+			outputs.erase(std::remove_if(outputs.begin(), outputs.end(), [&](const auto& output) { return output.first == region.Path; }), outputs.end());
 
-			if (!ParseObj(it.path(), out))
+			if (&job != &owner)
+				outputs.push_back({ region.Page, 0 });
+
+			for (auto& asset : job.Assets)
 			{
-				std::cout << "-- Unable to parse mesh file --\n";
-				return 1;
+				if (asset.Path == region.Path) asset.Write = false;
 			}
 
-			continue;
+			job.Entry->Regions.push_back(region);
+			s_AtlasRegions[region.Path] = region;
+		}
+
+		Assets::TextureAssetInfo info = {};
+		info.Name = path.string();
+		info.FileSize = page.Pixels.size();
+		info.Format = page.Format;
+		info.BlockSize = options.BlockSize;
+		info.PixelSize[0] = page.Width;
+		info.PixelSize[1] = page.Height;
+		info.PixelSize[2] = 1;
+		info.MipLevels = (uint32_t)page.Mips.size();
+		info.ColorSpace = page.ColorSpace;
+		info.PunchThroughAlpha = page.PunchThroughAlpha;
+
+		SelectCompression(options, { { page.Pixels.data(), info.FileSize } }, info.Compression, info.CompressionLevel, owner.Log);
+
+		PendingAsset& asset = owner.Assets.emplace_back();
+		asset.Path = path;
+		asset.File = Assets::PackTexture(&info, page.Pixels.data(), options.AssetVersion, page.Mips.data());
+		asset.ContentHash = info.ContentHash;
+	}
+}
+
+bool PackDirectoryArchive(const std::filesystem::path& dir)
+{
+	std::vector<std::string> files;
+
+	for (auto& it : std::filesystem::directory_iterator(dir))
+	{
+		const auto ext = it.path().extension();
+
+		if (ext == ".texi" || ext == ".mesh" || ext == ".matx" || ext == ".prfb" || ext == ".dict")
+			files.push_back(it.path().string());
+	}
+
+	std::sort(files.begin(), files.end());
+
+	const std::filesystem::path out = GetDirectoryAssetPath(dir, ".vkpak");
+
+	std::cout << "-- Packing " << files.size() << " assets >> " << out.c_str() << '\n';
+
+	return Assets::PackArchive(out.c_str(), files);
+}
+
+int main(int argc, char** argv)
+{
+	ParserOptions options = {};
+
+	if (!ParseCommandLine(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	Assets::TaskPool& pool = *Assets::TaskPool::Create(options.Jobs);
+
+	if (!options.Benchmark.empty())
+		return RunBenchmark(options);
+
+	std::vector<std::filesystem::path> inputs;
+
+	for (auto& it : std::filesystem::directory_iterator(options.Input))
+	{
+		const auto ext = it.path().extension();
+
+		if (IsTextureSource(it.path()) || ext == ".obj" || ext == ".gltf")
+			inputs.push_back(it.path());
+	}
+
+	// Textures go first, so materials can be pointed at deduplicated copies
+	std::sort(inputs.begin(), inputs.end(), [](const std::filesystem::path& a, const std::filesystem::path& b)
+	{
+		const bool textureA = IsTextureSource(a), textureB = IsTextureSource(b);
+		return textureA != textureB ? textureA : a < b;
+	});
+
+	BuildManifest previous = {}, manifest = {};
+
+	if (!options.Force)
+		LoadManifest(options.Input, previous);
+
+	const uint64_t optionsHash = HashOptions(options);
+	uint32_t skipped = 0;
+
+	std::vector<uint64_t> sourceHashes(inputs.size(), 0);
+	std::vector<uint8_t> readable(inputs.size(), 0), upToDate(inputs.size(), 0);
+
+	pool.ParallelFor((uint32_t)inputs.size(), [&](uint32_t i)
+	{
+		readable[i] = HashFile(inputs[i], sourceHashes[i]);
+
+		auto cached = previous.Entries.find(inputs[i].string());
+		upToDate[i] = readable[i] && cached != previous.Entries.end() && IsUpToDate(cached->second, sourceHashes[i], optionsHash);
+	});
+
+	// Pages are packed from every texture of the directory at once, and materials have to follow
+	// where their textures moved, so one changed texture rebuilds everything
+	if (options.Atlas)
+	{
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			if (IsTextureSource(inputs[i]) && !upToDate[i])
+			{
+				std::fill(upToDate.begin(), upToDate.end(), 0);
+				break;
+			}
 		}
+	}
+
+	std::vector<SourceJob> jobs;
+	jobs.reserve(inputs.size());
 
-		if (it.path().extension() == ".gltf")
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		const auto& in = inputs[i];
+
+		if (!readable[i])
 		{
-			std::cout << "-- Parsing mesh (GLTF) " << it.path().stem().c_str() << '\n';
+			std::cout << "-- Unable to read " << in.c_str() << " --\n";
+			return 1;
+		}
 
-			if (!ParseGltf(it.path()))
+		if (upToDate[i])
+		{
+			auto cached = previous.Entries.find(in.string());
+
+			// Later sources may still reference outputs this one was deduplicated into
+			for (const auto& [path, target] : cached->second.Aliases)
+				s_AssetAliases[path] = target;
+
+			// Rebuilt sources with the same content alias these outputs instead of writing a copy
+			for (const auto& [path, hash] : cached->second.Outputs)
 			{
-				std::cout << "-- Unable to parse mesh file --\n";
-				return 1;
+				s_AssetSources[path] = in.string();
+
+				if (hash != 0) s_WrittenAssets.emplace(hash, path);
 			}
 
+			for (const auto& region : cached->second.Regions)
+				s_AtlasRegions[region.Path] = region;
+
+			manifest.Entries[in.string()] = std::move(cached->second);
+			skipped++;
+
 			continue;
 		}
+
+		ManifestEntry& entry = manifest.Entries[in.string()];
+		entry.SourceHash = sourceHashes[i];
+		entry.OptionsHash = optionsHash;
+
+		SourceJob& job = jobs.emplace_back();
+		job.Input = in;
+		job.Entry = &entry;
+	}
+
+	// Decode and pack every source, then deduplicate in input order on this thread
+	pool.ParallelFor((uint32_t)jobs.size(), [&](uint32_t i) { jobs[i].Success = ParseSource(options, jobs[i]); });
+
+	for (auto& job : jobs)
+	{
+		if (job.Success) CommitJob(job);
+	}
+
+	if (options.Atlas)
+		PackTextureAtlases(options, jobs);
+
+	// Materials and prefabs reference the final paths of meshes and textures
+	pool.ParallelFor((uint32_t)jobs.size(), [&](uint32_t i)
+	{
+		if (jobs[i].Success && jobs[i].Input.extension() == ".gltf")
+			jobs[i].Success = ParseGltfScene(options, jobs[i]);
+	});
+
+	if (!ReportJobs(jobs))
+		return 1;
+
+	std::vector<PendingAsset*> writes;
+
+	for (auto& job : jobs)
+	{
+		CommitJob(job);
+
+		for (auto& asset : job.Assets)
+		{
+			if (asset.Write) writes.push_back(&asset);
+		}
+	}
+
+	pool.ParallelFor((uint32_t)writes.size(), [&](uint32_t i)
+	{
+		writes[i]->Written = Assets::SaveBinary(writes[i]->Path.c_str(), writes[i]->File);
+		writes[i]->File = {};
+	});
+
+	for (const auto* asset : writes)
+	{
+		if (!asset->Written)
+		{
+			std::cout << "-- Unable to write " << asset->Path.c_str() << " --\n";
+			return 1;
+		}
+	}
+
+	std::cout << "-- " << jobs.size() << " sources rebuilt, " << skipped << " up to date, " << pool.GetWorkerCount() + 1 << " threads --\n";
+
+	if (!SaveManifest(options.Input, manifest))
+		std::cout << "-- Unable to write the build manifest --\n";
+
+	if (options.Dictionary && !BuildDirectoryDictionary(options.Input, GetDirectoryAssetPath(options.Input, ".dict"), options))
+	{
+		std::cout << "-- Unable to build compression dictionary --\n";
+		return 1;
+	}
+
+	if (options.Archive && !PackDirectoryArchive(options.Input))
+	{
+		std::cout << "-- Unable to pack asset archive --\n";
+		return 1;
 	}
 
 	return 0;
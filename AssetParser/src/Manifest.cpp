@@ -0,0 +1,200 @@
+#include "Manifest.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+static std::filesystem::path GetManifestPath(const std::filesystem::path& dir)
+{
+	return dir / ".assetmanifest";
+}
+
+static std::string ToManifestPath(const std::filesystem::path& dir, const std::string& path)
+{
+	return std::filesystem::path(path).lexically_relative(dir).generic_string();
+}
+
+static std::string FromManifestPath(const std::filesystem::path& dir, const std::string& path)
+{
+	return (dir / path).string();
+}
+
+bool LoadManifest(const std::filesystem::path& dir, BuildManifest& manifest)
+{
+	std::ifstream f(GetManifestPath(dir));
+
+	if (!f.is_open()) return false;
+
+	std::string line, tag;
+	uint32_t version = 0;
+
+	if (!std::getline(f, line)) return false;
+
+	std::istringstream header(line);
+
+	if (!(header >> tag >> version) || tag != "manifest" || version != ParserVersion)
+		return false;
+
+	ManifestEntry* entry = nullptr;
+
+	while (std::getline(f, line))
+	{
+		std::istringstream s(line);
+		std::string path;
+
+		s >> tag;
+
+		if (tag == "source")
+		{
+			uint64_t sourceHash, optionsHash;
+			s >> std::hex >> sourceHash >> optionsHash >> std::ws;
+			std::getline(s, path);
+
+			entry = &manifest.Entries[FromManifestPath(dir, path)];
+			entry->SourceHash = sourceHash;
+			entry->OptionsHash = optionsHash;
+
+			continue;
+		}
+
+		if (entry == nullptr) return false;
+
+		if (tag == "dep")
+		{
+			uint64_t hash;
+			s >> std::hex >> hash >> std::ws;
+			std::getline(s, path);
+
+			entry->Dependencies.push_back({ FromManifestPath(dir, path), hash });
+			continue;
+		}
+
+		if (tag == "out")
+		{
+			uint64_t hash;
+			s >> std::hex >> hash >> std::ws;
+			std::getline(s, path);
+
+			entry->Outputs.push_back({ FromManifestPath(dir, path), hash });
+			continue;
+		}
+
+		if (tag == "alias")
+		{
+			std::string target;
+
+			std::getline(s >> std::ws, path, '\t');
+			std::getline(s, target);
+
+			entry->Aliases.push_back({ FromManifestPath(dir, path), FromManifestPath(dir, target) });
+			continue;
+		}
+
+		if (tag == "region")
+		{
+			AtlasRegion& region = entry->Regions.emplace_back();
+			std::string page;
+
+			s >> std::hex >> region.X >> region.Y >> region.Width >> region.Height >> region.PageWidth >> region.PageHeight >> std::ws;
+			std::getline(s, path, '\t');
+			std::getline(s, page);
+
+			region.Path = FromManifestPath(dir, path);
+			region.Page = FromManifestPath(dir, page);
+		}
+	}
+
+	return true;
+}
+
+bool SaveManifest(const std::filesystem::path& dir, const BuildManifest& manifest)
+{
+	std::ofstream f(GetManifestPath(dir));
+
+	if (!f.is_open()) return false;
+
+	f << "manifest " << ParserVersion << '\n' << std::hex;
+
+	for (const auto& [source, entry] : manifest.Entries)
+	{
+		f << "source " << entry.SourceHash << ' ' << entry.OptionsHash << ' ' << ToManifestPath(dir, source) << '\n';
+
+		for (const auto& [path, hash] : entry.Dependencies)
+			f << "dep " << hash << ' ' << ToManifestPath(dir, path) << '\n';
+
+		for (const auto& [path, hash] : entry.Outputs)
+			f << "out " << hash << ' ' << ToManifestPath(dir, path) << '\n';
+
+		for (const auto& [path, target] : entry.Aliases)
+			f << "alias " << ToManifestPath(dir, path) << '\t' << ToManifestPath(dir, target) << '\n';
+
+		for (const auto& r : entry.Regions)
+		{
+			f << "region " << r.X << ' ' << r.Y << ' ' << r.Width << ' ' << r.Height << ' ' << r.PageWidth << ' ' << r.PageHeight << ' '
+				<< ToManifestPath(dir, r.Path) << '\t' << ToManifestPath(dir, r.Page) << '\n';
+		}
+	}
+
+	return f.good();
+}
+
+bool HashFile(const std::filesystem::path& path, uint64_t& hash)
+{
+	std::ifstream f(path, std::ios::in | std::ios::binary);
+
+	if (!f.is_open()) return false;
+
+	const std::vector<char> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	hash = Assets::HashContent(data.data(), data.size());
+
+	return true;
+}
+
+uint64_t HashOptions(const ParserOptions& options)
+{
+	std::ostringstream s;
+
+	s << options.AssetVersion << ' ' << (uint32_t)options.Compression << ' ' << options.CompressionLevel << ' '
+		<< options.AutoCompression << ' ' << options.DecodeBudget << ' ' << options.BlockSize << ' ' << options.WeldEpsilon << ' ' << options.OverdrawThreshold << ' ' << options.LodCount << ' ' << options.LodError << ' ' << options.PackVertices << ' ' << options.FilterMeshes << ' ' << (uint32_t)options.TextureFormat << ' ' << options.Atlas;
+
+	const std::string str = s.str();
+	return Assets::HashContent(str.data(), str.size());
+}
+
+void AddDependency(ManifestEntry& entry, const std::filesystem::path& path)
+{
+	uint64_t hash = 0;
+
+	// A missing dependency is recorded with hash 0 and keeps the source out of date
+	HashFile(path, hash);
+
+	entry.Dependencies.push_back({ path.string(), hash });
+}
+
+bool IsUpToDate(const ManifestEntry& entry, uint64_t sourceHash, uint64_t optionsHash)
+{
+	if (entry.SourceHash != sourceHash || entry.OptionsHash != optionsHash)
+		return false;
+
+	for (const auto& [path, hash] : entry.Dependencies)
+	{
+		uint64_t current = 0;
+
+		if (!HashFile(path, current) || current != hash)
+			return false;
+	}
+
+	for (const auto& [path, hash] : entry.Outputs)
+	{
+		if (!std::filesystem::exists(path))
+			return false;
+	}
+
+	for (const auto& [path, target] : entry.Aliases)
+	{
+		if (!std::filesystem::exists(target))
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Options.hpp"
+#include "TextureAtlas.hpp"
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Bump whenever a change to the parser alters its output for the same sources, so every
+// manifest written by an older build is discarded
+static const uint32_t ParserVersion = 21;
+
+// What a source produced on its last build and everything that build depended on
+struct ManifestEntry
+{
+	uint64_t SourceHash = 0;
+	uint64_t OptionsHash = 0;
+	std::vector<std::pair<std::string, uint64_t>> Dependencies = {};
+
+	// Written assets with the content hash they were deduplicated by, 0 when they never are
+	std::vector<std::pair<std::string, uint64_t>> Outputs = {};
+
+	// Outputs that were not written because an identical asset already existed
+	std::vector<std::pair<std::string, std::string>> Aliases = {};
+
+	// Outputs that went into an atlas page instead, which is listed with the outputs
+	std::vector<AtlasRegion> Regions = {};
+};
+
+// Persistent record of the last build of a directory, keyed by source path. Stored as
+// text in <directory>/.assetmanifest with every path relative to the directory.
+struct BuildManifest
+{
+	std::map<std::string, ManifestEntry> Entries = {};
+};
+
+bool LoadManifest(const std::filesystem::path& dir, BuildManifest& manifest);
+bool SaveManifest(const std::filesystem::path& dir, const BuildManifest& manifest);
+
+bool HashFile(const std::filesystem::path& path, uint64_t& hash);
+
+// Covers only the options that change what gets written for a source
+uint64_t HashOptions(const ParserOptions& options);
+
+void AddDependency(ManifestEntry& entry, const std::filesystem::path& path);
+
+// True when the source, options and every recorded dependency still hash the same and
+// all outputs are still on disk
+bool IsUpToDate(const ManifestEntry& entry, uint64_t sourceHash, uint64_t optionsHash);
\ No newline at end of file
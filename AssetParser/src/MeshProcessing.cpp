@@ -0,0 +1,187 @@
+#include "MeshProcessing.hpp"
+
+#include <cstdio>
+
+void WeldVertices(std::vector<Assets::VertexPosColNorUV>& vertices, std::vector<uint32_t>& indices, float epsilon)
+{
+	const uint32_t* source = indices.empty() ? nullptr : indices.data();
+	const size_t indexCount = indices.empty() ? vertices.size() : indices.size();
+
+	std::vector<uint32_t> remap;
+	const uint32_t vertexCount = Assets::GenerateVertexRemap(vertices.data(), vertices.size(), sizeof(Assets::VertexPosColNorUV), source, indexCount, remap, epsilon);
+
+	std::vector<Assets::VertexPosColNorUV> unique(vertexCount);
+	Assets::RemapVertexBuffer(unique.data(), vertices.data(), vertices.size(), sizeof(Assets::VertexPosColNorUV), remap);
+
+	indices.resize(indexCount);
+	Assets::RemapIndexBuffer(indices.data(), source, indexCount, remap);
+
+	vertices = std::move(unique);
+}
+
+static void ReorderVertexFetch(std::vector<Assets::VertexPosColNorUV>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap;
+	const uint32_t vertexCount = Assets::GenerateVertexFetchRemap(indices.data(), indices.size(), vertices.size(), remap);
+
+	std::vector<Assets::VertexPosColNorUV> ordered(vertexCount);
+	Assets::RemapVertexBuffer(ordered.data(), vertices.data(), vertices.size(), sizeof(Assets::VertexPosColNorUV), remap);
+	Assets::RemapIndexBuffer(indices.data(), indices.data(), indices.size(), remap);
+
+	vertices = std::move(ordered);
+}
+
+static Assets::OverdrawStats AnalyzeOverdraw(const std::vector<Assets::VertexPosColNorUV>& vertices, const std::vector<uint32_t>& indices)
+{
+	return Assets::AnalyzeOverdraw(indices.data(), indices.size(), vertices[0].Position, vertices.size(), sizeof(Assets::VertexPosColNorUV));
+}
+
+void OptimizeMesh(std::vector<Assets::VertexPosColNorUV>& vertices, std::vector<uint32_t>& indices, float overdrawThreshold, std::ostream& log)
+{
+	if (indices.size() < 3) return;
+
+	const Assets::VertexCacheStats before = Assets::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	Assets::OptimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+
+	char buf[128];
+
+	if (overdrawThreshold > 0.0f)
+	{
+		const Assets::OverdrawStats overdrawBefore = AnalyzeOverdraw(vertices, indices);
+
+		std::vector<uint32_t> sorted(indices.size());
+		Assets::OptimizeOverdraw(sorted.data(), indices.data(), indices.size(), vertices[0].Position, vertices.size(), sizeof(Assets::VertexPosColNorUV), overdrawThreshold);
+		indices = std::move(sorted);
+
+		const Assets::OverdrawStats overdrawAfter = AnalyzeOverdraw(vertices, indices);
+
+		snprintf(buf, sizeof(buf), "   -- Overdraw: %.3f >> %.3f\n", overdrawBefore.Overdraw, overdrawAfter.Overdraw);
+		log << buf;
+	}
+
+	ReorderVertexFetch(vertices, indices);
+
+	const Assets::VertexCacheStats after = Assets::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	snprintf(buf, sizeof(buf), "   -- Vertex cache: ACMR %.3f >> %.3f, ATVR %.3f >> %.3f\n", before.ACMR, after.ACMR, before.ATVR, after.ATVR);
+	log << buf;
+}
+
+void SplitMeshlets(const std::vector<Assets::VertexPosColNorUV>& vertices, const std::vector<uint32_t>& indices, std::vector<Assets::Meshlet>& meshlets, std::ostream& log)
+{
+	meshlets.clear();
+
+	if (indices.size() < 3) return;
+
+	Assets::BuildMeshlets(indices.data(), indices.size(), vertices[0].Position, vertices.size(), sizeof(Assets::VertexPosColNorUV), meshlets);
+
+	size_t vertexCount = 0, backfaceCullable = 0;
+
+	for (const auto& m : meshlets)
+	{
+		vertexCount += m.VertexCount;
+		backfaceCullable += m.ConeCutoff < 1.0f;
+	}
+
+	char buf[128];
+	snprintf(buf, sizeof(buf), "   -- Meshlets: %zu, %.1f vertices and %.1f triangles each, %zu with a normal cone\n", meshlets.size(),
+		(float)vertexCount / meshlets.size(), (float)indices.size() / 3 / meshlets.size(), backfaceCullable);
+
+	log << buf;
+}
+
+void GenerateLods(const std::vector<Assets::VertexPosColNorUV>& vertices, std::vector<uint32_t>& indices, std::vector<Assets::MeshLod>& lods, uint32_t lodCount, float lodError, std::ostream& log)
+{
+	lods.clear();
+
+	if (indices.size() < 3 || lodCount == 0) return;
+
+	const float scale = Assets::GetMeshScale(vertices[0].Position, vertices.size(), sizeof(Assets::VertexPosColNorUV));
+
+	lods.push_back({ 0, (uint32_t)indices.size(), 0.0f });
+
+	// Each level is simplified from the previous one, so their errors add up
+	std::vector<uint32_t> lod = indices;
+	float error = 0.0f, targetError = lodError;
+
+	for (uint32_t level = 1; level <= lodCount; level++, targetError *= 2.0f)
+	{
+		float levelError = 0.0f;
+		const size_t count = Assets::SimplifyMesh(lod.data(), lod.data(), lod.size(), vertices[0].Position, vertices.size(), sizeof(Assets::VertexPosColNorUV),
+			lod.size() / 2, targetError - error, &levelError);
+
+		// A level that barely drops any triangles only costs memory
+		if (count == 0 || count > lod.size() * 9 / 10) break;
+
+		lod.resize(count);
+		Assets::OptimizeVertexCache(lod.data(), lod.data(), lod.size(), vertices.size());
+
+		error += levelError;
+
+		lods.push_back({ (uint32_t)indices.size(), (uint32_t)lod.size(), error * scale });
+		indices.insert(indices.end(), lod.begin(), lod.end());
+	}
+
+	if (lods.size() == 1)
+	{
+		lods.clear();
+		return;
+	}
+
+	log << "   -- LODs:";
+
+	char buf[64];
+
+	for (const auto& l : lods)
+	{
+		snprintf(buf, sizeof(buf), " %u (%.4f)", l.IndexCount / 3, l.Error);
+		log << buf;
+	}
+
+	log << " triangles\n";
+}
+
+void EncodeVertices(const std::vector<Assets::VertexPosColNorUV>& vertices, bool pack, uint32_t attributes, Assets::MeshAssetInfo& info, std::vector<uint8_t>& data)
+{
+	std::vector<uint8_t> interleaved;
+
+	if (pack)
+	{
+		interleaved.resize(vertices.size() * sizeof(Assets::VertexPackedPosColNorUV));
+		Assets::PackVertices((Assets::VertexPackedPosColNorUV*)interleaved.data(), vertices.data(), vertices.size(), &info);
+	}
+
+	else
+	{
+		info.Format = Assets::VertexFormat::PosColNorUV;
+		interleaved.assign((const uint8_t*)vertices.data(), (const uint8_t*)(vertices.data() + vertices.size()));
+	}
+
+	info.Attributes = attributes | Assets::VertexAttributePosition;
+	info.VertexBufferSize = vertices.size() * Assets::GetVertexStride(info.Format, info.Attributes);
+	data.resize(info.VertexBufferSize);
+
+	Assets::ConvertVertexStreams(info.Format, data.data(), info.Attributes, interleaved.data(), 0, vertices.size());
+}
+
+void EncodeIndices(const std::vector<uint32_t>& indices, size_t vertexCount, Assets::MeshAssetInfo& info, std::vector<uint8_t>& data)
+{
+	if (vertexCount > 65536)
+	{
+		info.IndexType = Assets::IndexFormat::UInt32;
+		info.IndexBufferSize = indices.size() * sizeof(uint32_t);
+
+		data.assign((const uint8_t*)indices.data(), (const uint8_t*)indices.data() + info.IndexBufferSize);
+		return;
+	}
+
+	info.IndexType = Assets::IndexFormat::UInt16;
+	info.IndexBufferSize = indices.size() * sizeof(uint16_t);
+	data.resize(info.IndexBufferSize);
+
+	uint16_t* narrow = (uint16_t*)data.data();
+
+	for (size_t i = 0; i < indices.size(); i++)
+		narrow[i] = (uint16_t)indices[i];
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <AssetLibrary.hpp>
+
+#include <ostream>
+#include <vector>
+
+// Merges identical vertices, or the ones within epsilon of each other when it is above
+// zero, and rewrites the indices to match. Empty indices mean an unindexed triangle list.
+void WeldVertices(std::vector<Assets::VertexPosColNorUV>& vertices, std::vector<uint32_t>& indices, float epsilon);
+
+// Reorders triangles for the post-transform vertex cache, then, unless overdrawThreshold is
+// zero, clusters them front to back, and finally reorders the vertices in the order the
+// new index buffer fetches them. ACMR, ATVR and overdraw before and after go to log.
+void OptimizeMesh(std::vector<Assets::VertexPosColNorUV>& vertices, std::vector<uint32_t>& indices, float overdrawThreshold, std::ostream& log);
+
+// Splits the final index buffer into meshlets and reports how full they are to log
+void SplitMeshlets(const std::vector<Assets::VertexPosColNorUV>& vertices, const std::vector<uint32_t>& indices, std::vector<Assets::Meshlet>& meshlets, std::ostream& log);
+
+// Converts vertices to the stored encoding, VertexPackedPosColNorUV unless pack is false, split
+// into a position stream and one stream of the other attributes set in attributes. Fills in
+// Format, Attributes, VertexBufferSize and the quantization range of info.
+void EncodeVertices(const std::vector<Assets::VertexPosColNorUV>& vertices, bool pack, uint32_t attributes, Assets::MeshAssetInfo& info, std::vector<uint8_t>& data);
+
+// Stores indices as 16 bit whenever every vertex is reachable with them, and fills in
+// IndexType and IndexBufferSize of info
+void EncodeIndices(const std::vector<uint32_t>& indices, size_t vertexCount, Assets::MeshAssetInfo& info, std::vector<uint8_t>& data);
+
+// Appends up to lodCount simplified copies of the index buffer to it, each targeting half the
+// triangles of the one before within an error of lodError times the mesh size, doubling per
+// level. lods stays empty when no level could be generated.
+void GenerateLods(const std::vector<Assets::VertexPosColNorUV>& vertices, std::vector<uint32_t>& indices, std::vector<Assets::MeshLod>& lods, uint32_t lodCount, float lodError, std::ostream& log);
\ No newline at end of file
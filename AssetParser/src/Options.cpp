@@ -0,0 +1,177 @@
+#include "Options.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+bool ParseCommandLine(int argc, char** argv, ParserOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--json-metadata") == 0)
+		{
+			options.AssetVersion = Assets::AssetVersionJson;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--force") == 0)
+		{
+			options.Force = true;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--archive") == 0)
+		{
+			options.Archive = true;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--dictionary") == 0)
+		{
+			options.Dictionary = true;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--float-vertices") == 0)
+		{
+			options.PackVertices = false;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--no-mesh-filter") == 0)
+		{
+			options.FilterMeshes = false;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--atlas") == 0)
+		{
+			options.Atlas = true;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--compression") == 0 && i + 1 < argc)
+		{
+			const char* mode = argv[++i];
+
+			options.AutoCompression = strcmp(mode, "auto") == 0;
+			options.Compression = options.AutoCompression ? Assets::CompressionMode::LZ4 : Assets::ParseCompressionMode(mode);
+
+			if (!options.AutoCompression && options.Compression == Assets::CompressionMode::None && strcmp(mode, "None") != 0)
+			{
+				std::cout << "-- Unknown compression mode " << mode << " --\n";
+				return false;
+			}
+
+			continue;
+		}
+
+		if (strcmp(argv[i], "--texture-format") == 0 && i + 1 < argc)
+		{
+			const char* format = argv[++i];
+
+			options.TextureFormat = strcmp(format, "auto") == 0 ? Assets::TextureFormat::None : Assets::ParseTextureFormat(format);
+
+			// One and two channel, 16 bit and HDR formats follow the source image and cannot be forced
+			const bool sourceOnly = options.TextureFormat == Assets::TextureFormat::R8 || options.TextureFormat == Assets::TextureFormat::RG8 ||
+				options.TextureFormat == Assets::TextureFormat::R16 || options.TextureFormat == Assets::TextureFormat::RGBA16F;
+
+			if ((options.TextureFormat == Assets::TextureFormat::None && strcmp(format, "auto") != 0) || sourceOnly)
+			{
+				std::cout << "-- Unknown texture format " << format << " --\n";
+				return false;
+			}
+
+			continue;
+		}
+
+		if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+		{
+			options.CompressionLevel = atoi(argv[++i]);
+			continue;
+		}
+
+		if (strcmp(argv[i], "--decode-budget") == 0 && i + 1 < argc)
+		{
+			options.DecodeBudget = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			continue;
+		}
+
+		if (strcmp(argv[i], "--block-size") == 0 && i + 1 < argc)
+		{
+			options.BlockSize = (uint32_t)strtoul(argv[++i], nullptr, 10) * 1024;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--weld") == 0 && i + 1 < argc)
+		{
+			options.WeldEpsilon = (float)atof(argv[++i]);
+			continue;
+		}
+
+		if (strcmp(argv[i], "--overdraw") == 0 && i + 1 < argc)
+		{
+			options.OverdrawThreshold = (float)atof(argv[++i]);
+			continue;
+		}
+
+		if (strcmp(argv[i], "--lods") == 0 && i + 1 < argc)
+		{
+			options.LodCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			continue;
+		}
+
+		if (strcmp(argv[i], "--lod-error") == 0 && i + 1 < argc)
+		{
+			options.LodError = (float)atof(argv[++i]);
+			continue;
+		}
+
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+		{
+			options.Jobs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			continue;
+		}
+
+		if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+		{
+			options.Benchmark = argv[++i];
+			continue;
+		}
+
+		if (argv[i][0] == '-')
+		{
+			std::cout << "-- Unknown option " << argv[i] << " --\n";
+			return false;
+		}
+
+		options.Input = argv[i];
+	}
+
+	return !options.Input.empty();
+}
+
+void PrintUsage(const char* program)
+{
+	std::cout << "Usage: " << program << " [options] <directory>\n"
+		<< "  --json-metadata       Write version 1 assets with JSON metadata\n"
+		<< "  --force               Rebuild every source, ignoring <directory>/.assetmanifest\n"
+		<< "  --archive             Pack the parsed assets into <directory>/<name>.vkpak\n"
+		<< "  --dictionary          Train <directory>/<name>.dict and repack assets below 64 KiB with it\n"
+		<< "  --float-vertices      Store 44 byte float vertices instead of 20 byte quantized ones\n"
+		<< "  --no-mesh-filter      Compress mesh payloads as is instead of byte-shuffled and delta-encoded\n"
+		<< "  --texture-format <f> RGBA8, BC1, BC3, BC5, BC7 or auto: BC5 for normal maps, BC7 with alpha, BC1 otherwise (default auto)\n"
+		<< "                        for 8 bit color images; gray ones stay R8/RG8, 16 bit R16/RGBA16F and HDR RGBA16F\n"
+		<< "  --atlas               Pack power of two textures up to 256 texels a side into shared atlas pages per format\n"
+		<< "                        (filtering stops half a texel inside each texture, so tiling ones show a seam)\n"
+		<< "  --compression <mode>  None, LZ4, LZ4HC or auto (default LZ4)\n"
+		<< "  --level <n>           LZ4HC level from 1 to 12 (default 9)\n"
+		<< "  --decode-budget <MB/s> Slowest modeled decode speed auto compression may pick (default 1000)\n"
+		<< "  --block-size <KiB>    Split payloads into independently compressed blocks (default 256, 0 = single block)\n"
+		<< "  --weld <epsilon>      Merge vertices whose attributes all differ by at most epsilon (default 0, exact)\n"
+		<< "  --overdraw <ratio>    Vertex cache ACMR a mesh may give up to reduce overdraw (default 1.05, 0 = off)\n"
+		<< "  --lods <n>            Simplified levels of detail generated below each mesh (default 3, 0 = off)\n"
+		<< "  --lod-error <e>       Error allowed for the first LOD relative to the mesh size, doubling per level (default 0.01)\n"
+		<< "  -j <n>                Threads used to parse sources and compress payloads (default one per core)\n"
+		<< "  --benchmark <name>    Run a benchmark on the assets in <directory> (metadata, upload, decompress, weld, overdraw, meshfilter, blocks, dictionary)\n";
+}
\ No newline at end of file
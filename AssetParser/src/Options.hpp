@@ -0,0 +1,34 @@
+#pragma once
+
+#include <AssetLibrary.hpp>
+
+#include <filesystem>
+#include <string>
+
+struct ParserOptions
+{
+	std::filesystem::path Input = "";
+	uint32_t AssetVersion = Assets::AssetVersionLatest;
+	Assets::CompressionMode Compression = Assets::CompressionMode::LZ4;
+	int CompressionLevel = 0;
+	bool AutoCompression = false;
+	uint32_t DecodeBudget = 1000;
+	uint32_t BlockSize = 256 * 1024;
+	bool Force = false;
+	bool Archive = false;
+	bool Dictionary = false;
+	uint32_t DictionaryThreshold = 64 * 1024;
+	uint32_t Jobs = 0;
+	float WeldEpsilon = 0.0f;
+	float OverdrawThreshold = 1.05f;
+	uint32_t LodCount = 3;
+	float LodError = 0.01f;
+	bool PackVertices = true;
+	bool FilterMeshes = true;
+	Assets::TextureFormat TextureFormat = Assets::TextureFormat::None;
+	bool Atlas = false;
+	std::string Benchmark = "";
+};
+
+bool ParseCommandLine(int argc, char** argv, ParserOptions& options);
+void PrintUsage(const char* program);
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+static bool IsPowerOfTwo(uint32_t value)
+{
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+static uint32_t Log2(uint32_t value)
+{
+	uint32_t log = 0;
+
+	while (value > 1)
+	{
+		value >>= 1;
+		log++;
+	}
+
+	return log;
+}
+
+// Free space of a page, one cell per AtlasMinTextureSize x AtlasMinTextureSize texels
+struct AtlasGrid
+{
+	static constexpr uint32_t Cells = AtlasPageSize / AtlasMinTextureSize;
+
+	std::vector<uint8_t> Used = std::vector<uint8_t>(Cells * Cells, 0);
+
+	bool IsFree(uint32_t x, uint32_t y, uint32_t w, uint32_t h) const
+	{
+		for (uint32_t j = y; j < y + h; j++)
+		{
+			for (uint32_t i = x; i < x + w; i++)
+			{
+				if (Used[j * Cells + i]) return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Fill(uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+	{
+		for (uint32_t j = y; j < y + h; j++)
+			memset(&Used[j * Cells + x], 1, w);
+	}
+
+	// Tries every position on a multiple of the texture's own size, row by row
+	bool Place(uint32_t w, uint32_t h, uint32_t& x, uint32_t& y)
+	{
+		for (y = 0; y + h <= Cells; y += h)
+		{
+			for (x = 0; x + w <= Cells; x += w)
+			{
+				if (IsFree(x, y, w, h))
+				{
+					Fill(x, y, w, h);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+};
+
+// Copies a level of a texture into the matching level of its page. Block formats are copied a row
+// of blocks at a time, which the 4 texel alignment of every region keeps whole.
+static void CopyRegion(Assets::TextureFormat format, uint8_t* dst, uint32_t dstWidth, const uint8_t* src, uint32_t width, uint32_t height, uint32_t x, uint32_t y)
+{
+	const uint32_t blockBytes = Assets::GetBlockBytes(format);
+	const uint32_t unit = blockBytes != 0 ? 4 : 1;
+	const uint32_t unitBytes = blockBytes != 0 ? blockBytes : Assets::GetTexelBytes(format);
+
+	const size_t dstPitch = (size_t)(dstWidth / unit) * unitBytes;
+	const size_t srcPitch = (size_t)(width / unit) * unitBytes;
+
+	for (uint32_t row = 0; row < height / unit; row++)
+		memcpy(dst + (y / unit + row) * dstPitch + (x / unit) * unitBytes, src + row * srcPitch, srcPitch);
+}
+
+bool CanAtlasTexture(Assets::TextureFormat format, uint32_t width, uint32_t height)
+{
+	if (format == Assets::TextureFormat::None) return false;
+	if (!IsPowerOfTwo(width) || !IsPowerOfTwo(height)) return false;
+
+	return std::min(width, height) >= AtlasMinTextureSize && std::max(width, height) <= AtlasMaxTextureSize;
+}
+
+void PackAtlasPages(const std::vector<AtlasTexture>& textures, std::vector<AtlasPage>& pages, std::vector<AtlasRegion>& regions)
+{
+	regions.assign(textures.size(), {});
+
+	std::map<std::tuple<Assets::TextureFormat, Assets::TextureColorSpace, bool, uint32_t>, std::vector<size_t>> groups;
+
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		const uint32_t side = std::min({ textures[i].Mips[0].Width, textures[i].Mips[0].Height, AtlasLevelSize });
+		groups[{ textures[i].Format, textures[i].ColorSpace, textures[i].PunchThroughAlpha, side }].push_back(i);
+	}
+
+	for (auto& [key, group] : groups)
+	{
+		const Assets::TextureFormat format = std::get<0>(key);
+
+		// Largest first, so smaller textures fill the gaps between bigger ones
+		std::stable_sort(group.begin(), group.end(), [&](size_t a, size_t b)
+		{
+			const auto& ma = textures[a].Mips[0], & mb = textures[b].Mips[0];
+			return (uint64_t)ma.Width * ma.Height != (uint64_t)mb.Width * mb.Height ? (uint64_t)ma.Width * ma.Height > (uint64_t)mb.Width * mb.Height : ma.Width > mb.Width;
+		});
+
+		std::vector<AtlasGrid> grids;
+		std::vector<AtlasPage> groupPages;
+
+		for (size_t t : group)
+		{
+			const uint32_t w = textures[t].Mips[0].Width / AtlasMinTextureSize;
+			const uint32_t h = textures[t].Mips[0].Height / AtlasMinTextureSize;
+			uint32_t x = 0, y = 0;
+			size_t page = 0;
+
+			while (page < grids.size() && !grids[page].Place(w, h, x, y))
+				page++;
+
+			if (page == grids.size())
+			{
+				grids.emplace_back().Place(w, h, x, y);
+
+				AtlasPage& added = groupPages.emplace_back();
+				added.Format = format;
+				added.ColorSpace = std::get<1>(key);
+				added.PunchThroughAlpha = std::get<2>(key);
+			}
+
+			AtlasRegion& region = regions[t];
+			region.Path = textures[t].Path;
+			region.X = x * AtlasMinTextureSize;
+			region.Y = y * AtlasMinTextureSize;
+			region.Width = w * AtlasMinTextureSize;
+			region.Height = h * AtlasMinTextureSize;
+
+			groupPages[page].Textures.push_back(t);
+			groupPages[page].Width = std::max(groupPages[page].Width, region.X + region.Width);
+			groupPages[page].Height = std::max(groupPages[page].Height, region.Y + region.Height);
+		}
+
+		for (auto& page : groupPages)
+		{
+			if (page.Textures.size() < 2)
+			{
+				regions[page.Textures[0]] = {};
+				continue;
+			}
+
+			page.Width = 1u << (Log2(page.Width - 1) + 1);
+			page.Height = 1u << (Log2(page.Height - 1) + 1);
+
+			// A level exists only while every texture still has one at least a block (or a texel) wide
+			const uint32_t smallest = Assets::GetBlockBytes(format) != 0 ? AtlasMinTextureSize : 1;
+			uint32_t levels = Assets::GetMipLevelCount(page.Width, page.Height);
+
+			for (size_t t : page.Textures)
+			{
+				const auto& base = textures[t].Mips[0];
+				levels = std::min({ levels, (uint32_t)textures[t].Mips.size(), Log2(std::min(base.Width, base.Height) / smallest) + 1 });
+			}
+
+			uint64_t offset = 0;
+			page.Mips.resize(levels);
+
+			for (uint32_t i = 0; i < levels; i++)
+			{
+				const uint32_t w = std::max(page.Width >> i, 1u);
+				const uint32_t h = std::max(page.Height >> i, 1u);
+
+				offset = (offset + 3) & ~(uint64_t)3;
+
+				page.Mips[i] = { offset, Assets::GetTextureLevelSize(format, w, h), w, h };
+				offset += page.Mips[i].Size;
+			}
+
+			// Space no texture covers stays zeroed
+			page.Pixels.assign(offset, 0);
+
+			for (size_t t : page.Textures)
+			{
+				AtlasRegion& region = regions[t];
+				region.PageWidth = page.Width;
+				region.PageHeight = page.Height;
+
+				for (uint32_t i = 0; i < levels; i++)
+				{
+					const Assets::TextureMip& mip = textures[t].Mips[i];
+					CopyRegion(format, page.Pixels.data() + page.Mips[i].Offset, page.Mips[i].Width, textures[t].Pixels.data() + mip.Offset, mip.Width, mip.Height, region.X >> i, region.Y >> i);
+				}
+			}
+
+			pages.push_back(std::move(page));
+		}
+	}
+}
+
+Assets::TextureRegion GetTextureRegion(const AtlasRegion& region)
+{
+	Assets::TextureRegion uv = {};
+	uv.Scale[0] = (float)region.Width / region.PageWidth;
+	uv.Scale[1] = (float)region.Height / region.PageHeight;
+	uv.Offset[0] = (float)region.X / region.PageWidth;
+	uv.Offset[1] = (float)region.Y / region.PageHeight;
+
+	return uv;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <AssetLibrary.hpp>
+
+#include <string>
+#include <vector>
+
+// Textures are only packed when both sides are powers of two between these sizes, so each can sit
+// on a multiple of its own size and keeps its place in every level of the page
+static const uint32_t AtlasMinTextureSize = 4;
+static const uint32_t AtlasMaxTextureSize = 256;
+static const uint32_t AtlasPageSize = 1024;
+
+// A page keeps only the levels its narrowest texture has. Textures whose shorter side reaches this
+// size share pages and give up at most the levels below it, narrower ones are only packed with
+// textures of the same shorter side.
+static const uint32_t AtlasLevelSize = 64;
+
+// Where a texture ended up: a Width x Height rectangle at X, Y in the first level of Page
+struct AtlasRegion
+{
+	std::string Path = "";
+	std::string Page = "";
+	uint32_t X = 0, Y = 0;
+	uint32_t Width = 0, Height = 0;
+	uint32_t PageWidth = 0, PageHeight = 0;
+};
+
+// A texture to pack, with every level it was built with
+struct AtlasTexture
+{
+	std::string Path = "";
+	Assets::TextureFormat Format = Assets::TextureFormat::None;
+	Assets::TextureColorSpace ColorSpace = Assets::TextureColorSpace::Default;
+	bool PunchThroughAlpha = false;
+	std::vector<uint8_t> Pixels = {};
+	std::vector<Assets::TextureMip> Mips = {};
+};
+
+struct AtlasPage
+{
+	Assets::TextureFormat Format = Assets::TextureFormat::None;
+	Assets::TextureColorSpace ColorSpace = Assets::TextureColorSpace::Default;
+	bool PunchThroughAlpha = false;
+	uint32_t Width = 0, Height = 0;
+	std::vector<uint8_t> Pixels = {};
+	std::vector<Assets::TextureMip> Mips = {};
+
+	// Indices into the textures the page was packed from
+	std::vector<size_t> Textures = {};
+};
+
+bool CanAtlasTexture(Assets::TextureFormat format, uint32_t width, uint32_t height);
+
+// Packs textures that decode the same way (format, color space and BC1 mode) and share a shorter
+// side below AtlasLevelSize into pages of at most AtlasPageSize texels a side, largest first, and
+// gives every texture its region (without Page, which the caller names). Every page is shrunk
+// to the power of two around what it holds and keeps as many levels as its smallest texture
+// allows, down to 4x4 for block formats whose blocks would otherwise mix neighbours. Pages holding
+// a single texture are dropped and its region keeps a zero size. Regions have no gutters, base.frag
+// keeps filtering half a texel inside them instead.
+void PackAtlasPages(const std::vector<AtlasTexture>& textures, std::vector<AtlasPage>& pages, std::vector<AtlasRegion>& regions);
+
+// The UV scale and offset that map a whole texture onto its region
+Assets::TextureRegion GetTextureRegion(const AtlasRegion& region);
\ No newline at end of file
@@ -0,0 +1,428 @@
+#include "TextureImport.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// File layouts as documented for DDS (DDS_HEADER and DDS_HEADER_DXT10) and KTX 2.0
+struct DdsPixelFormat
+{
+	uint32_t Size;
+	uint32_t Flags;
+	uint32_t FourCC;
+	uint32_t RGBBitCount;
+	uint32_t RBitMask;
+	uint32_t GBitMask;
+	uint32_t BBitMask;
+	uint32_t ABitMask;
+};
+
+struct DdsHeader
+{
+	uint32_t Size;
+	uint32_t Flags;
+	uint32_t Height;
+	uint32_t Width;
+	uint32_t PitchOrLinearSize;
+	uint32_t Depth;
+	uint32_t MipMapCount;
+	uint32_t Reserved1[11];
+	DdsPixelFormat PixelFormat;
+	uint32_t Caps;
+	uint32_t Caps2;
+	uint32_t Caps3;
+	uint32_t Caps4;
+	uint32_t Reserved2;
+};
+
+struct DdsHeaderDxt10
+{
+	uint32_t DxgiFormat;
+	uint32_t ResourceDimension;
+	uint32_t MiscFlag;
+	uint32_t ArraySize;
+	uint32_t MiscFlags2;
+};
+
+struct Ktx2Header
+{
+	uint8_t Identifier[12];
+	uint32_t VkFormat;
+	uint32_t TypeSize;
+	uint32_t PixelWidth;
+	uint32_t PixelHeight;
+	uint32_t PixelDepth;
+	uint32_t LayerCount;
+	uint32_t FaceCount;
+	uint32_t LevelCount;
+	uint32_t SupercompressionScheme;
+	uint32_t DfdByteOffset;
+	uint32_t DfdByteLength;
+	uint32_t KvdByteOffset;
+	uint32_t KvdByteLength;
+	uint64_t SgdByteOffset;
+	uint64_t SgdByteLength;
+};
+
+struct Ktx2Level
+{
+	uint64_t ByteOffset;
+	uint64_t ByteLength;
+	uint64_t UncompressedByteLength;
+};
+
+static_assert(sizeof(DdsHeader) == 124 && sizeof(Ktx2Header) == 80, "Texture container headers must match the file layout");
+
+static constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+{
+	return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+}
+
+static const uint32_t DdsFlagMipMapCount = 0x20000;
+static const uint32_t DdsPixelFourCC = 0x4;
+static const uint32_t DdsPixelRGB = 0x40;
+static const uint32_t DdsCaps2Cubemap = 0x200;
+static const uint32_t DdsCaps2Volume = 0x200000;
+static const uint32_t DdsDimensionTexture2D = 3;
+static const uint32_t DdsMiscTextureCube = 0x4;
+
+static const uint8_t Ktx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// Formats without an _SRGB variant hold linear data
+static Assets::TextureFormat GetDxgiFormat(uint32_t format, Assets::TextureColorSpace& colorSpace)
+{
+	colorSpace = Assets::TextureColorSpace::Linear;
+
+	switch (format)
+	{
+		case 10: // DXGI_FORMAT_R16G16B16A16_FLOAT
+			return Assets::TextureFormat::RGBA16F;
+
+		case 29: // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::RGBA8;
+
+		case 28: // DXGI_FORMAT_R8G8B8A8_UNORM
+			return Assets::TextureFormat::RGBA8;
+
+		case 49: // DXGI_FORMAT_R8G8_UNORM
+			return Assets::TextureFormat::RG8;
+
+		case 56: // DXGI_FORMAT_R16_UNORM
+			return Assets::TextureFormat::R16;
+
+		case 61: // DXGI_FORMAT_R8_UNORM
+			return Assets::TextureFormat::R8;
+
+		case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::BC1;
+
+		case 71: // DXGI_FORMAT_BC1_UNORM
+			return Assets::TextureFormat::BC1;
+
+		case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::BC3;
+
+		case 77: // DXGI_FORMAT_BC3_UNORM
+			return Assets::TextureFormat::BC3;
+
+		case 83: // DXGI_FORMAT_BC5_UNORM
+			return Assets::TextureFormat::BC5;
+
+		case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::BC7;
+
+		case 98: // DXGI_FORMAT_BC7_UNORM
+			return Assets::TextureFormat::BC7;
+
+		default:
+			return Assets::TextureFormat::None;
+	}
+}
+
+static Assets::TextureFormat GetKtx2Format(uint32_t format, Assets::TextureColorSpace& colorSpace, bool& punchThroughAlpha)
+{
+	colorSpace = Assets::TextureColorSpace::Linear;
+	punchThroughAlpha = false;
+
+	switch (format)
+	{
+		case 9: // VK_FORMAT_R8_UNORM
+			return Assets::TextureFormat::R8;
+
+		case 16: // VK_FORMAT_R8G8_UNORM
+			return Assets::TextureFormat::RG8;
+
+		case 43: // VK_FORMAT_R8G8B8A8_SRGB
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::RGBA8;
+
+		case 37: // VK_FORMAT_R8G8B8A8_UNORM
+			return Assets::TextureFormat::RGBA8;
+
+		case 70: // VK_FORMAT_R16_UNORM
+			return Assets::TextureFormat::R16;
+
+		case 97: // VK_FORMAT_R16G16B16A16_SFLOAT
+			return Assets::TextureFormat::RGBA16F;
+
+		case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::BC1;
+
+		case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+			return Assets::TextureFormat::BC1;
+
+		case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			punchThroughAlpha = true;
+			return Assets::TextureFormat::BC1;
+
+		case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+			punchThroughAlpha = true;
+			return Assets::TextureFormat::BC1;
+
+		case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::BC3;
+
+		case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+			return Assets::TextureFormat::BC3;
+
+		case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+			return Assets::TextureFormat::BC5;
+
+		case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+			colorSpace = Assets::TextureColorSpace::Srgb;
+			return Assets::TextureFormat::BC7;
+
+		case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+			return Assets::TextureFormat::BC7;
+
+		default:
+			return Assets::TextureFormat::None;
+	}
+}
+
+// Legacy headers do not say how color is encoded, so the format's default applies
+static Assets::TextureFormat GetDdsFormat(const DdsPixelFormat& pixelFormat)
+{
+	if ((pixelFormat.Flags & DdsPixelFourCC) != 0)
+	{
+		if (pixelFormat.FourCC == MakeFourCC('D', 'X', 'T', '1'))
+			return Assets::TextureFormat::BC1;
+
+		if (pixelFormat.FourCC == MakeFourCC('D', 'X', 'T', '5'))
+			return Assets::TextureFormat::BC3;
+
+		if (pixelFormat.FourCC == MakeFourCC('A', 'T', 'I', '2') || pixelFormat.FourCC == MakeFourCC('B', 'C', '5', 'U'))
+			return Assets::TextureFormat::BC5;
+
+		return Assets::TextureFormat::None;
+	}
+
+	if ((pixelFormat.Flags & DdsPixelRGB) != 0 && pixelFormat.RGBBitCount == 32 && pixelFormat.RBitMask == 0xFF && pixelFormat.GBitMask == 0xFF00 && pixelFormat.BBitMask == 0xFF0000 && pixelFormat.ABitMask == 0xFF000000)
+		return Assets::TextureFormat::RGBA8;
+
+	return Assets::TextureFormat::None;
+}
+
+// Fills in the extent and size of every level; offsets are left to the container
+static void DescribeLevels(Assets::TextureFormat format, uint32_t width, uint32_t height, uint32_t levelCount, std::vector<Assets::TextureMip>& mips)
+{
+	mips.resize(levelCount);
+
+	for (uint32_t i = 0; i < levelCount; i++)
+	{
+		mips[i].Width = std::max(width >> i, 1u);
+		mips[i].Height = std::max(height >> i, 1u);
+		mips[i].Size = Assets::GetTextureLevelSize(format, mips[i].Width, mips[i].Height);
+	}
+}
+
+static bool ReadDds(const uint8_t* data, size_t size, Assets::TextureFormat& format, Assets::TextureColorSpace& colorSpace, bool& punchThroughAlpha, uint32_t& width, uint32_t& height, std::vector<Assets::TextureMip>& mips, std::ostream& log)
+{
+	DdsHeader header;
+	size_t offset = 4 + sizeof(DdsHeader);
+
+	if (size < offset || memcmp(data, "DDS ", 4) != 0) return false;
+
+	memcpy(&header, data + 4, sizeof(DdsHeader));
+
+	if ((header.Caps2 & (DdsCaps2Cubemap | DdsCaps2Volume)) != 0)
+	{
+		log << "   -- Cube map and volume textures are not supported\n";
+		return false;
+	}
+
+	format = GetDdsFormat(header.PixelFormat);
+	colorSpace = Assets::TextureColorSpace::Default;
+
+	if ((header.PixelFormat.Flags & DdsPixelFourCC) != 0 && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0'))
+	{
+		DdsHeaderDxt10 extension;
+
+		if (size < offset + sizeof(DdsHeaderDxt10)) return false;
+
+		memcpy(&extension, data + offset, sizeof(DdsHeaderDxt10));
+		offset += sizeof(DdsHeaderDxt10);
+
+		if (extension.ResourceDimension != DdsDimensionTexture2D || extension.ArraySize > 1 || (extension.MiscFlag & DdsMiscTextureCube) != 0)
+		{
+			log << "   -- Only single 2D textures are supported\n";
+			return false;
+		}
+
+		format = GetDxgiFormat(extension.DxgiFormat, colorSpace);
+	}
+
+	// Direct3D decodes every BC1 block the same way, three color ones with transparent black
+	punchThroughAlpha = format == Assets::TextureFormat::BC1;
+
+	if (format == Assets::TextureFormat::None)
+	{
+		log << "   -- Unsupported DDS pixel format\n";
+		return false;
+	}
+
+	width = header.Width;
+	height = header.Height;
+
+	const uint32_t levelCount = (header.Flags & DdsFlagMipMapCount) != 0 ? std::max(header.MipMapCount, 1u) : 1;
+	DescribeLevels(format, width, height, levelCount, mips);
+
+	// Levels follow the header back to back, largest first
+	for (auto& mip : mips)
+	{
+		mip.Offset = offset;
+		offset += mip.Size;
+	}
+
+	return true;
+}
+
+static bool ReadKtx2(const uint8_t* data, size_t size, Assets::TextureFormat& format, Assets::TextureColorSpace& colorSpace, bool& punchThroughAlpha, uint32_t& width, uint32_t& height, std::vector<Assets::TextureMip>& mips,
+	bool& generateMips, std::ostream& log)
+{
+	Ktx2Header header;
+
+	if (size < sizeof(Ktx2Header)) return false;
+
+	memcpy(&header, data, sizeof(Ktx2Header));
+
+	if (memcmp(header.Identifier, Ktx2Identifier, sizeof(Ktx2Identifier)) != 0) return false;
+
+	if (header.SupercompressionScheme != 0)
+	{
+		log << "   -- Supercompressed KTX2 files are not supported\n";
+		return false;
+	}
+
+	if (header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount > 1)
+	{
+		log << "   -- Only single 2D textures are supported\n";
+		return false;
+	}
+
+	format = GetKtx2Format(header.VkFormat, colorSpace, punchThroughAlpha);
+
+	if (format == Assets::TextureFormat::None)
+	{
+		log << "   -- Unsupported KTX2 format " << header.VkFormat << '\n';
+		return false;
+	}
+
+	width = header.PixelWidth;
+	height = header.PixelHeight;
+
+	// A level count of zero stores only the base level and asks the loader to generate the rest
+	const uint32_t levelCount = std::max(header.LevelCount, 1u);
+	generateMips = header.LevelCount == 0;
+
+	if (size < sizeof(Ktx2Header) + (size_t)levelCount * sizeof(Ktx2Level)) return false;
+
+	DescribeLevels(format, width, height, levelCount, mips);
+
+	for (uint32_t i = 0; i < levelCount; i++)
+	{
+		Ktx2Level level;
+		memcpy(&level, data + sizeof(Ktx2Header) + i * sizeof(Ktx2Level), sizeof(Ktx2Level));
+
+		if (level.ByteLength != mips[i].Size) return false;
+
+		mips[i].Offset = level.ByteOffset;
+	}
+
+	return true;
+}
+
+bool IsCompressedTextureSource(const std::filesystem::path& path)
+{
+	return path.extension() == ".dds" || path.extension() == ".ktx2";
+}
+
+bool LoadCompressedTexture(const std::filesystem::path& path, Assets::TextureFormat& format, Assets::TextureColorSpace& colorSpace, bool& punchThroughAlpha, uint32_t& width, uint32_t& height,
+	std::vector<uint8_t>& pixels, std::vector<Assets::TextureMip>& mips, std::ostream& log)
+{
+	Assets::MappedFile file = {};
+
+	if (!Assets::MapFile(path.string().c_str(), file)) return false;
+
+	const uint8_t* data = (const uint8_t*)file.Data;
+	bool success = false, generateMips = false;
+
+	if (path.extension() == ".dds")
+		success = ReadDds(data, file.Size, format, colorSpace, punchThroughAlpha, width, height, mips, log);
+
+	else
+		success = ReadKtx2(data, file.Size, format, colorSpace, punchThroughAlpha, width, height, mips, generateMips, log);
+
+	size_t size = 0;
+
+	for (const auto& mip : mips)
+	{
+		if (mip.Offset > file.Size || mip.Size > file.Size - mip.Offset)
+			success = false;
+
+		size = ((size + 3) & ~(size_t)3) + mip.Size;
+	}
+
+	// The levels are copied as they are, only moved next to each other on the four byte
+	// boundaries buffer to image copies need
+	if (success)
+	{
+		pixels.assign(size, 0);
+
+		uint64_t offset = 0;
+
+		for (auto& mip : mips)
+		{
+			offset = (offset + 3) & ~(uint64_t)3;
+			memcpy(pixels.data() + offset, data + mip.Offset, mip.Size);
+
+			mip.Offset = offset;
+			offset += mip.Size;
+		}
+	}
+
+	Assets::UnmapFile(file);
+
+	if (!success || !generateMips || Assets::GetMipLevelCount(width, height) == 1)
+		return success;
+
+	// Block formats would have to be decoded and encoded again, so they keep their single level
+	if (Assets::GetBlockBytes(format) != 0)
+	{
+		log << "   -- KTX2 file asks for generated mips, block compressed " << Assets::GetTextureFormatName(format) << " keeps its single level\n";
+		return true;
+	}
+
+	std::vector<uint8_t> base = std::move(pixels);
+	Assets::GenerateMipChain(format, base.data(), width, height, pixels, mips, colorSpace == Assets::TextureColorSpace::Srgb);
+
+	log << "   -- KTX2 file asks for generated mips, built " << mips.size() << " levels\n";
+
+	return true;
+}
\ No newline at end of file
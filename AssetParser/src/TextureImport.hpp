@@ -0,0 +1,17 @@
+#pragma once
+
+#include <AssetLibrary.hpp>
+
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+bool IsCompressedTextureSource(const std::filesystem::path& path);
+
+// Reads the mip chain of a DDS or KTX2 file as stored, largest level first, without decoding it.
+// Only 2D textures in a format the asset can hold (RGBA8, BC1, BC3, BC5 or BC7, either UNORM or
+// sRGB, and R8, RG8, R16 or RGBA16F) are accepted; cube maps, arrays, volumes and supercompressed
+// KTX2 files are not. colorSpace and punchThroughAlpha report how the format decodes. KTX2 files
+// asking for generated mips get a full chain when uncompressed and keep one level otherwise.
+bool LoadCompressedTexture(const std::filesystem::path& path, Assets::TextureFormat& format, Assets::TextureColorSpace& colorSpace, bool& punchThroughAlpha, uint32_t& width, uint32_t& height,
+	std::vector<uint8_t>& pixels, std::vector<Assets::TextureMip>& mips, std::ostream& log);
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "TextureProcessing.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+// Largest finite half float, HDR values beyond it would turn into infinities every lower level inherits
+static const float MaxHalf = 65504.0f;
+
+bool IsNormalMap(const std::filesystem::path& path)
+{
+	std::string name = path.stem().string();
+	std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+	const auto endsWith = [&name](const std::string& suffix)
+	{
+		return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+	};
+
+	return name.find("normal") != std::string::npos || endsWith("_n") || endsWith("_nrm");
+}
+
+bool LoadTextureSource(const std::filesystem::path& path, const ParserOptions& options, Assets::TextureFormat& format, uint32_t& width, uint32_t& height,
+	std::vector<uint8_t>& pixels)
+{
+	int w, h, channels;
+
+	if (!stbi_info(path.c_str(), &w, &h, &channels))
+		return false;
+
+	const bool hdr = stbi_is_hdr(path.c_str()) != 0;
+	const bool wide = stbi_is_16_bit(path.c_str()) != 0;
+
+	if (hdr || (wide && channels > 1))
+		format = Assets::TextureFormat::RGBA16F;
+
+	else if (wide)
+		format = Assets::TextureFormat::R16;
+
+	else if (options.TextureFormat == Assets::TextureFormat::None && channels == 1)
+		format = Assets::TextureFormat::R8;
+
+	else if (options.TextureFormat == Assets::TextureFormat::None && channels == 2)
+		format = Assets::TextureFormat::RG8;
+
+	else
+		format = Assets::TextureFormat::RGBA8;
+
+	const size_t texelCount = (size_t)w * h;
+	void* data = nullptr;
+
+	switch (format)
+	{
+		// stb_image cuts 16 bit images down to 8 bits when loading them as floats
+		case Assets::TextureFormat::RGBA16F:
+			if (hdr) data = stbi_loadf(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+			else data = stbi_load_16(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+
+			break;
+
+		case Assets::TextureFormat::R16:
+			data = stbi_load_16(path.c_str(), &w, &h, &channels, STBI_grey);
+			break;
+
+		default:
+			data = stbi_load(path.c_str(), &w, &h, &channels, (int)Assets::GetTexelBytes(format));
+			break;
+	}
+
+	if (data == nullptr) return false;
+
+	width = w;
+	height = h;
+	pixels.resize(texelCount * Assets::GetTexelBytes(format));
+
+	if (format == Assets::TextureFormat::RGBA16F && hdr)
+	{
+		const float* values = (const float*)data;
+
+		for (size_t i = 0; i < texelCount * 4; i++)
+		{
+			const uint16_t half = Assets::EncodeHalf(std::clamp(values[i], -MaxHalf, MaxHalf));
+			memcpy(pixels.data() + i * 2, &half, sizeof(half));
+		}
+	}
+
+	// 16 bit color is sRGB encoded like 8 bit color, alpha and normal maps are stored as they are
+	else if (format == Assets::TextureFormat::RGBA16F)
+	{
+		const uint16_t* values = (const uint16_t*)data;
+		const bool srgb = !IsNormalMap(path);
+
+		for (size_t i = 0; i < texelCount * 4; i++)
+		{
+			float value = values[i] / 65535.0f;
+
+			if (srgb && i % 4 != 3)
+				value = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+
+			const uint16_t half = Assets::EncodeHalf(value);
+			memcpy(pixels.data() + i * 2, &half, sizeof(half));
+		}
+	}
+
+	else
+		memcpy(pixels.data(), data, pixels.size());
+
+	stbi_image_free(data);
+
+	return true;
+}
+
+Assets::TextureFormat SelectTextureFormat(const std::filesystem::path& path, const uint8_t* pixels, size_t texelCount, const ParserOptions& options)
+{
+	if (options.TextureFormat != Assets::TextureFormat::None)
+		return options.TextureFormat;
+
+	if (IsNormalMap(path))
+		return Assets::TextureFormat::BC5;
+
+	for (size_t i = 0; i < texelCount; i++)
+	{
+		if (pixels[i * 4 + 3] != 255)
+			return Assets::TextureFormat::BC7;
+	}
+
+	return Assets::TextureFormat::BC1;
+}
+
+void EncodeTexture(std::vector<uint8_t>& pixels, std::vector<Assets::TextureMip>& mips, Assets::TextureFormat format)
+{
+	if (Assets::GetBlockBytes(format) == 0)
+		return;
+
+	size_t size = 0;
+
+	for (const auto& mip : mips)
+		size += Assets::GetTextureLevelSize(format, mip.Width, mip.Height);
+
+	std::vector<uint8_t> blocks(size);
+	uint64_t offset = 0;
+
+	for (auto& mip : mips)
+	{
+		Assets::CompressBlocks(format, blocks.data() + offset, pixels.data() + mip.Offset, mip.Width, mip.Height);
+
+		mip.Offset = offset;
+		mip.Size = Assets::GetTextureLevelSize(format, mip.Width, mip.Height);
+		offset += mip.Size;
+	}
+
+	pixels = std::move(blocks);
+}
\ No newline at end of file
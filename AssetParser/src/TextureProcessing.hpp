@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Options.hpp"
+
+#include <AssetLibrary.hpp>
+
+#include <filesystem>
+#include <vector>
+
+// Loads an image with stb_image in the uncompressed format closest to its source: one and two
+// channel 8 bit images as R8 and RG8, one channel 16 bit images as R16, HDR and other 16 bit
+// images as RGBA16F and everything else as RGBA8. RGBA16F holds linear light: HDR values are
+// clamped to the half float range and 16 bit color is decoded from sRGB, except in normal maps.
+// With a format given by --texture-format every 8 bit image loads as RGBA8.
+bool LoadTextureSource(const std::filesystem::path& path, const ParserOptions& options, Assets::TextureFormat& format, uint32_t& width, uint32_t& height,
+	std::vector<uint8_t>& pixels);
+
+// Normal maps are recognized by a file name containing "normal" or ending in "_n" or "_nrm"
+bool IsNormalMap(const std::filesystem::path& path);
+
+// Picks the stored format of an RGBA8 texture: BC5 for normal maps, BC7 when any texel is not
+// fully opaque and BC1 otherwise. A format given with --texture-format applies to every texture
+// instead.
+Assets::TextureFormat SelectTextureFormat(const std::filesystem::path& path, const uint8_t* pixels, size_t texelCount, const ParserOptions& options);
+
+// Compresses every level of an RGBA8 mip chain into format, rewriting the offsets and sizes in
+// mips to match. RGBA8 leaves the chain as it is.
+void EncodeTexture(std::vector<uint8_t>& pixels, std::vector<Assets::TextureMip>& mips, Assets::TextureFormat format);
\ No newline at end of file
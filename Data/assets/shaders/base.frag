@@ -5,6 +5,8 @@ in vs_out
 {
 	vec2 TexCoord;
 	vec3 Color;
+	vec3 Normal;
+	flat vec4 UVTransform;
 } In;
 
 layout (set = 2, binding = 0) uniform sampler2D diffuse;
@@ -13,7 +15,23 @@ layout (location = 0) out vec4 Color;
 
 void main()
 {
-	vec4 color = texture(diffuse, In.TexCoord).rgba;
+	// Atlased textures cover part of the image, so UVs wrap before moving into that part. The
+	// gradients come from the unwrapped UVs, so the wrap does not drop to the smallest mip.
+	vec2 uv = fract(In.TexCoord) * In.UVTransform.xy + In.UVTransform.zw;
+	vec2 dx = dFdx(In.TexCoord) * In.UVTransform.xy;
+	vec2 dy = dFdy(In.TexCoord) * In.UVTransform.xy;
+
+	// Regions sit next to each other without gutters, so filter taps are kept half a texel inside
+	// the region on the coarser of the two levels sampled. Axes a region spans fully wrap as usual.
+	vec2 size = vec2(textureSize(diffuse, 0));
+	float lod = clamp(log2(max(length(dx * size), length(dy * size))), 0.0, float(textureQueryLevels(diffuse) - 1));
+	vec2 halfTexel = 0.5 * exp2(ceil(lod)) / size;
+
+	vec2 center = In.UVTransform.zw + 0.5 * In.UVTransform.xy;
+	vec2 extent = max(0.5 * In.UVTransform.xy - halfTexel, vec2(0.0));
+	uv = mix(clamp(uv, center - extent, center + extent), uv, greaterThanEqual(In.UVTransform.xy, vec2(1.0)));
+
+	vec4 color = textureGrad(diffuse, uv, dx, dy).rgba;
 
 	if (color.a < 0.5) discard;
 
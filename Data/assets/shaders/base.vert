@@ -1,7 +1,6 @@
 #version 450 core
 
 layout (location = 0) in vec3 aPosition;
-layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec3 aNormal;
 layout (location = 3) in vec2 aTexCoord;
 
@@ -13,6 +12,9 @@ layout (set = 0, binding = 0) uniform scene_data
 struct ObjectData
 {
 	mat4 Model;
+	vec4 PositionOffset;
+	vec4 PositionScale;
+	vec4 UVTransform;
 };
 
 layout (std140, set = 1, binding = 0) readonly buffer obj_data
@@ -25,11 +27,15 @@ out vs_out
 {
 	vec2 TexCoord;
 	vec3 Color;
+	vec3 Normal;
+	flat vec4 UVTransform;
 } Out;
 
 void main()
 {
 	gl_Position = Scene.VP * Objects.Matrices[gl_InstanceIndex].Model * vec4(aPosition, 1.0);
 	Out.TexCoord = aTexCoord;
-	Out.Color = aColor;
+	Out.Color = vec3(1.0);
+	Out.Normal = mat3(Objects.Matrices[gl_InstanceIndex].Model) * aNormal;
+	Out.UVTransform = Objects.Matrices[gl_InstanceIndex].UVTransform;
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#version 450 core
+
+// Quantized vertices (VKP::PackedVertex): the formats turn position and normal into normalized
+// floats and UVs into full floats, the rest is decoded here
+layout (location = 0) in vec4 aPosition;
+layout (location = 2) in vec2 aNormal;
+layout (location = 3) in vec2 aTexCoord;
+
+layout (set = 0, binding = 0) uniform scene_data
+{
+	mat4 VP;
+} Scene;
+
+struct ObjectData
+{
+	mat4 Model;
+	vec4 PositionOffset;
+	vec4 PositionScale;
+	vec4 UVTransform;
+};
+
+layout (std140, set = 1, binding = 0) readonly buffer obj_data
+{
+	ObjectData Matrices[];
+} Objects;
+
+layout (location = 0)
+out vs_out
+{
+	vec2 TexCoord;
+	vec3 Color;
+	vec3 Normal;
+	flat vec4 UVTransform;
+} Out;
+
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+
+	return normalize(n);
+}
+
+void main()
+{
+	ObjectData object = Objects.Matrices[gl_InstanceIndex];
+
+	vec3 position = object.PositionOffset.xyz + aPosition.xyz * object.PositionScale.xyz;
+
+	gl_Position = Scene.VP * object.Model * vec4(position, 1.0);
+	Out.TexCoord = aTexCoord;
+	Out.Color = vec3(1.0);
+	Out.Normal = mat3(object.Model) * DecodeOctahedral(aNormal);
+	Out.UVTransform = object.UVTransform;
+}
\ No newline at end of file
@@ -26,11 +26,20 @@ namespace VKP
 		delete m_Window;
 		delete m_Scene;
 
+		Assets::UnloadDictionaries();
+		Assets::UnmountArchives();
+
 		s_Instance = nullptr;
 	}
 
 	void Application::Init()
 	{
+		// Loose asset files are used whenever the packed archive is missing
+		Assets::MountArchive("assets/models/BatchingTest/BatchingTest.vkpak");
+
+		// Only present when the assets were packed with --dictionary
+		Assets::LoadDictionary("assets/models/BatchingTest/BatchingTest.dict");
+
 		m_Scene->LoadFromPrefab("assets/models/BatchingTest/BatchingTest.prfb");
 		// ^ should register objects with renderer3D
 		// ^ Renderer3D should split them into passes, then push them to large VBO/IBO
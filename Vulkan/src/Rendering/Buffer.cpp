@@ -30,6 +30,20 @@ namespace VKP::Impl
 		return true;
 	}
 
+	bool CreateStagingBuffer(State* s, Buffer* staging, VkDeviceSize size, void** data)
+	{
+		if (!CreateBuffer(s, staging, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT))
+			return false;
+
+		VmaAllocationInfo allocInfo = {};
+		vmaGetAllocationInfo(s->MemAllocator, staging->MemoryHandle, &allocInfo);
+
+		*data = allocInfo.pMappedData;
+		staging->Size = (uint32_t)size;
+
+		return true;
+	}
+
 	bool CopyBuffer(State* s, const Buffer* src, const Buffer* dst, VkDeviceSize size)
 	{
 		const std::function<void(VkCommandBuffer)> fn = [&](VkCommandBuffer cmdBuffer)
@@ -113,6 +127,37 @@ namespace VKP::Impl
 		return success;
 	}
 
+	bool CreateMeshBuffers(State* s, Buffer* vbo, Buffer* ibo, const Buffer* staging, VkDeviceSize vboSize, VkDeviceSize iboSize)
+	{
+		vmaFlushAllocation(s->MemAllocator, staging->MemoryHandle, 0, VK_WHOLE_SIZE);
+
+		if (!CreateBuffer(s, vbo, vboSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT))
+			return false;
+
+		if (!CreateBuffer(s, ibo, iboSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT))
+			return false;
+
+		const std::function<void(VkCommandBuffer)> fn = [&](VkCommandBuffer cmdBuffer)
+		{
+			VkBufferCopy region = {};
+			region.srcOffset = 0;
+			region.dstOffset = 0;
+			region.size = vboSize;
+
+			vkCmdCopyBuffer(cmdBuffer, staging->BufferHandle, vbo->BufferHandle, 1, &region);
+
+			region.srcOffset = vboSize;
+			region.size = iboSize;
+
+			vkCmdCopyBuffer(cmdBuffer, staging->BufferHandle, ibo->BufferHandle, 1, &region);
+		};
+
+		vbo->Size = (uint32_t)vboSize;
+		ibo->Size = (uint32_t)iboSize;
+
+		return SubmitTransfer(s, fn);
+	}
+
 	bool CreateUniformBuffer(State* s, Buffer* ubo, VkDeviceSize size)
 	{
 		const VkDeviceSize alignedSize = GetAlignedSize(size, s->PhysDeviceProperties.limits.minUniformBufferOffsetAlignment);
@@ -24,9 +24,11 @@ namespace VKP::Impl
 	struct State;
 
 	bool CreateBuffer(State* s, Buffer* buffer, VkDeviceSize size, VkBufferUsageFlags bufferUsage, VmaAllocationCreateFlags memoryFlags);
+	bool CreateStagingBuffer(State* s, Buffer* staging, VkDeviceSize size, void** data);
 	bool CopyBuffer(State* s, const Buffer* src, const Buffer* dst, VkDeviceSize size);
 	bool CreateVertexBuffer(State* s, Buffer* vbo, const std::vector<Vertex>& vertices);
 	bool CreateIndexBuffer(State* s, Buffer* ibo, const std::vector<uint32_t>& indices);
+	bool CreateMeshBuffers(State* s, Buffer* vbo, Buffer* ibo, const Buffer* staging, VkDeviceSize vboSize, VkDeviceSize iboSize);
 	bool CreateUniformBuffer(State* s, Buffer* ubo, VkDeviceSize size);
 	bool CreateStorageBuffer(State* s, Buffer* ssbo, VkDeviceSize size);
 	void DestroyBuffer(State* s, Buffer* buffer);
@@ -16,6 +16,9 @@ namespace VKP
 	{
 		vkDeviceWaitIdle(Impl::State::Data->Device);
 
+		for (auto& frame : Impl::State::Data->Frames)
+			frame.DeletionQueue.Flush();
+
 		Impl::State::Data->DeletionQueue.Flush();
 
 		if (Impl::State::Data->MemAllocator != VK_NULL_HANDLE)
@@ -78,6 +81,9 @@ namespace VKP
 	{
 		vkWaitForFences(Impl::State::Data->Device, 1, &Impl::State::Data->Frames[Impl::State::Data->CurrentFrame].PrevFrameRenderEnded, VK_TRUE, UINT64_MAX);
 
+		// The last commands recorded for this frame slot have executed, so what they used can go
+		Impl::State::Data->Frames[Impl::State::Data->CurrentFrame].DeletionQueue.Flush();
+
 		VkResult result = vkAcquireNextImageKHR(Impl::State::Data->Device, Impl::State::Data->Swapchain, UINT64_MAX, Impl::State::Data->Frames[Impl::State::Data->CurrentFrame].CanAcquireImage, VK_NULL_HANDLE, &Impl::State::Data->SwcData.CurrentImageId);
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR)
@@ -394,6 +400,7 @@ namespace VKP::Impl
 				s->PhysDevice = d;
 
 				vkGetPhysicalDeviceProperties(d, &s->PhysDeviceProperties);
+				vkGetPhysicalDeviceFeatures(d, &s->PhysDeviceFeatures);
 
 				VkSampleCountFlagBits maxSamples = GetMsaaMaxSamples(s->PhysDeviceProperties);
 				s->SwcData.NumSamples = std::min(VK_SAMPLE_COUNT_8_BIT, maxSamples);
@@ -436,6 +443,9 @@ namespace VKP::Impl
 		VkPhysicalDeviceFeatures features = {};
 		memset(&features, 0, sizeof(VkPhysicalDeviceFeatures));
 
+		// Enabled whenever available, textures stored in BC formats fail to load without it
+		features.textureCompressionBC = s->PhysDeviceFeatures.textureCompressionBC;
+
 #if defined(VKP_DEBUG) && !defined(VKP_PLATFORM_APPLE)
 
 		features.pipelineStatisticsQuery = VK_TRUE;
@@ -12,6 +12,18 @@ namespace VKP
 
 	MaterialCache* MaterialCache::s_Instance = nullptr;
 	std::unordered_map<std::string, Material*> MaterialCache::s_ResourceMap = {};
+	std::map<std::vector<Texture*>, TextureBinding*> MaterialCache::s_BindingMap = {};
+
+	// Sum of the versions of a binding's textures, which changes whenever one of them is resized
+	static uint32_t GetTextureVersion(const TextureBinding* binding)
+	{
+		uint32_t version = 0;
+
+		for (const auto* t : binding->Textures)
+			version += t->Version;
+
+		return version;
+	}
 
 	MaterialCache::MaterialCache(VkDevice device) : m_Device(device)
 	{
@@ -32,6 +44,20 @@ namespace VKP
 		m_DefaultTemplate.PipeLayout = effect.m_PipeLayout;
 
 		VKP_ASSERT(m_DefaultTemplate.Pipe != VK_NULL_HANDLE, "Fatal: Unable to create default pipeline");
+
+		// Same material, but fed quantized vertices that the vertex shader decodes
+		auto packedVert = shaderCache.Create("assets/shaders/base_packed.vert.spv");
+
+		ShaderEffect packedEffect = {};
+		packedEffect.AddStage(packedVert, VK_SHADER_STAGE_VERTEX_BIT);
+		packedEffect.AddStage(baseFrag, VK_SHADER_STAGE_FRAGMENT_BIT);
+		packedEffect.Reflect(&descSetLayoutCache, &pipeLayoutCache);
+
+		f.Layout = VertexLayout::Packed;
+		m_PackedTemplate.Pipe = f.Build(Renderer3D::GetDefaultRenderPass(), &packedEffect);
+		m_PackedTemplate.PipeLayout = packedEffect.m_PipeLayout;
+
+		VKP_ASSERT(m_PackedTemplate.Pipe != VK_NULL_HANDLE, "Fatal: Unable to create packed vertex pipeline");
 	}
 
 	MaterialCache::~MaterialCache()
@@ -39,45 +65,134 @@ namespace VKP
 		for (auto& p : s_ResourceMap)
 			delete p.second;
 
+		for (auto& p : s_BindingMap)
+			delete p.second;
+
 		vkDestroyPipeline(m_Device, m_DefaultTemplate.Pipe, nullptr);
+		vkDestroyPipeline(m_Device, m_PackedTemplate.Pipe, nullptr);
 
 		s_ResourceMap.clear();
+		s_BindingMap.clear();
 	}
 
-	Material* MaterialCache::Create(const std::string& name, const std::vector<Texture*>& textures)
+	Material* MaterialCache::Create(const std::string& name, const std::vector<Texture*>& textures, const glm::vec4& uvTransform)
 	{
 		auto it = s_ResourceMap.find(name);
 
 		if (it != s_ResourceMap.end())
 			return (*it).second;
 
+		for (auto* t : textures)
+		{
+			if (t == nullptr)
+			{
+				VKP_ERROR("Material is missing a texture ({})", name);
+				return nullptr;
+			}
+		}
+
+		auto binding = s_BindingMap.find(textures);
+		TextureBinding* shared = binding != s_BindingMap.end() ? binding->second : CreateBinding(textures);
+
+		if (shared == nullptr)
+			return nullptr;
+
 		Material* mat = new Material();
 		mat->Path = std::move(name);
 		mat->Template = &m_DefaultTemplate;
+		mat->PackedTemplate = &m_PackedTemplate;
+		mat->Textures = shared;
+		mat->UVTransform = uvTransform;
+
+		s_ResourceMap[mat->Path] = mat;
+		return mat;
+	}
+
+	void MaterialCache::Update()
+	{
+		for (auto& p : s_ResourceMap)
+		{
+			Material* mat = p.second;
+
+			if (mat->ScreenSize <= 0.0f) continue;
+
+			// Only part of an atlas page spans the surface, the whole page would span this much
+			const float screenSize = mat->ScreenSize / std::max(mat->UVTransform.x, mat->UVTransform.y);
+
+			for (auto* t : mat->Textures->Textures)
+				TextureCache::Get().Request(t, screenSize);
+
+			mat->ScreenSize = 0.0f;
+		}
+
+		const uint32_t frame = Impl::State::Data->CurrentFrame;
+
+		std::vector<VkDescriptorImageInfo> infos;
+		std::vector<VkWriteDescriptorSet> writes;
+
+		for (auto& p : s_BindingMap)
+		{
+			TextureBinding* binding = p.second;
+			const uint32_t version = GetTextureVersion(binding);
+
+			if (binding->Versions[frame] == version) continue;
+
+			infos.resize(binding->Textures.size());
+			writes.resize(binding->Textures.size());
+
+			for (size_t i = 0; i < binding->Textures.size(); i++)
+			{
+				infos[i].imageView = binding->Textures[i]->ViewHandle;
+				infos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				infos[i].sampler = binding->Textures[i]->SamplerHandle;
+
+				writes[i] = {};
+				writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[i].dstSet = binding->Sets[frame];
+				writes[i].dstBinding = static_cast<uint32_t>(i);
+				writes[i].descriptorCount = 1;
+				writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				writes[i].pImageInfo = &infos[i];
+			}
+
+			vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+			binding->Versions[frame] = version;
+		}
+	}
+
+	TextureBinding* MaterialCache::CreateBinding(const std::vector<Texture*>& textures)
+	{
+		TextureBinding* binding = new TextureBinding();
+		binding->Textures = textures;
 
 		DescriptorSetFactory builder = DescriptorSetFactory(m_Device, &DescriptorSetLayoutCache::Get(), Impl::State::Data->DescriptorSetAlloc);
+		std::vector<VkDescriptorImageInfo> infos(textures.size());
 
 		for (size_t i = 0; i < textures.size(); i++)
 		{
-			VkDescriptorImageInfo info = {};
-			info.imageView = textures[i]->ViewHandle;
-			info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			info.sampler = textures[i]->SamplerHandle;
-
-			builder.BindImage(i, &info, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT);
+			infos[i].imageView = textures[i]->ViewHandle;
+			infos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			infos[i].sampler = textures[i]->SamplerHandle;
 		}
 
-		builder.Build(mat->TextureSet);
+		binding->Sets.resize(MAX_CONCURRENT_FRAMES, VK_NULL_HANDLE);
+		binding->Versions.resize(MAX_CONCURRENT_FRAMES, GetTextureVersion(binding));
 
-		if (mat->TextureSet == VK_NULL_HANDLE)
+		for (auto& set : binding->Sets)
 		{
-			VKP_ERROR("Unable to create descriptor set for specified textures");
-			delete mat;
-			return nullptr;
+			for (size_t i = 0; i < textures.size(); i++)
+				builder.BindImage(i, &infos[i], VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT);
+
+			if (!builder.Build(set))
+			{
+				VKP_ERROR("Unable to create descriptor set for specified textures");
+				delete binding;
+				return nullptr;
+			}
 		}
 
-		s_ResourceMap[mat->Path] = mat;
-		return mat;
+		s_BindingMap[textures] = binding;
+		return binding;
 	}
 
 	MaterialCache* MaterialCache::Create(VkDevice device)
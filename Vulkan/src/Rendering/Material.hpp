@@ -6,16 +6,37 @@
 #include "Rendering/Texture.hpp"
 
 #include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <map>
 
 namespace VKP
 {
 
+	// Descriptor sets for one list of textures, shared by every material sampling the same ones,
+	// e.g. materials whose textures were packed into one atlas page. There is one set per frame in
+	// flight, so a streaming texture's new view can be written into one while the other is still
+	// in use; the versions show which views each set holds.
+	struct TextureBinding
+	{
+		std::vector<Texture*> Textures = {};
+		std::vector<VkDescriptorSet> Sets = {};
+		std::vector<uint32_t> Versions = {};
+	};
+
 	struct Material
 	{
 		UID Uid;
 		std::string Path = "";
 		Pipeline* Template = nullptr;
-		VkDescriptorSet TextureSet = VK_NULL_HANDLE;
+		Pipeline* PackedTemplate = nullptr;
+		TextureBinding* Textures = nullptr;
+
+		// Part of its textures the material samples, as xy scale and zw offset of the UVs
+		glm::vec4 UVTransform = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+
+		// Largest screen span in pixels of anything drawn with this material since the last update
+		float ScreenSize = 0.0f;
 
 		inline operator const uint64_t& () const { return (const uint64_t&)Uid; }
 	};
@@ -28,7 +49,11 @@ namespace VKP
 
 		MaterialCache& operator=(MaterialCache&) = delete;
 
-		Material* Create(const std::string& name, const std::vector<Texture*>& textures);
+		Material* Create(const std::string& name, const std::vector<Texture*>& textures, const glm::vec4& uvTransform = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f));
+
+		// Passes each material's screen size on to its streaming textures and rewrites the current
+		// frame's texture sets whose textures have changed views
+		void Update();
 
 		static MaterialCache* Create(VkDevice device);
 		static MaterialCache& Get();
@@ -37,11 +62,15 @@ namespace VKP
 		VkDevice m_Device;
 
 		Pipeline m_DefaultTemplate = {};
+		Pipeline m_PackedTemplate = {};
 
 		static MaterialCache* s_Instance;
 		static std::unordered_map<std::string, Material*> s_ResourceMap;
+		static std::map<std::vector<Texture*>, TextureBinding*> s_BindingMap;
 
 		MaterialCache(VkDevice device);
+
+		TextureBinding* CreateBinding(const std::vector<Texture*>& textures);
 	};
 
 }
\ No newline at end of file
@@ -9,23 +9,33 @@
 
 #include <AssetLibrary.hpp>
 
+#include <cfloat>
+
 namespace VKP
 {
 
 	MeshCache* MeshCache::s_Instance = nullptr;
 	std::unordered_map<std::string, Mesh*> MeshCache::s_ResourceMap = {};
+	std::unordered_map<uint64_t, Mesh*> MeshCache::s_ContentMap = {};
 
 	MeshCache::~MeshCache()
 	{
+		// Several paths can point to the same mesh when their contents match
+		std::unordered_set<Mesh*> meshes;
+
 		for (auto& p : s_ResourceMap)
+			meshes.insert(p.second);
+
+		for (auto* m : meshes)
 		{
-			Impl::DestroyBuffer(Impl::State::Data, &p.second->VBO);
-			Impl::DestroyBuffer(Impl::State::Data, &p.second->IBO);
+			Impl::DestroyBuffer(Impl::State::Data, &m->VBO);
+			Impl::DestroyBuffer(Impl::State::Data, &m->IBO);
 
-			delete p.second;
+			delete m;
 		}
 
 		s_ResourceMap.clear();
+		s_ContentMap.clear();
 	}
 
 	Mesh* MeshCache::Create(const std::string& name)
@@ -35,31 +45,155 @@ namespace VKP
 		if (it != s_ResourceMap.end())
 			return it->second;
 
-		Assets::Asset file;
+		Assets::AssetView file = {};
 
-		if (!Assets::LoadBinary(name.c_str(), file))
+		if (!Assets::MapBinary(name.c_str(), file))
 		{
 			VKP_ERROR("Unable to load model file {}", name);
 			return nullptr;
 		}
 
+		auto info = Assets::ParseMeshAssetInfo(&file);
+
+		if (info.Format != Assets::VertexFormat::PosColNorUV && info.Format != Assets::VertexFormat::PackedPosColNorUV)
+		{
+			VKP_ERROR("Unsupported vertex format in model file {}", name);
+			Assets::UnmapBinary(file);
+			return nullptr;
+		}
+
+		if (info.ContentHash != 0)
+		{
+			auto shared = s_ContentMap.find(info.ContentHash);
+
+			if (shared != s_ContentMap.end())
+			{
+				Assets::UnmapBinary(file);
+
+				s_ResourceMap[name] = shared->second;
+				return shared->second;
+			}
+		}
+
+		const uint32_t numVertices = Assets::GetVertexCount(&info);
+		const uint32_t vertexBufferSize = numVertices * Assets::GetVertexStride(info.Format, MeshVertexAttributes);
+
+		Buffer staging = {};
+		uint8_t* stagingData = nullptr;
+
+		// Vertex and index data are decompressed straight into a single mapped staging allocation
+		if (!Impl::CreateStagingBuffer(Impl::State::Data, &staging, vertexBufferSize + info.IndexBufferSize, (void**)&stagingData))
+		{
+			VKP_ERROR("Unable to create staging buffer for mesh upload ({})", name);
+			Assets::UnmapBinary(file);
+			return nullptr;
+		}
+
+		bool unpacked = false;
+
+		if (info.Attributes == MeshVertexAttributes)
+			unpacked = Assets::UnpackMesh(&info, file.Binary.Data, file.Binary.Size, stagingData);
+
+		else
+		{
+			// Interleaved or differently split vertices go through a copy into the streams the pipelines expect
+			std::vector<uint8_t> data(info.VertexBufferSize + info.IndexBufferSize);
+			unpacked = Assets::UnpackMesh(&info, file.Binary.Data, file.Binary.Size, data.data());
+
+			if (unpacked)
+			{
+				Assets::ConvertVertexStreams(info.Format, stagingData, MeshVertexAttributes, data.data(), info.Attributes, numVertices);
+				memcpy(stagingData + vertexBufferSize, data.data() + info.VertexBufferSize, info.IndexBufferSize);
+			}
+		}
+
+		if (!unpacked)
+		{
+			VKP_ERROR("Unable to decompress mesh data ({})", name);
+			vmaDestroyBuffer(Impl::State::Data->MemAllocator, staging.BufferHandle, staging.MemoryHandle);
+			Assets::UnmapBinary(file);
+			return nullptr;
+		}
+
+		std::vector<Assets::Meshlet> meshlets(info.MeshletCount);
+		std::vector<Assets::MeshLod> lods(info.LodCount);
+
+		if (!Assets::UnpackMeshlets(&info, file.Binary.Data, file.Binary.Size, meshlets.data()))
+			meshlets.clear();
+
+		if (!Assets::UnpackMeshLods(&info, file.Binary.Data, file.Binary.Size, lods.data()))
+			lods.clear();
+
+		Assets::UnmapBinary(file);
+
 		auto mesh = new Mesh();
 		mesh->Path = name;
+		mesh->ContentHash = info.ContentHash;
 
-		auto info = Assets::ParseMeshAssetInfo(&file);
+		if (info.IndexType == Assets::IndexFormat::UInt16)
+			mesh->IndexType = VK_INDEX_TYPE_UINT16;
 
-		std::vector<Vertex> vertices(info.VertexBufferSize / sizeof(Vertex));
-		std::vector<uint32_t> indices(info.IndexBufferSize / sizeof(uint32_t));
+		if (info.Format == Assets::VertexFormat::PackedPosColNorUV)
+		{
+			mesh->Layout = VertexLayout::Packed;
+			mesh->PositionOffset = glm::vec3(info.PositionOffset[0], info.PositionOffset[1], info.PositionOffset[2]);
+			mesh->PositionScale = glm::vec3(info.PositionScale[0], info.PositionScale[1], info.PositionScale[2]);
+		}
+
+		mesh->AttributeOffset = (VkDeviceSize)numVertices * GetStreamStride(mesh->Layout, VertexAttributePosition);
+
+		// Packed positions already span the quantization box, float ones are scanned
+		glm::vec3 minimum = mesh->PositionOffset;
+		glm::vec3 maximum = mesh->PositionOffset + mesh->PositionScale;
+
+		if (mesh->Layout == VertexLayout::Float && numVertices > 0)
+		{
+			minimum = glm::vec3(FLT_MAX);
+			maximum = glm::vec3(-FLT_MAX);
+
+			for (uint32_t v = 0; v < numVertices; v++)
+			{
+				glm::vec3 position;
+				memcpy(&position, stagingData + (size_t)v * sizeof(glm::vec3), sizeof(glm::vec3));
+
+				minimum = glm::min(minimum, position);
+				maximum = glm::max(maximum, position);
+			}
+		}
+
+		mesh->BoundsCenter = (minimum + maximum) * 0.5f;
+		mesh->BoundsRadius = glm::length(maximum - minimum) * 0.5f;
 
-		Assets::UnpackMesh(&info, file.Binary.data(), file.Binary.size(), (uint8_t*)vertices.data(), (uint8_t*)indices.data());
+		mesh->Clusters.reserve(meshlets.size());
 
-		bool success = Impl::CreateVertexBuffer(Impl::State::Data, &mesh->VBO, vertices);
-		if (success) success = Impl::CreateIndexBuffer(Impl::State::Data, &mesh->IBO, indices);
+		for (const auto& m : meshlets)
+		{
+			MeshCluster cluster;
+			cluster.FirstIndex = m.IndexOffset;
+			cluster.IndexCount = m.IndexCount;
+			cluster.Center = glm::vec3(m.Center[0], m.Center[1], m.Center[2]);
+			cluster.Radius = m.Radius;
+			cluster.ConeApex = glm::vec3(m.ConeApex[0], m.ConeApex[1], m.ConeApex[2]);
+			cluster.ConeAxis = glm::vec3(m.ConeAxis[0], m.ConeAxis[1], m.ConeAxis[2]);
+			cluster.ConeCutoff = m.ConeCutoff;
+
+			mesh->Clusters.push_back(cluster);
+		}
+
+		for (const auto& l : lods)
+			mesh->Lods.push_back({ l.IndexOffset, l.IndexCount, l.Error });
+
+		bool success = Impl::CreateMeshBuffers(Impl::State::Data, &mesh->VBO, &mesh->IBO, &staging, vertexBufferSize, info.IndexBufferSize);
+		Impl::DestroyBuffer(Impl::State::Data, &staging);
 
 		if (success)
 		{
-			mesh->NumVertices = vertices.size();
-			mesh->NumIndices = indices.size();
+			mesh->NumVertices = numVertices;
+			mesh->NumIndices = info.IndexBufferSize / Assets::GetIndexSize(info.IndexType);
+
+			// The index buffer holds every LOD back to back, the full mesh first
+			if (!mesh->Lods.empty())
+				mesh->NumIndices = mesh->Lods[0].IndexCount;
 		}
 
 		else
@@ -73,9 +207,60 @@ namespace VKP
 
 		s_ResourceMap[name] = mesh;
 
+		if (info.ContentHash != 0)
+			s_ContentMap[info.ContentHash] = mesh;
+
 		return mesh;
 	}
 
+	void ExtractFrustumPlanes(const glm::mat4& mvp, glm::vec4 planes[6])
+	{
+		const glm::vec4 r0 = glm::vec4(mvp[0][0], mvp[1][0], mvp[2][0], mvp[3][0]);
+		const glm::vec4 r1 = glm::vec4(mvp[0][1], mvp[1][1], mvp[2][1], mvp[3][1]);
+		const glm::vec4 r2 = glm::vec4(mvp[0][2], mvp[1][2], mvp[2][2], mvp[3][2]);
+		const glm::vec4 r3 = glm::vec4(mvp[0][3], mvp[1][3], mvp[2][3], mvp[3][3]);
+
+		planes[0] = r3 + r0;
+		planes[1] = r3 - r0;
+		planes[2] = r3 + r1;
+		planes[3] = r3 - r1;
+		planes[4] = r2; // Vulkan clip space depth is 0..1
+		planes[5] = r3 - r2;
+
+		for (uint32_t i = 0; i < 6; i++)
+			planes[i] /= glm::length(glm::vec3(planes[i]));
+	}
+
+	bool IsClusterVisible(const MeshCluster& cluster, const glm::vec4 planes[6], const glm::vec3& localCamera)
+	{
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			if (glm::dot(glm::vec3(planes[i]), cluster.Center) + planes[i].w < -cluster.Radius)
+				return false;
+		}
+
+		// Matches Assets::IsMeshletBackfacing
+		if (cluster.ConeCutoff >= 1.0f) return true;
+
+		const glm::vec3 view = cluster.ConeApex - localCamera;
+		const float distance = glm::length(view);
+
+		return distance == 0.0f || glm::dot(view, cluster.ConeAxis) < cluster.ConeCutoff * distance;
+	}
+
+	uint32_t SelectMeshLod(const Mesh& mesh, float distance, float pixelsPerUnit, float maxPixelError)
+	{
+		uint32_t lod = 0;
+
+		for (uint32_t i = 1; i < mesh.Lods.size(); i++)
+		{
+			if (mesh.Lods[i].Error * pixelsPerUnit > maxPixelError * distance) break;
+			lod = i;
+		}
+
+		return lod;
+	}
+
 	MeshCache* MeshCache::Create()
 	{
 		if (s_Instance == nullptr)
@@ -3,10 +3,33 @@
 #include "Core/UID.hpp"
 
 #include "Rendering/Buffer.hpp"
+#include "Rendering/VertexData.hpp"
+
+#include <glm/glm.hpp>
 
 namespace VKP
 {
 
+	// A contiguous range of the index buffer with bounds for frustum and backface culling
+	struct MeshCluster
+	{
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		glm::vec3 Center = glm::vec3(0.0f);
+		float Radius = 0.0f;
+		glm::vec3 ConeApex = glm::vec3(0.0f);
+		glm::vec3 ConeAxis = glm::vec3(0.0f);
+		float ConeCutoff = 1.0f;
+	};
+
+	// A range of the index buffer drawing the mesh at lower detail; Error is in model units
+	struct MeshLod
+	{
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		float Error = 0.0f;
+	};
+
 	struct Mesh
 	{
 		UID Uid;
@@ -15,10 +38,28 @@ namespace VKP
 		Buffer IBO = {};
 		uint32_t NumIndices = 0;
 		uint32_t NumVertices = 0;
+		uint64_t ContentHash = 0;
+		VertexLayout Layout = VertexLayout::Float;
+		VkDeviceSize AttributeOffset = 0; // Start of the second vertex stream in VBO, after the positions
+		VkIndexType IndexType = VK_INDEX_TYPE_UINT32;
+		glm::vec3 PositionOffset = glm::vec3(0.0f);
+		glm::vec3 PositionScale = glm::vec3(1.0f);
+		std::vector<MeshCluster> Clusters = {};
+		std::vector<MeshLod> Lods = {};
+		glm::vec3 BoundsCenter = glm::vec3(0.0f); // Sphere around every vertex, in model space
+		float BoundsRadius = 0.0f;
 
 		inline operator const uint64_t& () const { return (const uint64_t&)Uid; }
 	};
 
+	// Planes are extracted from a model-view-projection matrix, so culling happens in object space
+	void ExtractFrustumPlanes(const glm::mat4& mvp, glm::vec4 planes[6]);
+	bool IsClusterVisible(const MeshCluster& cluster, const glm::vec4 planes[6], const glm::vec3& localCamera);
+
+	// Coarsest LOD whose error projects to at most maxPixelError pixels at distance, where
+	// pixelsPerUnit is the viewport height over 2 * tan(fovy / 2)
+	uint32_t SelectMeshLod(const Mesh& mesh, float distance, float pixelsPerUnit, float maxPixelError);
+
 	class MeshCache final
 	{
 	public:
@@ -33,6 +74,7 @@ namespace VKP
 	private:
 		static MeshCache* s_Instance;
 		static std::unordered_map<std::string, Mesh*> s_ResourceMap;
+		static std::unordered_map<uint64_t, Mesh*> s_ContentMap;
 
 		MeshCache() = default;
 	};
@@ -59,7 +59,7 @@ namespace VKP
 		std::vector<VkVertexInputBindingDescription> vertBind = {};
 		std::vector<VkVertexInputAttributeDescription> descriptions = {};
 
-		Vertex::PopulateBindingDescription(vertBind, descriptions);
+		PopulateStreamDescription(Layout, Attributes, vertBind, descriptions);
 
 		VkPipelineVertexInputStateCreateInfo vertInfo = {};
 		vertInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Rendering/Shader.hpp"
+#include "Rendering/VertexData.hpp"
 
 #include <vulkan/vulkan.h>
 
@@ -16,6 +17,9 @@ namespace VKP
 
 	struct GraphicsPipelineFactory
 	{
+		VertexLayout Layout = VertexLayout::Float;
+		// Only VertexAttributePosition, as for depth or shadow passes, binds just the position stream
+		uint32_t Attributes = MeshVertexAttributes;
 		VkPipelineRasterizationStateCreateInfo RasterInfo = {};
 		VkPipelineColorBlendAttachmentState BlendState = {};
 		VkPipelineDepthStencilStateCreateInfo DepthInfo = {};
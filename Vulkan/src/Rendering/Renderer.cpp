@@ -13,6 +13,28 @@ namespace VKP
 	Renderer3DData Renderer3D::s_Data = {};
 	MeshPass Renderer3D::s_ForwardPass = {};
 
+	static uint32_t GetDrawKey(const Renderable* r)
+	{
+		if (r->Model == nullptr) return 0;
+
+		return ((uint32_t)r->Model->Layout << 1) | (r->Model->IndexType == VK_INDEX_TYPE_UINT16 ? 1 : 0);
+	}
+
+	// Pixels the bounding sphere of r spans on screen with the 70 degree projection used for drawing
+	static float GetScreenSize(const Renderable* r, const Camera* camera)
+	{
+		if (r->Model == nullptr) return 0.0f;
+
+		const glm::vec3 center = glm::vec3(r->Matrix * glm::vec4(r->Model->BoundsCenter, 1.0f));
+		const float scale = std::max({ glm::length(glm::vec3(r->Matrix[0])), glm::length(glm::vec3(r->Matrix[1])), glm::length(glm::vec3(r->Matrix[2])) });
+		const float radius = r->Model->BoundsRadius * scale;
+
+		const float pixelsPerUnit = (float)Impl::State::Data->SurfaceHeight / (2.0f * std::tan(glm::radians(35.0f)));
+		const float distance = std::max(glm::length(center - camera->Position) - radius, 0.1f);
+
+		return 2.0f * radius * pixelsPerUnit / distance;
+	}
+
 	bool Renderer3D::Init()
 	{
 		bool success = CreateRenderPass();
@@ -122,6 +144,17 @@ namespace VKP
 		builder.BindBuffer(0, &ssboInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
 		builder.Build(s_Data.ObjectDataDescSet);
 
+		// Streaming textures follow the largest screen span of anything using them, and the copies
+		// this records have to land before the render pass begins
+		for (const auto* r : s_ForwardPass.UnbatchedObjects)
+		{
+			if (r->Mat != nullptr)
+				r->Mat->ScreenSize = std::max(r->Mat->ScreenSize, GetScreenSize(r, camera));
+		}
+
+		s_Data.Textures->Update();
+		s_Data.Materials->Update();
+
 		std::vector<VkClearValue> clearColors(2);
 
 		clearColors[0].color = {{0.1f, 0.1f, 0.1f, 1.0f}};
@@ -141,11 +174,25 @@ namespace VKP
 		vkCmdSetViewport(Impl::State::Data->CurrentCmdBuffer, 0, 1, &Impl::State::Data->Viewport);
 		vkCmdSetScissor(Impl::State::Data->CurrentCmdBuffer, 0, 1, &Impl::State::Data->Scissor);
 
-		// if (s_Renderables.size() > 0)
+		// Draws are grouped by vertex layout, then index type, then texture set, so pipeline, index
+		// format and texture switches happen once per group rather than per object. Materials
+		// whose textures share atlas pages share their texture set.
+		auto& batches = s_ForwardPass.SortBatches;
+		batches.assign(s_ForwardPass.UnbatchedObjects.begin(), s_ForwardPass.UnbatchedObjects.end());
+
+		std::stable_sort(batches.begin(), batches.end(), [](const Renderable* a, const Renderable* b)
+		{
+			const uint32_t keyA = GetDrawKey(a), keyB = GetDrawKey(b);
+
+			if (keyA != keyB) return keyA < keyB;
+
+			return std::less<const TextureBinding*>()(a->Mat != nullptr ? a->Mat->Textures : nullptr, b->Mat != nullptr ? b->Mat->Textures : nullptr);
+		});
+
+		// if (batches.size() > 0)
 		// {
 		// 	VkPipeline pipeline = VK_NULL_HANDLE;
 		// 	VkDescriptorSet textureSet = VK_NULL_HANDLE;
-		// 	VkDeviceSize offset = 0;
 
 		// 	const float aspect = (float)Impl::State::Data->SurfaceWidth / (float)Impl::State::Data->SurfaceHeight;
 		// 	const glm::mat4 proj = glm::perspective(glm::radians(70.0f), aspect, 0.1f, 100.0f);
@@ -161,35 +208,45 @@ namespace VKP
 
 		// 	vmaUnmapMemory(Impl::State::Data->MemAllocator, s_Data.GlobalUBO.MemoryHandle);
 
-		// 	glm::mat4* matrices;
-		// 	vmaMapMemory(Impl::State::Data->MemAllocator, s_Data.ObjectSSBO.MemoryHandle, (void**)&matrices);
+		// 	ObjectData* objects;
+		// 	vmaMapMemory(Impl::State::Data->MemAllocator, s_Data.ObjectSSBO.MemoryHandle, (void**)&objects);
 
-		// 	for (size_t i = 0; i < s_Renderables.size(); i++)
-		// 		memcpy(&matrices[i], &s_Renderables[i]->Matrix[0][0], sizeof(glm::mat4));
+		// 	for (size_t i = 0; i < batches.size(); i++)
+		// 	{
+		// 		objects[i].Model = batches[i]->Matrix;
+		// 		objects[i].PositionOffset = glm::vec4(batches[i]->Model->PositionOffset, 0.0f);
+		// 		objects[i].PositionScale = glm::vec4(batches[i]->Model->PositionScale, 1.0f);
+		// 		objects[i].UVTransform = batches[i]->Mat->UVTransform;
+		// 	}
 
 		// 	vmaUnmapMemory(Impl::State::Data->MemAllocator, s_Data.ObjectSSBO.MemoryHandle);
 
-		// 	for (size_t i = 0; i < s_Renderables.size(); i++)
+		// 	for (size_t i = 0; i < batches.size(); i++)
 		// 	{
-		// 		const auto& r = s_Renderables[i];
+		// 		const auto& r = batches[i];
 
-		// 		if (pipeline != r->Mat->Template->Pipe)
+		// 		const Pipeline* tmpl = r->Model->Layout == VertexLayout::Packed ? r->Mat->PackedTemplate : r->Mat->Template;
+
+		// 		if (pipeline != tmpl->Pipe)
 		// 		{
-		// 			pipeline = r->Mat->Template->Pipe;
+		// 			pipeline = tmpl->Pipe;
 
 		// 			vkCmdBindPipeline(Impl::State::Data->CurrentCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-		// 			vkCmdBindDescriptorSets(Impl::State::Data->CurrentCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, r->Mat->Template->PipeLayout, 0, 1, &s_Data.GlobalDataDescSet, 1, &s_Data.GlobalDataDescSetOffset);
-		// 			vkCmdBindDescriptorSets(Impl::State::Data->CurrentCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, r->Mat->Template->PipeLayout, 1, 1, &s_Data.ObjectDataDescSet, 0, nullptr);
+		// 			vkCmdBindDescriptorSets(Impl::State::Data->CurrentCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, tmpl->PipeLayout, 0, 1, &s_Data.GlobalDataDescSet, 1, &s_Data.GlobalDataDescSetOffset);
+		// 			vkCmdBindDescriptorSets(Impl::State::Data->CurrentCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, tmpl->PipeLayout, 1, 1, &s_Data.ObjectDataDescSet, 0, nullptr);
 		// 		}
 
-		// 		if (textureSet != r->Mat->TextureSet)
+		// 		if (textureSet != r->Mat->Textures->Sets[Impl::State::Data->CurrentFrame])
 		// 		{
-		// 			textureSet = r->Mat->TextureSet;
-		// 			vkCmdBindDescriptorSets(Impl::State::Data->CurrentCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, r->Mat->Template->PipeLayout, 2, 1, &textureSet, 0, nullptr);
+		// 			textureSet = r->Mat->Textures->Sets[Impl::State::Data->CurrentFrame];
+		// 			vkCmdBindDescriptorSets(Impl::State::Data->CurrentCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, tmpl->PipeLayout, 2, 1, &textureSet, 0, nullptr);
 		// 		}
 
-		// 		vkCmdBindVertexBuffers(Impl::State::Data->CurrentCmdBuffer, 0, 1, &r->Model->VBO.BufferHandle, &offset);
-		// 		vkCmdBindIndexBuffer(Impl::State::Data->CurrentCmdBuffer, r->Model->IBO.BufferHandle, 0, VK_INDEX_TYPE_UINT32);
+		// 		const VkBuffer streams[] = { r->Model->VBO.BufferHandle, r->Model->VBO.BufferHandle };
+		// 		const VkDeviceSize offsets[] = { 0, r->Model->AttributeOffset };
+
+		// 		vkCmdBindVertexBuffers(Impl::State::Data->CurrentCmdBuffer, 0, 2, streams, offsets);
+		// 		vkCmdBindIndexBuffer(Impl::State::Data->CurrentCmdBuffer, r->Model->IBO.BufferHandle, 0, r->Model->IndexType);
 
 		// 		vkCmdDrawIndexed(Impl::State::Data->CurrentCmdBuffer, r->Model->NumIndices, 1, 0, 0, i);
 		// 	}
@@ -26,9 +26,14 @@ namespace VKP
 		glm::mat4 VP;
 	};
 
+	// Position offset and scale undo the quantization of packed meshes and stay at 0 and 1
+	// for float ones; w is unused. UVTransform is the material's, see Material.
 	struct ObjectData
 	{
 		glm::mat4 Model;
+		glm::vec4 PositionOffset;
+		glm::vec4 PositionScale;
+		glm::vec4 UVTransform;
 	};
 
 	struct Renderer3DData
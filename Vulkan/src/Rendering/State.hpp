@@ -66,6 +66,7 @@ namespace VKP::Impl
 		VkInstance Instance = VK_NULL_HANDLE;
 		VkPhysicalDevice PhysDevice = VK_NULL_HANDLE;
 		VkPhysicalDeviceProperties PhysDeviceProperties = {};
+		VkPhysicalDeviceFeatures PhysDeviceFeatures = {};
 
 #if defined(VKP_DEBUG)
 
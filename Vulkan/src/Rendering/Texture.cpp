@@ -8,33 +8,214 @@
 
 #include <AssetLibrary.hpp>
 
+#include <atomic>
+#include <thread>
+
 namespace VKP
 {
 
 	TextureCache* TextureCache::s_Instance = nullptr;
 	std::unordered_map<std::string, Texture*> TextureCache::s_ResourceMap = {};
+	std::unordered_map<uint64_t, Texture*> TextureCache::s_ContentMap = {};
+	std::vector<Texture*> TextureCache::s_StreamingTextures = {};
+
+	// Background level loads in flight at once, each holding a staging buffer
+	static constexpr uint32_t MaxStreamingLoads = 4;
+
+	// Color spaces a format has no view for (sRGB BC5, R16 or RGBA16F) are left undefined
+	static VkFormat GetTextureFormat(const Assets::TextureAssetInfo& info)
+	{
+		const bool srgb = Assets::IsTextureSrgb(&info);
+
+		switch (info.Format)
+		{
+			case Assets::TextureFormat::RGBA8:
+				return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+
+			case Assets::TextureFormat::BC1:
+				if (info.PunchThroughAlpha)
+					return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+
+				return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+
+			case Assets::TextureFormat::BC3:
+				return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+
+			case Assets::TextureFormat::BC5:
+				return srgb ? VK_FORMAT_UNDEFINED : VK_FORMAT_BC5_UNORM_BLOCK;
+
+			case Assets::TextureFormat::BC7:
+				return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+
+			case Assets::TextureFormat::R8:
+				return srgb ? VK_FORMAT_R8_SRGB : VK_FORMAT_R8_UNORM;
+
+			case Assets::TextureFormat::RG8:
+				return srgb ? VK_FORMAT_R8G8_SRGB : VK_FORMAT_R8G8_UNORM;
+
+			case Assets::TextureFormat::R16:
+				return srgb ? VK_FORMAT_UNDEFINED : VK_FORMAT_R16_UNORM;
+
+			case Assets::TextureFormat::RGBA16F:
+				return srgb ? VK_FORMAT_UNDEFINED : VK_FORMAT_R16G16B16A16_SFLOAT;
+
+			default:
+				return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	// Block formats on devices without BC support are expanded to RGBA8 on load
+	static VkFormat GetExpandedFormat(const Assets::TextureAssetInfo& info)
+	{
+		return Assets::IsTextureSrgb(&info) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+	}
+
+	// Unpacks every level of a block compressed texture and decodes it to RGBA8, rewriting mips to
+	// describe the decoded levels
+	static bool ExpandBlocks(const Assets::TextureAssetInfo& info, const Assets::AssetView& file, std::vector<Assets::TextureMip>& mips, std::vector<uint8_t>& pixels)
+	{
+		Assets::TextureAssetInfo unpackInfo = info;
+		std::vector<uint8_t> blocks(info.FileSize);
+
+		if (!Assets::UnpackTexture(&unpackInfo, file.Binary.Data, blocks.data(), file.Binary.Size))
+			return false;
+
+		uint64_t offset = 0;
+
+		for (const auto& mip : mips)
+			offset += (uint64_t)mip.Width * mip.Height * 4;
+
+		pixels.resize(offset);
+		offset = 0;
+
+		for (auto& mip : mips)
+		{
+			if (!Assets::DecompressBlocks(info.Format, pixels.data() + offset, blocks.data() + mip.Offset, mip.Width, mip.Height))
+				return false;
+
+			mip.Offset = offset;
+			mip.Size = (uint64_t)mip.Width * mip.Height * 4;
+			offset += mip.Size;
+		}
+
+		return true;
+	}
+
+	// Single channel images come from grayscale sources and two channel ones from grayscale with
+	// alpha, so shaders sampling rgba see them the way they were authored
+	static VkComponentMapping GetTextureSwizzle(Assets::TextureFormat format)
+	{
+		switch (format)
+		{
+			case Assets::TextureFormat::R8:
+			case Assets::TextureFormat::R16:
+				return { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE };
+
+			case Assets::TextureFormat::RG8:
+				return { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G };
+
+			default:
+				return {};
+		}
+	}
+
+	enum class StreamLoad
+	{
+		Idle,
+		Pending,
+		Done,
+		Failed,
+	};
+
+	// What a streaming texture keeps after Create to load and drop levels: its asset stays mapped
+	struct TextureStream
+	{
+		Assets::AssetView File = {};
+		Assets::TextureAssetInfo Info = {};
+		std::vector<Assets::TextureMip> Mips = {};
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		VkComponentMapping Swizzle = {};
+
+		// Levels are kept between FinestMip, which drops past a level that failed to load, and TailMip
+		uint32_t FinestMip = 0;
+		uint32_t TailMip = 0;
+		uint32_t WantedMip = 0;
+
+		float RequestedSize = 0.0f;
+		uint64_t LastRequested = 0;
+
+		// Level FirstMip - 1, unpacked by a TaskPool worker into a mapped staging buffer
+		Buffer Staging = {};
+		uint8_t* StagingData = nullptr;
+		std::atomic<StreamLoad> Load = StreamLoad::Idle;
+	};
+
+	// Bytes the levels from firstMip down take, as far as the streaming budget is concerned
+	static uint64_t GetResidentSize(const TextureStream* stream, uint32_t firstMip)
+	{
+		return stream->Info.FileSize - stream->Mips[firstMip].Offset;
+	}
+
+	// Waits for a load in flight, then releases what only streaming textures hold
+	static void ReleaseStream(Texture* texture)
+	{
+		TextureStream* stream = texture->Stream;
+
+		if (stream == nullptr) return;
+
+		while (stream->Load == StreamLoad::Pending)
+			std::this_thread::yield();
+
+		if (stream->Staging.BufferHandle != VK_NULL_HANDLE)
+			vmaDestroyBuffer(Impl::State::Data->MemAllocator, stream->Staging.BufferHandle, stream->Staging.MemoryHandle);
+
+		Assets::UnmapBinary(stream->File);
+
+		delete stream;
+		texture->Stream = nullptr;
+	}
+
+	uint32_t SelectTextureMip(uint32_t width, uint32_t height, uint32_t mipLevels, float screenSize)
+	{
+		const uint32_t size = std::max(width, height);
+		uint32_t mip = 0;
+
+		while (mip + 1 < mipLevels && (float)std::max(size >> (mip + 1), 1u) >= screenSize)
+			mip++;
+
+		return mip;
+	}
 
 	TextureCache::~TextureCache()
 	{
+		// Several paths can point to the same texture when their contents match
+		std::unordered_set<Texture*> textures;
+
 		for (auto& p : s_ResourceMap)
+			textures.insert(p.second);
+
+		for (auto* t : textures)
 		{
-			Impl::DestroyTexture(Impl::State::Data, p.second);
-			delete p.second;
+			ReleaseStream(t);
+			Impl::DestroyTexture(Impl::State::Data, t);
+			delete t;
 		}
 
 		s_ResourceMap.clear();
+		s_ContentMap.clear();
+		s_StreamingTextures.clear();
 	}
 
-	Texture* TextureCache::Create(const std::string& name)
+	Texture* TextureCache::Create(const std::string& name, bool streaming)
 	{
 		auto it = s_ResourceMap.find(name);
 
 		if (it != s_ResourceMap.end())
 			return (*it).second;
 
-		Assets::Asset file;
+		Assets::AssetView file = {};
 
-		if (!Assets::LoadBinary(name.c_str(), file))
+		if (!Assets::MapBinary(name.c_str(), file))
 		{
 			VKP_ERROR("Unable to load raw texture binary file ({})", name);
 			return nullptr;
@@ -42,12 +223,74 @@ namespace VKP
 
 		auto info = Assets::ParseTextureAssetInfo(&file);
 
+		if (info.ContentHash != 0)
+		{
+			auto shared = s_ContentMap.find(info.ContentHash);
+
+			if (shared != s_ContentMap.end())
+			{
+				Assets::UnmapBinary(file);
+
+				s_ResourceMap[name] = shared->second;
+				return shared->second;
+			}
+		}
+
+		// Without BC support blocks are decoded here, which needs every level at once
+		const bool expand = Assets::GetBlockBytes(info.Format) != 0 && !Impl::State::Data->PhysDeviceFeatures.textureCompressionBC;
+		const VkFormat format = expand ? GetExpandedFormat(info) : GetTextureFormat(info);
+
+		if (expand) streaming = false;
+
+		// Sampled image support is optional for some formats, e.g. R16 or the sRGB R8 and R8G8
+		VkFormatProperties properties = {};
+
+		if (format != VK_FORMAT_UNDEFINED)
+			vkGetPhysicalDeviceFormatProperties(Impl::State::Data->PhysDevice, format, &properties);
+
+		if (format == VK_FORMAT_UNDEFINED || (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0)
+		{
+			VKP_ERROR("Texture format {} is not supported by this device ({})", Assets::GetTextureFormatName(info.Format), name);
+			Assets::UnmapBinary(file);
+			return nullptr;
+		}
+
+		std::vector<Assets::TextureMip> mips(std::max(info.MipLevels, 1u));
+
+		if (!Assets::UnpackTextureMips(&info, file.Binary.Data, file.Binary.Size, mips.data()))
+		{
+			VKP_ERROR("Texture mip table is truncated ({})", name);
+			Assets::UnmapBinary(file);
+			return nullptr;
+		}
+
+		// Streaming textures upload only their tail of small levels here, Update adds the rest
+		uint32_t firstMip = 0;
+
+		while (streaming && firstMip + 1 < mips.size() && std::max(mips[firstMip].Width, mips[firstMip].Height) > StreamingTailSize)
+			firstMip++;
+
+		std::vector<uint8_t> expanded;
+
+		if (expand && !ExpandBlocks(info, file, mips, expanded))
+		{
+			VKP_ERROR("Unable to decode texture blocks ({})", name);
+			Assets::UnmapBinary(file);
+			return nullptr;
+		}
+
+		const uint64_t baseOffset = mips[firstMip].Offset;
+		const uint64_t uploadSize = expand ? expanded.size() : info.FileSize - baseOffset;
+
 		Buffer staging = {};
 		Texture* tex = new Texture();
+		tex->MipLevels = static_cast<uint32_t>(mips.size()) - firstMip;
+		tex->FirstMip = firstMip;
 
-		if (!Impl::CreateBuffer(Impl::State::Data, &staging, info.PixelSize[0] * info.PixelSize[1] * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT))
+		if (!Impl::CreateBuffer(Impl::State::Data, &staging, uploadSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT))
 		{
 			VKP_ERROR("Unable to create staging buffer for texture upload");
+			Assets::UnmapBinary(file);
 			delete tex;
 			return nullptr;
 		}
@@ -55,23 +298,69 @@ namespace VKP
 		void* bufData = nullptr;
 		vmaMapMemory(Impl::State::Data->MemAllocator, staging.MemoryHandle, &bufData);
 
-		Assets::UnpackTexture(&info, file.Binary.data(), static_cast<uint8_t*>(bufData), file.Binary.size());
+		bool unpacked = true;
+
+		if (expand)
+			memcpy(bufData, expanded.data(), expanded.size());
+
+		else if (firstMip == 0)
+			unpacked = Assets::UnpackTexture(&info, file.Binary.Data, static_cast<uint8_t*>(bufData), file.Binary.Size);
+
+		else
+			unpacked = Assets::UnpackTextureRange(&info, file.Binary.Data, file.Binary.Size, baseOffset, uploadSize, static_cast<uint8_t*>(bufData));
 
 		vmaUnmapMemory(Impl::State::Data->MemAllocator, staging.MemoryHandle);
+		vmaFlushAllocation(Impl::State::Data->MemAllocator, staging.MemoryHandle, 0, VK_WHOLE_SIZE);
+
+		// Streaming textures keep their file mapped for the levels Update loads later
+		if (firstMip == 0 || !unpacked)
+			Assets::UnmapBinary(file);
+
+		if (!unpacked)
+		{
+			VKP_ERROR("Unable to decompress texture data ({})", name);
+			vmaDestroyBuffer(Impl::State::Data->MemAllocator, staging.BufferHandle, staging.MemoryHandle);
+			delete tex;
+			return nullptr;
+		}
 
-		if (!Impl::CreateImage(Impl::State::Data, tex, info.PixelSize[0], info.PixelSize[1], VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT))
+		// Streaming textures are copied into a new image whenever their levels change
+		const VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (firstMip != 0 ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+
+		if (!Impl::CreateImage(Impl::State::Data, tex, mips[firstMip].Width, mips[firstMip].Height, format, VK_IMAGE_TILING_OPTIMAL, usage))
 		{
 			VKP_ERROR("Unable to create image object");
 			vmaDestroyBuffer(Impl::State::Data->MemAllocator, staging.BufferHandle, staging.MemoryHandle);
+
+			if (firstMip != 0) Assets::UnmapBinary(file);
+
 			delete tex;
 			return nullptr;
 		}
 
-		bool success = Impl::PopulateImage(Impl::State::Data, tex, &staging, info.PixelSize[0], info.PixelSize[1]);
+		// Every level was generated offline, so they all go up in a single copy
+		std::vector<VkBufferImageCopy> regions(tex->MipLevels);
+
+		for (size_t i = 0; i < regions.size(); i++)
+		{
+			const Assets::TextureMip& mip = mips[firstMip + i];
+
+			regions[i].bufferOffset = mip.Offset - baseOffset;
+			regions[i].bufferRowLength = 0;
+			regions[i].bufferImageHeight = 0;
+			regions[i].imageExtent = { mip.Width, mip.Height, 1 };
+			regions[i].imageOffset = { 0, 0, 0 };
+			regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			regions[i].imageSubresource.baseArrayLayer = 0;
+			regions[i].imageSubresource.mipLevel = static_cast<uint32_t>(i);
+			regions[i].imageSubresource.layerCount = 1;
+		}
+
+		bool success = Impl::PopulateImage(Impl::State::Data, tex, &staging, regions.data(), static_cast<uint32_t>(regions.size()));
 
 		vmaDestroyBuffer(Impl::State::Data->MemAllocator, staging.BufferHandle, staging.MemoryHandle);
 
-		if (success) success = Impl::CreateImageView(Impl::State::Data, tex, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
+		if (success) success = Impl::CreateImageView(Impl::State::Data, tex, format, VK_IMAGE_ASPECT_COLOR_BIT, GetTextureSwizzle(info.Format));
 		if (success) success = Impl::CreateImageSampler(Impl::State::Data, tex);
 
 		if (!success)
@@ -85,23 +374,298 @@ namespace VKP
 			if (tex->SamplerHandle != VK_NULL_HANDLE)
 				vkDestroySampler(Impl::State::Data->Device, tex->SamplerHandle, nullptr);
 
+			if (firstMip != 0) Assets::UnmapBinary(file);
+
 			delete tex;
 			return nullptr;
 		}
 
+		if (firstMip != 0)
+		{
+			TextureStream* stream = new TextureStream();
+			stream->File = file;
+			stream->Info = info;
+			stream->Mips = std::move(mips);
+			stream->Format = format;
+			stream->Swizzle = GetTextureSwizzle(info.Format);
+			stream->TailMip = firstMip;
+			stream->WantedMip = firstMip;
+
+			tex->Stream = stream;
+			s_StreamingTextures.push_back(tex);
+			m_StreamingUsage += uploadSize;
+		}
+
 		s_ResourceMap[name] = tex;
 		tex->Path = std::move(name);
+		tex->ContentHash = info.ContentHash;
+
+		if (info.ContentHash != 0)
+			s_ContentMap[info.ContentHash] = tex;
 
 		return tex;
 	}
 
 	void TextureCache::Destroy(Texture* texture)
 	{
+		if (texture->Stream != nullptr)
+		{
+			TextureStream* stream = texture->Stream;
+			m_StreamingUsage -= GetResidentSize(stream, texture->FirstMip);
+
+			if (stream->Load != StreamLoad::Idle)
+				m_StreamingUsage -= stream->Mips[texture->FirstMip - 1].Size;
+
+			ReleaseStream(texture);
+			s_StreamingTextures.erase(std::find(s_StreamingTextures.begin(), s_StreamingTextures.end(), texture));
+		}
+
 		Impl::State::Data->Frames[Impl::State::Data->CurrentFrame].DeletionQueue.Push([=]() {
 			Impl::DestroyTexture(Impl::State::Data, texture);
 		});
 
-		s_ResourceMap.erase(texture->Path);
+		// Drop every path sharing this texture, not just the one it was first loaded from
+		for (auto it = s_ResourceMap.begin(); it != s_ResourceMap.end();)
+		{
+			if (it->second == texture)
+				it = s_ResourceMap.erase(it);
+
+			else
+				it++;
+		}
+
+		if (texture->ContentHash != 0)
+			s_ContentMap.erase(texture->ContentHash);
+	}
+
+	void TextureCache::Request(Texture* texture, float screenSize)
+	{
+		if (texture->Stream == nullptr || screenSize <= 0.0f) return;
+
+		texture->Stream->RequestedSize = std::max(texture->Stream->RequestedSize, screenSize);
+		texture->Stream->LastRequested = m_UpdateCount;
+	}
+
+	void TextureCache::Update()
+	{
+		Impl::State* s = Impl::State::Data;
+
+		std::vector<Texture*> loads, evictions;
+		uint32_t pending = 0;
+
+		for (Texture* tex : s_StreamingTextures)
+		{
+			TextureStream* stream = tex->Stream;
+			const StreamLoad load = stream->Load;
+
+			if (load == StreamLoad::Done || load == StreamLoad::Failed)
+			{
+				// The worker wrote the level through a mapping that may not be host coherent
+				if (load == StreamLoad::Done)
+					vmaFlushAllocation(s->MemAllocator, stream->Staging.MemoryHandle, 0, VK_WHOLE_SIZE);
+
+				if (load == StreamLoad::Failed || !Resize(tex, tex->FirstMip - 1, &stream->Staging))
+				{
+					VKP_ERROR("Unable to stream mip level {} of texture ({})", tex->FirstMip - 1, tex->Path);
+
+					m_StreamingUsage -= stream->Mips[tex->FirstMip - 1].Size;
+					stream->FinestMip = tex->FirstMip;
+				}
+
+				// The staging buffer goes once this frame's copy out of it has executed
+				const Buffer staging = stream->Staging;
+
+				s->Frames[s->CurrentFrame].DeletionQueue.Push([=]() {
+					vmaDestroyBuffer(s->MemAllocator, staging.BufferHandle, staging.MemoryHandle);
+				});
+
+				stream->Staging = {};
+				stream->StagingData = nullptr;
+				stream->Load = StreamLoad::Idle;
+			}
+
+			const uint32_t selected = SelectTextureMip(stream->Mips[0].Width, stream->Mips[0].Height, static_cast<uint32_t>(stream->Mips.size()), stream->RequestedSize);
+
+			stream->WantedMip = std::clamp(selected, stream->FinestMip, stream->TailMip);
+			stream->RequestedSize = 0.0f;
+
+			if (stream->Load == StreamLoad::Pending)
+				pending++;
+
+			else if (stream->WantedMip < tex->FirstMip)
+				loads.push_back(tex);
+
+			else if (stream->WantedMip > tex->FirstMip)
+				evictions.push_back(tex);
+		}
+
+		m_UpdateCount++;
+
+		// Textures furthest from the level they want load first, the longest unrequested give up levels first
+		std::sort(loads.begin(), loads.end(), [](const Texture* a, const Texture* b) { return a->FirstMip - a->Stream->WantedMip > b->FirstMip - b->Stream->WantedMip; });
+		std::sort(evictions.begin(), evictions.end(), [](const Texture* a, const Texture* b) { return a->Stream->LastRequested < b->Stream->LastRequested; });
+
+		size_t evicted = 0;
+
+		const auto evict = [&]()
+		{
+			Texture* tex = evictions[evicted++];
+			const uint64_t size = GetResidentSize(tex->Stream, tex->FirstMip);
+
+			if (Resize(tex, tex->Stream->WantedMip, nullptr))
+				m_StreamingUsage -= size - GetResidentSize(tex->Stream, tex->FirstMip);
+		};
+
+		// One level per texture at a time, so textures sharpen progressively and the budget fills evenly
+		for (Texture* tex : loads)
+		{
+			if (pending >= MaxStreamingLoads) break;
+
+			const uint64_t size = tex->Stream->Mips[tex->FirstMip - 1].Size;
+
+			while (m_StreamingUsage + size > m_StreamingBudget && evicted < evictions.size())
+				evict();
+
+			if (m_StreamingUsage + size > m_StreamingBudget) break;
+
+			if (StartLoad(tex)) pending++;
+		}
+
+		// Also holds the budget when nothing loads, e.g. after it was lowered
+		while (m_StreamingUsage > m_StreamingBudget && evicted < evictions.size())
+			evict();
+	}
+
+	bool TextureCache::StartLoad(Texture* texture)
+	{
+		TextureStream* stream = texture->Stream;
+		const Assets::TextureMip mip = stream->Mips[texture->FirstMip - 1];
+
+		if (!Impl::CreateStagingBuffer(Impl::State::Data, &stream->Staging, mip.Size, (void**)&stream->StagingData))
+		{
+			VKP_ERROR("Unable to create staging buffer for texture streaming ({})", texture->Path);
+			return false;
+		}
+
+		m_StreamingUsage += mip.Size;
+		stream->Load = StreamLoad::Pending;
+
+		Assets::TaskPool::Get().Submit([stream, mip]()
+		{
+			const bool success = Assets::UnpackTextureRange(&stream->Info, stream->File.Binary.Data, stream->File.Binary.Size, mip.Offset, mip.Size, stream->StagingData);
+			stream->Load = success ? StreamLoad::Done : StreamLoad::Failed;
+		});
+
+		return true;
+	}
+
+	// Moves a streaming texture into a new image holding levels firstMip and coarser. Levels both
+	// images share are copied on the GPU and finer ones come from staging, which holds them back to
+	// back. The copies go into the current frame's commands and the old image and view are freed
+	// once that frame has executed.
+	bool TextureCache::Resize(Texture* texture, uint32_t firstMip, Buffer* staging)
+	{
+		Impl::State* s = Impl::State::Data;
+		TextureStream* stream = texture->Stream;
+		const Assets::TextureMip& base = stream->Mips[firstMip];
+
+		Texture resized = {};
+		resized.MipLevels = static_cast<uint32_t>(stream->Mips.size()) - firstMip;
+
+		if (!Impl::CreateImage(s, &resized, base.Width, base.Height, stream->Format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT))
+			return false;
+
+		if (!Impl::CreateImageView(s, &resized, stream->Format, VK_IMAGE_ASPECT_COLOR_BIT, stream->Swizzle))
+		{
+			vmaDestroyImage(s->MemAllocator, resized.ImageHandle, resized.MemoryHandle);
+			return false;
+		}
+
+		VkImageMemoryBarrier barriers[2] = {};
+
+		for (auto& barrier : barriers)
+		{
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+			barrier.subresourceRange.baseMipLevel = 0;
+		}
+
+		barriers[0].image = resized.ImageHandle;
+		barriers[0].srcAccessMask = 0;
+		barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barriers[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barriers[0].subresourceRange.levelCount = resized.MipLevels;
+
+		barriers[1].image = texture->ImageHandle;
+		barriers[1].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barriers[1].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barriers[1].subresourceRange.levelCount = texture->MipLevels;
+
+		vkCmdPipelineBarrier(s->CurrentCmdBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 2, barriers);
+
+		std::vector<VkImageCopy> copies;
+
+		for (uint32_t level = std::max(firstMip, texture->FirstMip); level < stream->Mips.size(); level++)
+		{
+			VkImageCopy& copy = copies.emplace_back();
+			copy.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - texture->FirstMip, 0, 1 };
+			copy.srcOffset = { 0, 0, 0 };
+			copy.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - firstMip, 0, 1 };
+			copy.dstOffset = { 0, 0, 0 };
+			copy.extent = { stream->Mips[level].Width, stream->Mips[level].Height, 1 };
+		}
+
+		vkCmdCopyImage(s->CurrentCmdBuffer, texture->ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, resized.ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copies.size()), copies.data());
+
+		if (staging != nullptr)
+		{
+			std::vector<VkBufferImageCopy> regions;
+
+			for (uint32_t level = firstMip; level < texture->FirstMip; level++)
+			{
+				VkBufferImageCopy& region = regions.emplace_back();
+				region.bufferOffset = stream->Mips[level].Offset - base.Offset;
+				region.bufferRowLength = 0;
+				region.bufferImageHeight = 0;
+				region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - firstMip, 0, 1 };
+				region.imageOffset = { 0, 0, 0 };
+				region.imageExtent = { stream->Mips[level].Width, stream->Mips[level].Height, 1 };
+			}
+
+			vkCmdCopyBufferToImage(s->CurrentCmdBuffer, staging->BufferHandle, resized.ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+		}
+
+		barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		vkCmdPipelineBarrier(s->CurrentCmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barriers[0]);
+
+		const VkImage image = texture->ImageHandle;
+		const VkImageView view = texture->ViewHandle;
+		const VmaAllocation memory = texture->MemoryHandle;
+
+		s->Frames[s->CurrentFrame].DeletionQueue.Push([=]() {
+			vkDestroyImageView(s->Device, view, nullptr);
+			vmaDestroyImage(s->MemAllocator, image, memory);
+		});
+
+		texture->ImageHandle = resized.ImageHandle;
+		texture->ViewHandle = resized.ViewHandle;
+		texture->MemoryHandle = resized.MemoryHandle;
+		texture->MipLevels = resized.MipLevels;
+		texture->FirstMip = firstMip;
+		texture->Version++;
+
+		return true;
 	}
 
 	TextureCache* TextureCache::Create()
@@ -124,8 +688,6 @@ namespace VKP::Impl
 
 	bool CreateImage(State* s, Texture* texture, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkSampleCountFlagBits samples)
 	{
-		texture->MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
-
 		if (usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT || usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
 			texture->MipLevels = 1;
 
@@ -141,9 +703,6 @@ namespace VKP::Impl
 		imgInfo.tiling = tiling;
 		imgInfo.usage = usage;
 
-		if (texture->MipLevels == 1)
-			imgInfo.usage &= ~VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-
 		GetTransferQueueData(s, &imgInfo.sharingMode, &imgInfo.queueFamilyIndexCount, &imgInfo.pQueueFamilyIndices);
 
 		VmaAllocationCreateInfo memInfo = {};
@@ -156,21 +715,10 @@ namespace VKP::Impl
 		return VK_SUCCESS == result;
 	}
 
-	bool PopulateImage(State* s, Texture* texture, Buffer* staging, uint32_t width, uint32_t height)
+	bool PopulateImage(State* s, Texture* texture, Buffer* staging, const VkBufferImageCopy* regions, uint32_t regionCount)
 	{
 		const std::function<void(VkCommandBuffer)> fn = [&](VkCommandBuffer cmdBuffer)
 		{
-			VkBufferImageCopy region = {};
-			region.bufferImageHeight = 0;
-			region.bufferOffset = 0;
-			region.bufferRowLength = 0;
-			region.imageExtent = { width, height, 1 };
-			region.imageOffset = { 0, 0, 0 };
-			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			region.imageSubresource.baseArrayLayer = 0;
-			region.imageSubresource.mipLevel = 0;
-			region.imageSubresource.layerCount = 1;
-
 			VkImageMemoryBarrier barrier = {};
 			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 			barrier.image = texture->ImageHandle;
@@ -187,64 +735,12 @@ namespace VKP::Impl
 			barrier.subresourceRange.layerCount = 1;
 
 			vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-			vkCmdCopyBufferToImage(cmdBuffer, staging->BufferHandle, texture->ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-			if (texture->MipLevels == 1)
-			{
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-				vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-				return;
-			}
-
-			int32_t mipW = width, mipH = height;
-
-			for (size_t i = 1; i < texture->MipLevels; i++)
-			{
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-				barrier.subresourceRange.baseMipLevel = i - 1;
-				barrier.subresourceRange.levelCount = 1; // One level at a time
-
-				vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-				VkImageBlit blit;
-				blit.srcOffsets[0] = { 0, 0, 0 };
-				blit.srcOffsets[1] = { mipW, mipH, 1 };
-				blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				blit.srcSubresource.baseArrayLayer = 0;
-				blit.srcSubresource.layerCount = 1;
-				blit.srcSubresource.mipLevel = i - 1;
-				blit.dstOffsets[0] = { 0, 0, 0 };
-				blit.dstOffsets[1] = { mipW > 1 ? mipW / 2 : 1, mipH > 1 ? mipH / 2 : 1, 1 };
-				blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				blit.dstSubresource.baseArrayLayer = 0;
-				blit.dstSubresource.layerCount = 1;
-				blit.dstSubresource.mipLevel = i;
-
-				vkCmdBlitImage(cmdBuffer, texture->ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, texture->ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
-
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-				vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-				if (mipW > 1) mipW /= 2;
-				if (mipH > 1) mipH /= 2;
-			}
+			vkCmdCopyBufferToImage(cmdBuffer, staging->BufferHandle, texture->ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, regions);
 
 			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			barrier.subresourceRange.baseMipLevel = texture->MipLevels - 1;
 
 			vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 		};
@@ -252,17 +748,14 @@ namespace VKP::Impl
 		return SubmitTransfer(s, fn);
 	}
 
-	bool CreateImageView(State* s, Texture* texture, VkFormat format, VkImageAspectFlags aspectFlags)
+	bool CreateImageView(State* s, Texture* texture, VkFormat format, VkImageAspectFlags aspectFlags, VkComponentMapping components)
 	{
 		VkImageViewCreateInfo viewInfo = {};
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		viewInfo.image = texture->ImageHandle;
 		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
 		viewInfo.format = format;
-		viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-		viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-		viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-		viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		viewInfo.components = components;
 		viewInfo.subresourceRange.aspectMask = aspectFlags;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
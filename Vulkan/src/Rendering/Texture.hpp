@@ -7,6 +7,7 @@ namespace VKP
 {
 
 	struct Buffer;
+	struct TextureStream;
 
 	struct Texture
 	{
@@ -16,27 +17,63 @@ namespace VKP
 		VkSampler SamplerHandle = VK_NULL_HANDLE;
 		VmaAllocation MemoryHandle = VK_NULL_HANDLE;
 		uint32_t MipLevels = 1;
+		uint64_t ContentHash = 0;
+
+		// Streaming textures only hold the levels from FirstMip of the asset's chain down. Every
+		// change of that replaces the image and view and bumps Version, so descriptor sets can follow.
+		TextureStream* Stream = nullptr;
+		uint32_t FirstMip = 0;
+		uint32_t Version = 0;
 	};
 
+	// Finest level of a width x height chain worth keeping for a texture mapped once across a
+	// surface that spans screenSize pixels: the smallest one still holding a texel per pixel
+	uint32_t SelectTextureMip(uint32_t width, uint32_t height, uint32_t mipLevels, float screenSize);
+
 	class TextureCache final
 	{
 	public:
 		TextureCache(TextureCache&) = delete;
 		~TextureCache();
 
-		Texture* Create(const std::string& name);
+		// A streaming texture starts with only the levels of at most StreamingTailSize texels
+		// resident and loads finer ones in the background once they are requested
+		Texture* Create(const std::string& name, bool streaming = false);
 		void Destroy(Texture* texture);
 
+		// Asks a streaming texture for the level a surface spanning screenSize pixels needs; the
+		// finest request between two updates wins
+		void Request(Texture* texture, float screenSize);
+
+		// Adds levels whose background loads finished, starts loads for requested ones and,
+		// while streamed levels exceed the budget, drops levels nothing asked for, least recently
+		// requested first. Records into the current command buffer, so it runs outside render passes.
+		void Update();
+
+		inline void SetStreamingBudget(uint64_t bytes) { m_StreamingBudget = bytes; }
+		inline uint64_t GetStreamingUsage() const { return m_StreamingUsage; }
+
 		TextureCache& operator=(TextureCache&) = delete;
 
+		static constexpr uint32_t StreamingTailSize = 64;
+
 		static TextureCache* Create();
 		static TextureCache& Get();
 
 	private:
+		uint64_t m_StreamingBudget = 256ull << 20;
+		uint64_t m_StreamingUsage = 0;
+		uint64_t m_UpdateCount = 0;
+
 		static TextureCache* s_Instance;
 		static std::unordered_map<std::string, Texture*> s_ResourceMap;
+		static std::unordered_map<uint64_t, Texture*> s_ContentMap;
+		static std::vector<Texture*> s_StreamingTextures;
 
 		TextureCache() = default;
+
+		bool StartLoad(Texture* texture);
+		bool Resize(Texture* texture, uint32_t firstMip, Buffer* staging);
 	};
 
 }
@@ -46,9 +83,10 @@ namespace VKP::Impl
 
 	struct State;
 
+	// The image gets texture->MipLevels levels, or one for attachments
 	bool CreateImage(State* s, Texture* texture, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
-	bool PopulateImage(State* s, Texture* texture, Buffer* staging, uint32_t width, uint32_t height);
-	bool CreateImageView(State* s, Texture* texture, VkFormat format, VkImageAspectFlags aspectFlags);
+	bool PopulateImage(State* s, Texture* texture, Buffer* staging, const VkBufferImageCopy* regions, uint32_t regionCount);
+	bool CreateImageView(State* s, Texture* texture, VkFormat format, VkImageAspectFlags aspectFlags, VkComponentMapping components = {});
 	bool CreateImageSampler(State* s, Texture* texture);
 	void DestroyTexture(State* s, Texture* texture);
 
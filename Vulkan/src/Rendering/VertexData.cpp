@@ -5,39 +5,65 @@
 namespace VKP
 {
 
-	void Vertex::PopulateBindingDescription(std::vector<VkVertexInputBindingDescription>& bindings, std::vector<VkVertexInputAttributeDescription>& attributes)
+	struct StreamAttribute
 	{
-		bindings.reserve(1);
-		attributes.reserve(3);
-
-		auto& bind = bindings.emplace_back();
-		bind.binding = 0;
-		bind.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-		bind.stride = sizeof(Vertex);
-
-		auto& posAttr = attributes.emplace_back();
-		posAttr.format = VK_FORMAT_R32G32B32_SFLOAT;
-		posAttr.binding = 0;
-		posAttr.location = 0;
-		posAttr.offset = offsetof(Vertex, Position);
-
-		auto& colAttr = attributes.emplace_back();
-		colAttr.format = VK_FORMAT_R32G32B32_SFLOAT;
-		colAttr.binding = 0;
-		colAttr.location = 1;
-		colAttr.offset = offsetof(Vertex, Color);
-
-		auto& norAttr = attributes.emplace_back();
-		norAttr.format = VK_FORMAT_R32G32B32_SFLOAT;
-		norAttr.binding = 0;
-		norAttr.location = 2;
-		norAttr.offset = offsetof(Vertex, Normal);
-
-		auto& texAttr = attributes.emplace_back();
-		texAttr.format = VK_FORMAT_R32G32_SFLOAT;
-		texAttr.binding = 0;
-		texAttr.location = 3;
-		texAttr.offset = offsetof(Vertex, TexCoord);
+		VertexAttributeFlags Flag;
+		uint32_t Location;
+		VkFormat Format[2];
+		uint32_t Size[2];
+	};
+
+	// Float and packed encoding of each attribute, in flag order
+	static const StreamAttribute s_StreamAttributes[] = {
+		{ VertexAttributePosition, 0, { VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R16G16B16A16_UNORM }, { 12, 8 } },
+		{ VertexAttributeColor, 1, { VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R8G8B8A8_UNORM }, { 12, 4 } },
+		{ VertexAttributeNormal, 2, { VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R16G16_SNORM }, { 12, 4 } },
+		{ VertexAttributeUV, 3, { VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R16G16_SFLOAT }, { 8, 4 } },
+	};
+
+	void PopulateStreamDescription(VertexLayout layout, uint32_t attributes, std::vector<VkVertexInputBindingDescription>& bindings, std::vector<VkVertexInputAttributeDescription>& descriptions)
+	{
+		const uint32_t encoding = layout == VertexLayout::Packed ? 1 : 0;
+		uint32_t strides[2] = { 0, 0 };
+
+		for (const auto& a : s_StreamAttributes)
+		{
+			if ((attributes & a.Flag) == 0) continue;
+
+			const uint32_t stream = a.Flag == VertexAttributePosition ? 0 : 1;
+
+			auto& attr = descriptions.emplace_back();
+			attr.format = a.Format[encoding];
+			attr.binding = stream;
+			attr.location = a.Location;
+			attr.offset = strides[stream];
+
+			strides[stream] += a.Size[encoding];
+		}
+
+		for (uint32_t stream = 0; stream < 2; stream++)
+		{
+			if (strides[stream] == 0) continue;
+
+			auto& bind = bindings.emplace_back();
+			bind.binding = stream;
+			bind.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+			bind.stride = strides[stream];
+		}
+	}
+
+	uint32_t GetStreamStride(VertexLayout layout, uint32_t attributes)
+	{
+		const uint32_t encoding = layout == VertexLayout::Packed ? 1 : 0;
+		uint32_t stride = 0;
+
+		for (const auto& a : s_StreamAttributes)
+		{
+			if (attributes & a.Flag)
+				stride += a.Size[encoding];
+		}
+
+		return stride;
 	}
 
 	bool Vertex::operator==(const Vertex& v) const
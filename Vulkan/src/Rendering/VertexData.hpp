@@ -8,6 +8,28 @@
 namespace VKP
 {
 
+	enum class VertexLayout
+	{
+		Float = 0,
+		Packed,
+	};
+
+	// Matches Assets::VertexAttributeFlags. Positions are bound to stream 0 and the other
+	// attributes, interleaved in flag order, to stream 1.
+	enum VertexAttributeFlags : uint32_t
+	{
+		VertexAttributePosition = 1 << 0,
+		VertexAttributeColor = 1 << 1,
+		VertexAttributeNormal = 1 << 2,
+		VertexAttributeUV = 1 << 3,
+	};
+
+	// What the base shaders read; meshes storing anything else are converted on load
+	constexpr uint32_t MeshVertexAttributes = VertexAttributePosition | VertexAttributeNormal | VertexAttributeUV;
+
+	void PopulateStreamDescription(VertexLayout layout, uint32_t attributes, std::vector<VkVertexInputBindingDescription>& bindings, std::vector<VkVertexInputAttributeDescription>& descriptions);
+	uint32_t GetStreamStride(VertexLayout layout, uint32_t attributes);
+
 	struct Vertex
 	{
 		glm::vec3 Position;
@@ -19,8 +41,16 @@ namespace VKP
 		~Vertex() = default;
 
 		bool operator==(const Vertex& v) const;
+	};
 
-		static void PopulateBindingDescription(std::vector<VkVertexInputBindingDescription>& bindings, std::vector<VkVertexInputAttributeDescription>& attributes);
+	// Matches Assets::VertexPackedPosColNorUV. Position is unorm16 within the mesh bounds and
+	// the normal is octahedron-encoded, both decoded in base_packed.vert.
+	struct PackedVertex
+	{
+		uint16_t Position[4];
+		uint8_t Color[4];
+		int16_t Normal[2];
+		uint16_t TexCoord[2];
 	};
 
 }
@@ -15,8 +15,8 @@ namespace VKP
 
 	bool Scene::LoadFromPrefab(const char* path)
 	{
-		Assets::Asset file = {};
-		bool success = Assets::LoadBinary(path, file);
+		Assets::AssetView file = {};
+		bool success = Assets::MapBinary(path, file);
 
 		if (!success)
 		{
@@ -25,6 +25,7 @@ namespace VKP
 		}
 
 		const auto info = Assets::ParsePrefabAssetInfo(&file);
+		Assets::UnmapBinary(file);
 		m_Renderables.reserve(info.NodeMeshes.size());
 
 		std::unordered_map<uint64_t, glm::mat4> worldMatrices;
@@ -69,18 +70,33 @@ namespace VKP
 			auto& r = m_Renderables.emplace_back();
 			r.Model = MeshCache::Get().Create(m.MeshPath);
 
-			Assets::Asset matFile = {};
+			Assets::AssetView matFile = {};
 
-			if (!Assets::LoadBinary(m.MaterialPath.c_str(), matFile))
+			if (!Assets::MapBinary(m.MaterialPath.c_str(), matFile))
 			{
 				VKP_ERROR("Unable to locate material file ({})", m.MaterialPath);
 				return false;
 			}
 
 			const auto matInfo = Assets::ParseMaterialAssetInfo(&matFile);
-			std::vector<Texture*> textures = { TextureCache::Get().Create(matInfo.Textures.at("diffuse")) };
+			Assets::UnmapBinary(matFile);
+			std::vector<Texture*> textures = { TextureCache::Get().Create(matInfo.Textures.at("diffuse"), true) };
 
-			r.Mat = MaterialCache::Get().Create(m.MaterialPath, std::move(textures));
+			// Textures packed into an atlas page only cover part of it
+			glm::vec4 uvTransform = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+			auto region = matInfo.Regions.find("diffuse");
+
+			if (region != matInfo.Regions.end())
+				uvTransform = glm::vec4(region->second.Scale[0], region->second.Scale[1], region->second.Offset[0], region->second.Offset[1]);
+
+			r.Mat = MaterialCache::Get().Create(m.MaterialPath, std::move(textures), uvTransform);
+
+			// The caches already reported why, the rest of the scene still loads
+			if (r.Model == nullptr || r.Mat == nullptr)
+			{
+				m_Renderables.pop_back();
+				continue;
+			}
 
 			if (worldMatrices.find(k) != worldMatrices.end())
 				r.Matrix = worldMatrices.at(k);